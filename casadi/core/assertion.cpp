@@ -24,6 +24,7 @@
 
 
 #include "assertion.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -112,4 +113,8 @@ namespace casadi {
     }
   }
 
+  void Assertion::serialize_body(SerializingStream& s) const {
+    s.pack(fail_message_);
+  }
+
 } // namespace casadi
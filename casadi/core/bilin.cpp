@@ -24,6 +24,7 @@
 
 
 #include "bilin.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 namespace casadi {
@@ -123,9 +124,12 @@ namespace casadi {
   void Bilin::generate(CodeGenerator& g,
                        const std::vector<int>& arg, const std::vector<int>& res) const {
     g << g.workel(res[0]) << " = "
-      << g.bilin(g.work(arg[0], dep(0).nnz()), sparsity(),
+      << g.bilin(g.work(arg[0], dep(0).nnz()), dep(0).sparsity(),
                  g.work(arg[1], dep(1).nnz()),
                  g.work(arg[2], dep(2).nnz())) << ";\n";
   }
 
+  void Bilin::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
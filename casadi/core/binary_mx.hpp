@@ -50,6 +50,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return op_;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /** \brief Check if binary operation */
     bool is_binary() const override { return true;}
 
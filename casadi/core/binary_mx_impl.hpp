@@ -31,6 +31,7 @@
 #include <sstream>
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -261,6 +262,11 @@ namespace casadi {
     return MXNode::_get_binary(op, y, scX, scY);
   }
 
+  template<bool ScX, bool ScY>
+  void BinaryMX<ScX, ScY>::serialize_body(SerializingStream& s) const {
+    s.pack(ScX);
+    s.pack(ScY);
+  }
 
 } // namespace casadi
 
@@ -38,7 +38,9 @@ namespace casadi {
        {OT_STRINGVECTOR,
         "Sets, for each grid dimenion, the lookup algorithm used to find the correct index. "
         "'linear' uses a for-loop + break; "
-        "'exact' uses floored division (only for uniform grids)."}},
+        "'exact' uses floored division (only for uniform grids); "
+        "'binary' uses a binary search; "
+        "'hint' searches outwards from the interval found in the previous call."}},
      }
   };
 
@@ -68,9 +70,13 @@ namespace casadi {
               knots_.begin()+offset_[i]+degree_[i],
               knots_.begin()+offset_[i+1]-degree_[i]);
           casadi_assert_dev(is_increasing(grid) && is_equally_spaced(grid));
+        } else if (lookup_mode[i]=="binary") {
+          lookup_mode_[i] = 2;
+        } else if (lookup_mode[i]=="hint") {
+          lookup_mode_[i] = 3;
         } else {
           casadi_error("Unknown lookup_mode option '" + lookup_mode[i] + ". "
-                       "Allowed values: linear, exact.");
+                       "Allowed values: linear, exact, binary, hint.");
         }
       }
     }
@@ -149,13 +155,25 @@ namespace casadi {
         "got " + str(coeffs_.size()) + " instead.");
     }
 
+    int BSpline::init_mem(void* mem) const {
+      auto m = static_cast<BSplineMemory*>(mem);
+      m->hint.assign(degree_.size(), 0);
+      return 0;
+    }
+
     int BSpline::eval(const double** arg, double** res, int* iw, double* w, void* mem) const {
       if (!res[0]) return 0;
+      auto m = static_cast<BSplineMemory*>(mem);
+      int n_dims = degree_.size();
 
+      // The intervals are returned in iw, doubling as the hints for the lookup
+      int* starts = iw + n_dims + 1;
+      casadi_copy_int(get_ptr(m->hint), n_dims, starts);
       casadi_fill(res[0], m_, 0.0);
-      casadi_nd_boor_eval(res[0], degree_.size(), get_ptr(knots_), get_ptr(offset_),
+      casadi_nd_boor_eval(res[0], n_dims, get_ptr(knots_), get_ptr(offset_),
         get_ptr(degree_), get_ptr(strides_), get_ptr(coeffs_), m_, arg[0], get_ptr(lookup_mode_),
         false, iw, w);
+      casadi_copy_int(starts, n_dims, get_ptr(m->hint));
       return 0;
     }
 
@@ -166,6 +184,11 @@ namespace casadi {
       g.add_auxiliary(CodeGenerator::AUX_FILL);
       g << "  if (res[0]) " << g.fill("res[0]", m_, "0.0") << "\n";
 
+      // Starting point for lookup_mode 'hint'
+      if (std::count(lookup_mode_.begin(), lookup_mode_.end(), 3)) {
+        g << "  casadi_fill_int(iw+" << (n_dims+1) << ", " << n_dims << ", 0);\n";
+      }
+
       // Input and output buffers
       g << "  if (res[0]) CASADI_PREFIX(nd_boor_eval)(res[0]," << n_dims << ","
         << g.constant(knots_) << "," << g.constant(offset_) << "," <<  g.constant(degree_)
@@ -329,6 +352,11 @@ namespace casadi {
       g << "  if (res[0]) " <<
                 g.fill("res[0]", reverse_? coeffs_size_: m_*N_, "0.0") << "\n";
 
+      // Starting point for lookup_mode 'hint'
+      if (std::count(lookup_mode_.begin(), lookup_mode_.end(), 3)) {
+        g << "  casadi_fill_int(iw+" << (n_dims+1) << ", " << n_dims << ", 0);\n";
+      }
+
       // Input and output buffers
       g << "  if (res[0]) for (int i=0;i<" << N_ << ";++i) CASADI_PREFIX(nd_boor_eval)(res[0]"
         << (reverse_? "" : "+i*" + str(m_)) << "," << n_dims << "," << g.constant(knots_)
@@ -394,7 +422,7 @@ namespace casadi {
         int n_b = n_knots-degree-1;
 
         double x = all_x[k];
-        int L = casadi_low(x, knots+degree, n_knots-2*degree, lookup_mode[k]);
+        int L = casadi_low(x, knots+degree, n_knots-2*degree, lookup_mode[k], starts[k]);
 
         int start = L;
         if (start>n_b-degree-1) start = n_b-degree-1;
@@ -35,6 +35,12 @@ namespace casadi {
   *
   *
   */
+  /** \brief Memory for BSpline */
+  struct CASADI_EXPORT BSplineMemory {
+    /// Intervals found in the previous call, starting point for lookup_mode 'hint'
+    std::vector<int> hint;
+  };
+
   class BSplineCommon : public FunctionInternal {
   public:
     BSplineCommon(const std::string &name, const std::vector<double>& knots,
@@ -81,7 +87,7 @@ namespace casadi {
       const std::vector<int>& degree, int m);
 
     /** \brief  Destructor */
-    ~BSpline() override {}
+    ~BSpline() override { clear_mem();}
 
     /// @{
     /** \brief Sparsities of function inputs and outputs */
@@ -92,6 +98,15 @@ namespace casadi {
     /** \brief  Initialize */
     void init(const Dict& opts) override;
 
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new BSplineMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<BSplineMemory*>(mem);}
+
     /** \brief  Evaluate numerically, work vectors given */
     int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
 
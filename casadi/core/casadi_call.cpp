@@ -26,6 +26,7 @@
 #include "casadi_call.hpp"
 #include "function_internal.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -84,7 +85,9 @@ namespace casadi {
   }
 
   int Call::eval(const double** arg, double** res, int* iw, double* w) const {
-    return fcn_(arg, res, iw, w);
+    // The called function may be shared between several callers
+    scoped_checkout<FunctionInternal> mem(fcn_.get());
+    return fcn_(arg, res, iw, w, mem);
   }
 
   int Call::nout() const {
@@ -207,4 +210,14 @@ namespace casadi {
     return MX::createMultipleOutput(new Call(fcn, arg));
   }
 
+  void Call::serialize_body(SerializingStream& s) const {
+    s.pack(fcn_);
+  }
+
+  MX Call::deserialize(DeserializingStream& s, const std::vector<MX>& dep) {
+    Function fcn;
+    s.unpack(fcn);
+    return MX::create(new Call(fcn, dep));
+  }
+
 } // namespace casadi
@@ -93,6 +93,11 @@ namespace casadi {
     /** \brief  Get called function */
     const Function& which_function() const override { return fcn_;}
 
+    /** \brief Check if two nodes are equivalent up to a given depth */
+    bool is_equal(const MXNode* node, int depth) const override {
+      return sameOpAndDeps(node, depth) && node->which_function().get()==fcn_.get();
+    }
+
     /** \brief  Get function output */
     int which_output() const override { return -1;}
 
@@ -105,6 +110,12 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_CALL;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize a call node, dependencies already read */
+    static MX deserialize(DeserializingStream& s, const std::vector<MX>& dep);
+
     /** \brief Get required length of arg field */
     size_t sz_arg() const override;
 
@@ -43,6 +43,8 @@ namespace casadi {
     this->with_header = false;
     this->with_mem = false;
     this->with_export = true;
+    this->chunk_size = 0;
+    this->chunk_files = false;
     indent_ = 2;
 
     // Read options
@@ -65,6 +67,11 @@ namespace casadi {
         this->with_mem = e.second;
       } else if (e.first=="with_export") {
         this->with_export = e.second;
+      } else if (e.first=="chunk_size") {
+        this->chunk_size = e.second;
+        casadi_assert(this->chunk_size>=0, "'chunk_size' must be nonnegative");
+      } else if (e.first=="chunk_files") {
+        this->chunk_files = e.second;
       } else if (e.first=="indent") {
         indent_ = e.second;
         casadi_assert_dev(indent_>=0);
@@ -242,6 +249,16 @@ namespace casadi {
     // Finalize file
     file_close(s);
 
+    // Chunks of split up functions, one file each
+    if (this->chunk_files) {
+      vector<string> files = source_files(prefix);
+      for (int k=0; k<chunks_.size(); ++k) {
+        file_open(s, files.at(k+1));
+        generate_chunk(s, k);
+        file_close(s);
+      }
+    }
+
     // Generate header
     if (this->with_header) {
       // Create a header file
@@ -259,6 +276,74 @@ namespace casadi {
     return fullname;
   }
 
+  vector<string> CodeGenerator::source_files(const string& prefix) const {
+    vector<string> ret(1, prefix + this->name + this->suffix);
+    if (this->chunk_files) {
+      for (int k=0; k<chunks_.size(); ++k) {
+        ret.push_back(prefix + this->name + "_chunk" + str(k) + this->suffix);
+      }
+    }
+    return ret;
+  }
+
+  string CodeGenerator::add_chunk(const string& body) {
+    string name = shorthand("chunk" + str(chunks_.size()));
+    chunks_.push_back("void " + name + "(const casadi_real** arg, casadi_real** res, "
+                      "casadi_real* w) {\n" + body + "}\n\n");
+    return name;
+  }
+
+  void CodeGenerator::generate_chunk(std::ostream &s, int k) const {
+    generate_prefix(s);
+    s << "#include <math.h>\n\n";
+    generate_casadi_real(s);
+    generate_math(s, true);
+    s << "#define casadi_chunk" << k << " CASADI_PREFIX(chunk" << k << ")\n\n"
+      << chunks_.at(k);
+  }
+
+  void CodeGenerator::generate_prefix(std::ostream &s) const {
+    s << "/* How to prefix internal symbols */\n"
+      << "#ifdef CODEGEN_PREFIX\n"
+      << "  #define NAMESPACE_CONCAT(NS, ID) _NAMESPACE_CONCAT(NS, ID)\n"
+      << "  #define _NAMESPACE_CONCAT(NS, ID) NS ## ID\n"
+      << "  #define CASADI_PREFIX(ID) NAMESPACE_CONCAT(CODEGEN_PREFIX, ID)\n"
+      << "#else\n"
+      << "  #define CASADI_PREFIX(ID) " << this->name << "_ ## ID\n"
+      << "#endif\n\n";
+  }
+
+  void CodeGenerator::generate_math(std::ostream &s, bool declaration_only) const {
+    // Function bodies, unless only declared
+    string fmin_body = declaration_only ? ";" : " { return x<y ? x : y;}";
+    string fmax_body = declaration_only ? ";" : " { return x>y ? x : y;}";
+    string sq_body = declaration_only ? ";" : " { return x*x;}";
+    string sign_body = declaration_only ? ";" : " { return x<0 ? -1 : x>0 ? 1 : x;}";
+    string twice_body = declaration_only ? ";" : " { return x+x;}";
+    string if_else_body = declaration_only ? ";" : " { return c!=0 ? x : y;}";
+
+    // Pre-C99
+    s << "/* Pre-c99 compatibility */\n"
+      << "#if __STDC_VERSION__ < 199901L\n"
+      << "  #define fmin CASADI_PREFIX(fmin)\n"
+      << "  casadi_real fmin(casadi_real x, casadi_real y)" << fmin_body << "\n"
+      << "  #define fmax CASADI_PREFIX(fmax)\n"
+      << "  casadi_real fmax(casadi_real x, casadi_real y)" << fmax_body << "\n"
+      << "#endif\n\n";
+
+    // CasADi extensions
+    s << "/* CasADi extensions */\n"
+      << "#define sq CASADI_PREFIX(sq)\n"
+      << "casadi_real sq(casadi_real x)" << sq_body << "\n"
+      << "#define sign CASADI_PREFIX(sign)\n"
+      << "casadi_real CASADI_PREFIX(sign)(casadi_real x)" << sign_body << "\n"
+      << "#define twice CASADI_PREFIX(twice)\n"
+      << "casadi_real twice(casadi_real x)" << twice_body << "\n"
+      << "#define if_else CASADI_PREFIX(if_else)\n"
+      << "casadi_real if_else(casadi_real c, casadi_real x, casadi_real y)"
+      << if_else_body << "\n\n";
+  }
+
   void CodeGenerator::generate_mex(std::ostream &s) const {
     // Begin conditional compilation
     s << "#ifdef MATLAB_MEX_FILE\n";
@@ -328,14 +413,7 @@ namespace casadi {
     casadi_assert_dev(current_indent_ == 0);
 
     // Prefix internal symbols to avoid symbol collisions
-    s << "/* How to prefix internal symbols */\n"
-      << "#ifdef CODEGEN_PREFIX\n"
-      << "  #define NAMESPACE_CONCAT(NS, ID) _NAMESPACE_CONCAT(NS, ID)\n"
-      << "  #define _NAMESPACE_CONCAT(NS, ID) NS ## ID\n"
-      << "  #define CASADI_PREFIX(ID) NAMESPACE_CONCAT(CODEGEN_PREFIX, ID)\n"
-      << "#else\n"
-      << "  #define CASADI_PREFIX(ID) " << this->name << "_ ## ID\n"
-      << "#endif\n\n";
+    generate_prefix(s);
 
     s << this->includes.str();
     s << endl;
@@ -351,26 +429,8 @@ namespace casadi {
       << "#define CASADI_CAST(x,y) "
       << (this->cpp ? "static_cast<x>(y)" : "(x) y") << endl << endl;
 
-    // Pre-C99
-    s << "/* Pre-c99 compatibility */\n"
-      << "#if __STDC_VERSION__ < 199901L\n"
-      << "  #define fmin CASADI_PREFIX(fmin)\n"
-      << "  casadi_real fmin(casadi_real x, casadi_real y) { return x<y ? x : y;}\n"
-      << "  #define fmax CASADI_PREFIX(fmax)\n"
-      << "  casadi_real fmax(casadi_real x, casadi_real y) { return x>y ? x : y;}\n"
-      << "#endif\n\n";
-
-      // CasADi extensions
-      s << "/* CasADi extensions */\n"
-        << "#define sq CASADI_PREFIX(sq)\n"
-        << "casadi_real sq(casadi_real x) { return x*x;}\n"
-        << "#define sign CASADI_PREFIX(sign)\n"
-        << "casadi_real CASADI_PREFIX(sign)(casadi_real x) { return x<0 ? -1 : x>0 ? 1 : x;}\n"
-        << "#define twice CASADI_PREFIX(twice)\n"
-        << "casadi_real twice(casadi_real x) { return x+x;}\n"
-        << "#define if_else CASADI_PREFIX(if_else)\n"
-        << "casadi_real if_else(casadi_real c, casadi_real x, casadi_real y) "
-           "{ return c!=0 ? x : y;}\n\n";
+    // Pre-C99 compatibility and CasADi extensions
+    generate_math(s, false);
 
     // Macros
     if (!added_shorthands_.empty()) {
@@ -436,6 +496,21 @@ namespace casadi {
       s << endl << endl;
     }
 
+    // Chunks of split up functions
+    if (!chunks_.empty()) {
+      s << "/* Chunks of split up functions */\n";
+      for (int k=0; k<chunks_.size(); ++k) {
+        if (this->chunk_files) {
+          // Defined in separate files
+          s << "void casadi_chunk" << k << "(const casadi_real** arg, casadi_real** res, "
+            << "casadi_real* w);\n";
+        } else {
+          s << "static " << chunks_[k];
+        }
+      }
+      s << endl;
+    }
+
     // Codegen auxiliary functions
     s << this->auxiliaries.str();
 
@@ -710,6 +785,9 @@ namespace casadi {
     case AUX_MTIMES:
       this->auxiliaries << sanitize_source(casadi_mtimes_str, inst);
       break;
+    case AUX_MTIMES_DENSE:
+      this->auxiliaries << sanitize_source(casadi_mtimes_dense_str, inst);
+      break;
     case AUX_PROJECT:
       this->auxiliaries << sanitize_source(casadi_project_str, inst);
       break;
@@ -743,6 +821,41 @@ namespace casadi {
       add_auxiliary(AUX_FILL);
       this->auxiliaries << sanitize_source(casadi_qr_str, inst);
       break;
+    case AUX_LDL:
+      this->auxiliaries << sanitize_source(casadi_ldl_str, inst);
+      break;
+    case AUX_IPQP:
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_BILIN);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_NORM_INF);
+      add_auxiliary(AUX_LDL);
+      this->auxiliaries << sanitize_source(casadi_ipqp_str, inst);
+      break;
+    case AUX_CAS:
+      add_include("intrin.h", false, "_MSC_VER");
+      this->auxiliaries
+        << "/* Atomic compare-and-swap: if *p equals o, set it to n and return 1 */\n"
+        << "#if defined(__GNUC__)\n"
+        << "typedef volatile long casadi_atomic_long;\n"
+        << "#define casadi_cas(p, o, n) __sync_bool_compare_and_swap(p, o, n)\n"
+        << "#elif defined(_MSC_VER)\n"
+        << "typedef volatile long casadi_atomic_long;\n"
+        << "#define casadi_cas(p, o, n) (_InterlockedCompareExchange(p, n, o)==(o))\n"
+        << "#elif defined(__STDC_VERSION__) && __STDC_VERSION__>=201112L "
+        << "&& !defined(__STDC_NO_ATOMICS__)\n"
+        << "#include <stdatomic.h>\n"
+        << "typedef atomic_long casadi_atomic_long;\n"
+        << "static int casadi_cas(casadi_atomic_long* p, long o, long n) {\n"
+        << "  return atomic_compare_exchange_strong(p, &o, n);\n"
+        << "}\n"
+        << "#else\n"
+        << "#error \"No atomic compare-and-swap available, compile as C11\"\n"
+        << "#endif\n\n";
+      break;
     }
   }
 
@@ -979,6 +1092,13 @@ namespace casadi {
       + z + ", " + sparsity(sp_z) + ", " + w + ", " +  (tr ? "1" : "0") + ");";
   }
 
+  string CodeGenerator::mtimes(const string& x, int nrow_x, int ncol_x,
+                               const string& y, int ncol_y, const string& z) {
+    add_auxiliary(AUX_MTIMES_DENSE);
+    return "casadi_mtimes_dense(" + x + ", " + str(nrow_x) + ", " + str(ncol_x) + ", "
+           + y + ", " + str(ncol_y) + ", " + z + ");";
+  }
+
   void CodeGenerator::print_formatted(const string& s) {
     // Quick return if empty
     if (s.empty()) return;
@@ -1198,4 +1318,32 @@ namespace casadi {
            + beta + ", " + pinv + ", " + w + ");";
   }
 
+  string CodeGenerator::
+  ldl(const string& sp_a, const string& parent,
+      const string& sp_l, const string& a,
+      const string& l, const string& d,
+      const string& iw, const string& w) {
+    add_auxiliary(CodeGenerator::AUX_LDL);
+    return "casadi_ldl(" + sp_a + ", " + parent + ", " + sp_l + ", " + a + ", "
+           + l + ", " + d + ", " + iw + ", " + w + ");";
+  }
+
+  string CodeGenerator::
+  ldl_sn(const string& sp_a, const string& sp_l,
+         int nsn, const string& sn, const string& a,
+         const string& l, const string& d,
+         const string& iw, const string& w) {
+    add_auxiliary(CodeGenerator::AUX_LDL);
+    return "casadi_ldl_sn(" + sp_a + ", " + sp_l + ", " + str(nsn) + ", " + sn + ", "
+           + a + ", " + l + ", " + d + ", " + iw + ", " + w + ");";
+  }
+
+  string CodeGenerator::
+  ldl_solve(const string& x, int nrhs, const string& sp_l,
+            const string& l, const string& d) {
+    add_auxiliary(CodeGenerator::AUX_LDL);
+    return "casadi_ldl_solve(" + x + ", " + str(nrhs) + ", " + sp_l + ", "
+           + l + ", " + d + ");";
+  }
+
 } // namespace casadi
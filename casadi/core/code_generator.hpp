@@ -60,6 +60,12 @@ namespace casadi {
     */
     std::string generate(const std::string& prefix="") const;
 
+    /** \brief Names of all source files written by generate
+      The first entry is the main file, followed by the files holding chunks
+      of split up functions, if any. The latter can be compiled in parallel.
+    */
+    std::vector<std::string> source_files(const std::string& prefix="") const;
+
     /// Add an include file optionally using a relative path "..." instead of an absolute path <...>
     void add_include(const std::string& new_include, bool relative_path=false,
                     const std::string& use_ifdef=std::string());
@@ -168,6 +174,10 @@ namespace casadi {
                        const std::string& z, const Sparsity& sp_z,
                        const std::string& w, bool tr);
 
+    /** \brief Codegen dense matrix-matrix multiplication */
+    std::string mtimes(const std::string& x, int nrow_x, int ncol_x,
+                       const std::string& y, int ncol_y, const std::string& z);
+
     /** \brief Codegen bilinear form */
     std::string bilin(const std::string& A, const Sparsity& sp_A,
                       const std::string& x, const std::string& y);
@@ -209,6 +219,28 @@ namespace casadi {
                          const std::string& beta, const std::string& pinv,
                          const std::string& w);
 
+    /** \brief LDL factorization */
+    std::string ldl(const std::string& sp_a, const std::string& parent,
+                    const std::string& sp_l, const std::string& a,
+                    const std::string& l, const std::string& d,
+                    const std::string& iw, const std::string& w);
+
+    /** \brief Supernodal LDL factorization */
+    std::string ldl_sn(const std::string& sp_a, const std::string& sp_l,
+                       int nsn, const std::string& sn, const std::string& a,
+                       const std::string& l, const std::string& d,
+                       const std::string& iw, const std::string& w);
+
+    /** \brief LDL solve */
+    std::string ldl_solve(const std::string& x, int nrhs, const std::string& sp_l,
+                          const std::string& l, const std::string& d);
+
+    /** \brief Add a chunk of a function that has been split up, returns its name
+      The chunk has the signature void(const casadi_real** arg, casadi_real** res,
+      casadi_real* w) and its body may only reference these arguments.
+    */
+    std::string add_chunk(const std::string& body);
+
     /** \brief Declare a function */
     std::string declare(std::string s);
 
@@ -232,6 +264,7 @@ namespace casadi {
       AUX_MV,
       AUX_MV_DENSE,
       AUX_MTIMES,
+      AUX_MTIMES_DENSE,
       AUX_PROJECT,
       AUX_DENSIFY,
       AUX_TRANS,
@@ -246,7 +279,10 @@ namespace casadi {
       AUX_DE_BOOR,
       AUX_ND_BOOR_EVAL,
       AUX_FINITE_DIFF,
-      AUX_QR
+      AUX_QR,
+      AUX_LDL,
+      AUX_IPQP,
+      AUX_CAS
     };
 
     /** \brief Add a built-in auxiliary function */
@@ -318,6 +354,15 @@ namespace casadi {
     // Generate main entry point
     void generate_main(std::ostream &s) const;
 
+    // Generate the definition of the symbol prefix
+    void generate_prefix(std::ostream &s) const;
+
+    // Generate the CasADi extensions to math.h
+    void generate_math(std::ostream &s, bool declaration_only) const;
+
+    // Generate a chunk of a split up function
+    void generate_chunk(std::ostream &s, int k) const;
+
     //  private:
   public:
     /// \cond INTERNAL
@@ -355,6 +400,16 @@ namespace casadi {
     // Have a flag for exporting symbols
     bool with_export;
 
+    /** \brief Split up large SX functions
+     * Algorithms with more instructions than this are generated as a sequence
+     * of separate functions with at most this many instructions each,
+     * bounding the compilation time and memory for each of them. 0 for no splitting.
+     */
+    int chunk_size;
+
+    // Generate the chunks in separate files?
+    bool chunk_files;
+
     // Prefix symbols in DLLs?
     std::string dll_export;
 
@@ -397,6 +452,9 @@ namespace casadi {
     };
     std::vector<FunctionMeta> added_functions_;
 
+    // Chunks of split up functions
+    std::vector<std::string> chunks_;
+
     // Constants
     std::vector<std::vector<double> > double_constants_;
     std::vector<std::vector<int> > integer_constants_;
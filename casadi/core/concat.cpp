@@ -25,6 +25,7 @@
 
 #include "concat.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -375,4 +376,7 @@ namespace casadi {
     }
   }
 
+  void Concat::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
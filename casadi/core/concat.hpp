@@ -46,6 +46,9 @@ namespace casadi {
     /// Destructor
     ~Concat() override = 0;
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Evaluate the function (template)
     template<typename T>
     int eval_gen(const T* const* arg, T* const* res, int* iw, T* w) const;
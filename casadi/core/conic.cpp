@@ -25,6 +25,7 @@
 
 #include "conic_impl.hpp"
 #include "nlpsol_impl.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 namespace casadi {
@@ -417,4 +418,24 @@ namespace casadi {
     return Conic::plugin_options(name).info(op);
   }
 
+  void Conic::serialize_body(SerializingStream& s) const {
+    s.pack(std::string(plugin_name()));
+    s.pack(name_);
+    s.pack(H_);
+    s.pack(A_);
+    s.pack(construct_opts_);
+  }
+
+  Function Conic::deserialize(DeserializingStream& s) {
+    std::string plugin, name;
+    Sparsity H, A;
+    Dict opts;
+    s.unpack(plugin);
+    s.unpack(name);
+    s.unpack(H);
+    s.unpack(A);
+    s.unpack(opts);
+    return Function::create(instantiate(name, plugin, SpDict{{"h", H}, {"a", A}}), opts);
+  }
+
 } // namespace casadi
@@ -73,6 +73,15 @@ namespace casadi {
     const Options& get_options() const override { return options_;}
     ///@}
 
+    /** \brief Class name identifying the deserializer */
+    std::string serialize_class() const override { return "Conic";}
+
+    /** \brief Serialize the plugin name followed by the problem structure */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize, instantiating the plugin */
+    static Function deserialize(DeserializingStream& s);
+
     // Initialize
     void init(const Dict& opts) override;
 
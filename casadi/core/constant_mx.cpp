@@ -27,6 +27,7 @@
 #include <vector>
 #include <algorithm>
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -245,4 +246,8 @@ namespace casadi {
     return MX::zeros(sp);
   }
 
+  void ConstantMX::serialize_body(SerializingStream& s) const {
+    s.pack(get_DM());
+  }
+
 } // namespace casadi
@@ -86,6 +86,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_CONST;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Get the value (only for scalar constant nodes)
     double to_double() const override = 0;
 
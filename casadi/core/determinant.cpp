@@ -24,6 +24,7 @@
 
 
 #include "determinant.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -64,4 +65,7 @@ namespace casadi {
     }
   }
 
+  void Determinant::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
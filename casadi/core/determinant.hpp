@@ -62,6 +62,9 @@ namespace casadi {
 
     /** \brief Get the operation */
     int op() const override { return OP_DETERMINANT;}
+
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
   };
 
 
@@ -24,6 +24,7 @@
 
 
 #include "dot.hpp"
+#include "serializing_stream.hpp"
 using namespace std;
 namespace casadi {
 
@@ -100,4 +101,7 @@ namespace casadi {
       << ";\n";
   }
 
+  void Dot::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
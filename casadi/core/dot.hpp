@@ -82,6 +82,9 @@ namespace casadi {
 
     /** \brief Get the operation */
     int op() const override { return OP_DOT;}
+
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
   };
 
 
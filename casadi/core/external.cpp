@@ -82,7 +82,7 @@ namespace casadi {
     free_mem_ = (free_mem_t)li_.get_function(name_ + "_free_mem");
 
     // Function for numerical evaluation
-    eval_ = (eval_t)li_.get_function(name_);
+    eval_fcn_ = (eval_t)li_.get_function(name_);
   }
 
   External::~External() {
@@ -190,6 +190,12 @@ namespace casadi {
     }
   }
 
+  int GenericExternal::eval(const double** arg, double** res, int* iw, double* w,
+                            void* mem) const {
+    casadi_assert(eval_fcn_!=0, "External: \"" + name_ + "\" cannot be evaluated numerically");
+    return eval_fcn_(arg, res, iw, w, mem);
+  }
+
   void External::init(const Dict& opts) {
     // Call the initialization method of the base class
     FunctionInternal::init(opts);
@@ -145,6 +145,9 @@ namespace casadi {
     init_mem_t init_mem_;
     free_mem_t free_mem_;
 
+    // Numerical evaluation
+    eval_t eval_fcn_;
+
   public:
     /** \brief Constructor */
     GenericExternal(const std::string& name, const Importer& li);
@@ -169,6 +172,9 @@ namespace casadi {
 
     /** \brief Free memory block */
     void free_mem(void *mem) const override;
+
+    /** \brief Evaluate numerically, with the memory objects of the library */
+    int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
   };
 
 
@@ -243,6 +243,9 @@ namespace casadi {
       w += derivative_of_.nnz_out(j);
     }
 
+    // Memory object of the differentiated function
+    scoped_checkout<FunctionInternal> mem_derivative_of(derivative_of_.get());
+
     // For all sensitivity directions
     for (int i=0; i<n_; ++i) {
       // Initial stepsize
@@ -261,7 +264,7 @@ namespace casadi {
             off += nnz;
           }
           // Evaluate
-          if (derivative_of_(arg, res, iw, w)) return 1;
+          if (derivative_of_(arg, res, iw, w, mem_derivative_of)) return 1;
           // Save outputs
           casadi_copy(y, n_y_, yk[k]);
         }
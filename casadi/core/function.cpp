@@ -33,6 +33,7 @@
 #include "nlpsol.hpp"
 #include "conic.hpp"
 #include "jit_function.hpp"
+#include "serializing_stream.hpp"
 
 #include <typeinfo>
 #include <fstream>
@@ -399,7 +400,8 @@ namespace casadi {
     vector<D> w(sz_w());
 
     // Evaluate memoryless
-    (*this)(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), 0);
+    scoped_checkout<FunctionInternal> mem(get());
+    (*this)(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), mem);
   }
 
 
@@ -620,6 +622,13 @@ namespace casadi {
     }
   }
 
+  Function Function::
+  map(int n, const std::string& parallelization, int max_num_threads) const {
+    casadi_assert(max_num_threads>=1, "map: max_num_threads must be positive");
+    if (n==1 || parallelization!="thread") return map(n, parallelization);
+    return Map::create(parallelization, *this, n, {{"max_num_threads", max_num_threads}});
+  }
+
   Function Function::
   slice(const std::string& name, const std::vector<int>& order_in,
         const std::vector<int>& order_out, const Dict& opts) const {
@@ -872,6 +881,8 @@ namespace casadi {
 
   size_t Function::sz_w() const { return (*this)->sz_w();}
 
+  size_t Function::sz_w_batch(int n) const { return (*this)->sz_w_batch(n);}
+
   int Function::operator()(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, int mem) const {
     try {
       return (*this)->sp_forward(arg, res, iw, w, memory(mem));
@@ -977,6 +988,41 @@ namespace casadi {
     return ss.str();
   }
 
+  void Function::serialize(std::ostream &stream) const {
+    SerializingStream s(stream);
+    s.pack(*this);
+  }
+
+  std::string Function::serialize() const {
+    std::stringstream ss;
+    serialize(ss);
+    return ss.str();
+  }
+
+  void Function::save(const std::string &fname) const {
+    std::ofstream stream(fname, std::ios_base::binary);
+    casadi_assert(stream.good(), "Cannot open '" + fname + "' for writing");
+    serialize(stream);
+  }
+
+  Function Function::deserialize(std::istream& stream) {
+    DeserializingStream s(stream);
+    Function ret;
+    s.unpack(ret);
+    return ret;
+  }
+
+  Function Function::deserialize(const std::string& s) {
+    std::stringstream ss(s);
+    return deserialize(ss);
+  }
+
+  Function Function::load(const std::string& fname) {
+    std::ifstream stream(fname, std::ios_base::binary);
+    casadi_assert(stream.good(), "Cannot open '" + fname + "' for reading");
+    return deserialize(stream);
+  }
+
   string Function::name() const {
     if (is_null()) {
       return "null";
@@ -1146,6 +1192,17 @@ namespace casadi {
     }
   }
 
+  int Function::eval_batch(const double** arg, double** res, int* iw, double* w,
+                           int n, int mem) const {
+    try {
+      return (*this)->eval_batch(arg, res, iw, w, memory(mem), n);
+    } catch (KeyboardInterruptException& e) {
+      throw;
+    } catch (exception& e) {
+      THROW_ERROR("eval_batch", e.what());
+    }
+  }
+
   int Function::operator()(const SXElem** arg, SXElem** res, int* iw, SXElem* w, int mem) const {
     try {
       return (*this)->eval_sx(arg, res, iw, w, memory(mem));
@@ -1320,6 +1377,101 @@ namespace casadi {
     return (*this)->memory(ind);
   }
 
+  FunctionBuffer Function::buffer() const {
+    return FunctionBuffer(*this);
+  }
+
+  FunctionBuffer::FunctionBuffer(const Function& f) {
+    init(f);
+  }
+
+  void FunctionBuffer::init(const Function& f) {
+    f_ = f;
+    mem_ = f_.checkout();
+    arg_.assign(f_.sz_arg(), nullptr);
+    res_.assign(f_.sz_res(), nullptr);
+    iw_.resize(f_.sz_iw());
+    w_.resize(f_.sz_w());
+    // Allocate inputs, set by copying
+    in_.resize(f_.n_in());
+    for (int i=0; i<in_.size(); ++i) in_[i] = DM::zeros(f_.sparsity_in(i));
+    // Allocate outputs, written to by default
+    out_.resize(f_.n_out());
+    for (int i=0; i<out_.size(); ++i) {
+      out_[i] = DM::zeros(f_.sparsity_out(i));
+      res_[i] = out_[i].ptr();
+    }
+  }
+
+  FunctionBuffer::FunctionBuffer(const FunctionBuffer& b) : FunctionBuffer(b.f_) {
+    assign(b);
+  }
+
+  FunctionBuffer& FunctionBuffer::operator=(const FunctionBuffer& b) {
+    if (this!=&b) {
+      f_.release(mem_);
+      init(b.f_);
+      assign(b);
+    }
+    return *this;
+  }
+
+  FunctionBuffer::~FunctionBuffer() {
+    if (!f_.is_null()) f_.release(mem_);
+  }
+
+  void FunctionBuffer::assign(const FunctionBuffer& b) {
+    copy(b.arg_.begin(), b.arg_.end(), arg_.begin());
+    // Copied inputs are copied again, bound inputs are shared
+    for (int i=0; i<in_.size(); ++i) {
+      if (b.arg_[i] && b.arg_[i]==b.in_[i].ptr()) {
+        casadi_copy(b.in_[i].ptr(), in_[i].nnz(), in_[i].ptr());
+        arg_[i] = in_[i].ptr();
+      }
+    }
+    // External outputs are shared, internal outputs are not
+    for (int i=0; i<out_.size(); ++i) {
+      if (b.res_[i]!=b.out_[i].ptr()) res_[i] = b.res_[i];
+    }
+  }
+
+  void FunctionBuffer::set_arg(int i, const double* a, int size) {
+    casadi_assert(i>=0 && i<f_.n_in(), "Input index " + str(i) + " out of bounds");
+    casadi_assert(a==nullptr || size==f_.nnz_in(i),
+      "Input " + str(i) + " (" + f_.name_in(i) + ") has mismatching number of nonzeros. "
+      "Expected " + str(f_.nnz_in(i)) + ", got " + str(size));
+    arg_[i] = a;
+  }
+
+  void FunctionBuffer::set_arg(int i, const DM& a) {
+    casadi_assert(i>=0 && i<f_.n_in(), "Input index " + str(i) + " out of bounds");
+    casadi_assert(a.sparsity()==f_.sparsity_in(i),
+      "Input " + str(i) + " (" + f_.name_in(i) + ") has mismatching sparsity. "
+      "Expected " + f_.sparsity_in(i).dim() + ", got " + a.sparsity().dim());
+    casadi_copy(a.ptr(), a.nnz(), in_[i].ptr());
+    arg_[i] = in_[i].ptr();
+  }
+
+  void FunctionBuffer::set_res(int i, double* r, int size) {
+    casadi_assert(i>=0 && i<f_.n_out(), "Output index " + str(i) + " out of bounds");
+    casadi_assert(r==nullptr || size==f_.nnz_out(i),
+      "Output " + str(i) + " (" + f_.name_out(i) + ") has mismatching number of nonzeros. "
+      "Expected " + str(f_.nnz_out(i)) + ", got " + str(size));
+    res_[i] = r;
+  }
+
+  int FunctionBuffer::eval() {
+    try {
+      return f_->eval_gen(get_ptr(arg_), get_ptr(res_), get_ptr(iw_), get_ptr(w_),
+                          f_.memory(mem_));
+    } catch (KeyboardInterruptException& e) {
+      throw;
+    } catch (exception& e) {
+      casadi_error("Error in FunctionBuffer::eval for '" + f_.name() + "':\n"
+                   + string(e.what()));
+    }
+  }
+
   void Function::assert_size_in(int i, int nrow, int ncol) const {
     casadi_assert(size1_in(i)==nrow && size2_in(i)==ncol,
       "Incorrect shape for " + str(*this) + " input " + str(i) + " \""
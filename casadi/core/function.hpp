@@ -38,6 +38,9 @@ namespace casadi {
 
 #endif // SWIG
 
+  /** Forward declaration of evaluation context */
+  class FunctionBuffer;
+
   /** \brief Function object
       A Function instance is a general multiple-input, multiple-output function
       where each input and output can be a sparse matrix.\n
@@ -460,6 +463,13 @@ namespace casadi {
     /** \brief Evaluate memory-less, numerically */
     int operator()(const double** arg, double** res, int* iw, double* w, int mem=0) const;
 
+    /** \brief Evaluate memory-less, numerically, for a batch of \a n inputs
+        Inputs and outputs are stored as n consecutive instances, as for map.
+        The length of w must be at least sz_w_batch(n).
+    */
+    int eval_batch(const double** arg, double** res, int* iw, double* w,
+                   int n, int mem=0) const;
+
     /** \brief Evaluate memory-less SXElem
         Same syntax as the double version, allowing use in templated code
      */
@@ -558,10 +568,16 @@ namespace casadi {
                 s_(N-1) <- f(a_(N-1), p_(N-1))
         \endverbatim
 
-        \param parallelization Type of parallelization used: unroll|serial|openmp
+        \param parallelization Type of parallelization used: unroll|serial|openmp|thread
     */
     Function map(int n, const std::string& parallelization="serial") const;
 
+    /** \brief  Create a mapped version of this function, limiting the number of threads
+
+        Only has an effect for the thread parallelization.
+    */
+    Function map(int n, const std::string& parallelization, int max_num_threads) const;
+
     ///@{
     /** \brief Map with reduction
       A subset of the inputs are non-repeated and a subset of the outputs summed
@@ -681,6 +697,27 @@ namespace casadi {
 #ifndef SWIG
     void export_code(const std::string& lang,
       std::ostream &stream, const Dict& options=Dict()) const;
+#endif // SWIG
+    ///@}
+
+    /** \brief Serialize the function to a binary format
+     *
+     * Only allowed for SX/MX Functions, maps and (a subset of) plugin instances
+     */
+    ///@{
+    void save(const std::string &fname) const;
+    std::string serialize() const;
+#ifndef SWIG
+    void serialize(std::ostream &stream) const;
+#endif // SWIG
+    ///@}
+
+    /** \brief Deserialize a function written by save or serialize */
+    ///@{
+    static Function load(const std::string& fname);
+    static Function deserialize(const std::string& s);
+#ifndef SWIG
+    static Function deserialize(std::istream& stream);
 #endif // SWIG
     ///@}
 #ifndef SWIG
@@ -831,6 +868,9 @@ namespace casadi {
     /** \brief Get required length of w field */
     size_t sz_w() const;
 
+    /** \brief Get required length of w field for batched evaluation */
+    size_t sz_w_batch(int n) const;
+
 #ifndef SWIG
     /** \brief Get number of temporary variables needed */
     void sz_work(size_t& sz_arg, size_t& sz_res, size_t& sz_iw, size_t& sz_w) const;
@@ -894,6 +934,11 @@ namespace casadi {
     void* memory(int ind) const;
 #endif // SWIG
 
+    /** \brief Create a context for repeated numerical evaluation
+     * \see FunctionBuffer
+     */
+    FunctionBuffer buffer() const;
+
     // Get a list of all functions
     std::vector<std::string> get_function() const;
 
@@ -947,6 +992,77 @@ namespace casadi {
 
   };
 
+  /** \brief Context for repeated numerical evaluation of a Function
+
+      A memory object is checked out and the work vectors, inputs and outputs
+      are allocated once, when the buffer is created, so that repeated
+      evaluations perform no heap allocations. Inputs set from matrices are
+      copied into buffers owned by the instance. From C++, inputs and outputs
+      can instead be bound to existing nonzeros, which are then not copied and
+      must remain valid for as long as they are bound.
+
+      An instance must not be shared between threads, but several instances
+      for the same Function can be used concurrently.
+  */
+  class CASADI_EXPORT FunctionBuffer {
+  public:
+    /// Constructor
+    explicit FunctionBuffer(const Function& f);
+
+    /// Copy constructor, checks out a new memory object
+    FunctionBuffer(const FunctionBuffer& b);
+
+    /// Destructor, releases the memory object
+    ~FunctionBuffer();
+
+    /// Set an input from a matrix with the sparsity of the input, copying the nonzeros
+    void set_arg(int i, const DM& a);
+
+    /** \brief Evaluate numerically
+     * Returns the (nonzero on failure) return flag of the function
+     */
+    int eval();
+
+    /// Get the outputs that have not been bound to external nonzeros
+    std::vector<DM> ret() const { return out_;}
+
+#ifndef SWIG
+    /// Assignment, checks out a new memory object
+    FunctionBuffer& operator=(const FunctionBuffer& b);
+
+    /// Bind an input to nonzeros without copying, null means all zero
+    void set_arg(int i, const double* a, int size);
+
+    /// Bind an output to nonzeros, null means that the output is not needed
+    void set_res(int i, double* r, int size);
+
+    /// Get an output that has not been bound to external nonzeros
+    const DM& res(int i) const { return out_.at(i);}
+
+  private:
+    // Check out memory and allocate buffers
+    void init(const Function& f);
+
+    // Copy the bindings of another instance
+    void assign(const FunctionBuffer& b);
+
+    // Function being evaluated
+    Function f_;
+
+    // Memory object
+    int mem_;
+
+    // Work vectors
+    std::vector<const double*> arg_;
+    std::vector<double*> res_;
+    std::vector<int> iw_;
+    std::vector<double> w_;
+
+    // Inputs and outputs owned by the instance
+    std::vector<DM> in_, out_;
+#endif // SWIG
+  };
+
 } // namespace casadi
 
 #include "sx.hpp"
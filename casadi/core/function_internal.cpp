@@ -29,6 +29,17 @@
 #include "global_options.hpp"
 #include "external.hpp"
 #include "finite_differences.hpp"
+#include "importer_internal.hpp"
+#include "serializing_stream.hpp"
+#include "sx_function.hpp"
+#include "mx_function.hpp"
+#include "map.hpp"
+#include "nlpsol_impl.hpp"
+#include "integrator_impl.hpp"
+#include "rootfinder_impl.hpp"
+#include "interpolant_impl.hpp"
+#include "conic_impl.hpp"
+#include "thread_pool.hpp"
 
 #include <typeinfo>
 #include <cctype>
@@ -71,6 +82,10 @@ namespace casadi {
     ad_weight_ = 0.33; // i.e. nf <= 2*na <=> 1/3*nf <= (1-1/3)*na, forward when tie
     // Both modes equally expensive by default (no "taping" needed)
     ad_weight_sp_ = 0.49; // Forward when tie
+    sparsity_batch_size_ = 8;
+    sparsity_max_num_threads_ = 1;
+    coloring_ordering_ = -1;
+    coloring_num_threads_ = 1;
     jac_penalty_ = 2;
     max_num_dir_ = GlobalOptions::getMaxNumDir();
     user_data_ = 0;
@@ -78,6 +93,7 @@ namespace casadi {
     inputs_check_ = true;
     jit_ = false;
     compilerplugin_ = "clang";
+    jit_chunk_size_ = 0;
     print_time_ = true;
     eval_ = 0;
     has_refcount_ = false;
@@ -114,6 +130,7 @@ namespace casadi {
 
     // Make sure all options exist
     get_options().check(opts);
+    construct_opts_ = opts;
 
     // Initialize the class hierarchy
     try {
@@ -157,6 +174,24 @@ namespace casadi {
         "Weighting factor for sparsity pattern calculation calculation."
         "Overrides default behavior. Set to 0 and 1 to force forward and "
         "reverse mode respectively. Cf. option \"ad_weight\"."}},
+      {"sparsity_batch_size",
+       {OT_INT,
+        "Number of sparsity pattern sweeps, each with " + str(bvec_size) + " directions, "
+        "that are propagated together in one pass through the algorithm [default: 8]"}},
+      {"sparsity_max_num_threads",
+       {OT_INT,
+        "Maximum number of threads used for the sparsity pattern sweeps. "
+        "0 for the number of cores. The function must then support concurrent "
+        "sparsity propagation [default: 1]"}},
+      {"coloring_ordering",
+       {OT_STRING,
+        "Column ordering for the graph coloring that determines the seeds of "
+        "a Jacobian or Hessian: 'natural', 'largest_first', 'smallest_last' or "
+        "'incidence_degree' [default: natural for Jacobians, largest_first for Hessians]"}},
+      {"coloring_num_threads",
+       {OT_INT,
+        "Number of threads for the graph coloring of Jacobians. More than one "
+        "gives a speculative parallel coloring, 0 for the number of cores [default: 1]"}},
       {"jac_penalty",
        {OT_DOUBLE,
         "When requested for a number of forward/reverse directions,   "
@@ -195,6 +230,12 @@ namespace casadi {
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
+      {"jit_chunk_size",
+       {OT_INT,
+        "Generate code for the jit compiler in separate files with at most "
+        "this many instructions each, allowing them to be compiled concurrently. "
+        "Separate files are only used with the 'shell' compiler, other compilers "
+        "get the chunks in a single file. 0 for no chunks. Default: 0"}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -272,12 +313,33 @@ namespace casadi {
         compilerplugin_ = op.second.to_string();
       } else if (op.first=="jit_options") {
         jit_options_ = op.second;
+      } else if (op.first=="jit_chunk_size") {
+        jit_chunk_size_ = op.second;
       } else if (op.first=="derivative_of") {
         derivative_of_ = op.second;
       } else if (op.first=="ad_weight") {
         ad_weight_ = op.second;
       } else if (op.first=="ad_weight_sp") {
         ad_weight_sp_ = op.second;
+      } else if (op.first=="sparsity_batch_size") {
+        sparsity_batch_size_ = op.second;
+      } else if (op.first=="sparsity_max_num_threads") {
+        sparsity_max_num_threads_ = op.second;
+      } else if (op.first=="coloring_ordering") {
+        string ordering = op.second;
+        if (ordering=="natural") {
+          coloring_ordering_ = 0;
+        } else if (ordering=="largest_first") {
+          coloring_ordering_ = 1;
+        } else if (ordering=="smallest_last") {
+          coloring_ordering_ = 2;
+        } else if (ordering=="incidence_degree") {
+          coloring_ordering_ = 3;
+        } else {
+          casadi_error("Unknown coloring ordering '" + ordering + "'");
+        }
+      } else if (op.first=="coloring_num_threads") {
+        coloring_num_threads_ = op.second;
       } else if (op.first=="max_num_dir") {
         max_num_dir_ = op.second;
       } else if (op.first=="print_time") {
@@ -297,6 +359,12 @@ namespace casadi {
       }
     }
 
+    casadi_assert(sparsity_batch_size_>=1, "Option 'sparsity_batch_size' must be positive");
+    casadi_assert(sparsity_max_num_threads_>=0,
+                  "Option 'sparsity_max_num_threads' must be nonnegative");
+    casadi_assert(coloring_num_threads_>=0,
+                  "Option 'coloring_num_threads' must be nonnegative");
+
     // Verbose?
     if (verbose_) casadi_message(name_ + "::init");
 
@@ -377,10 +445,22 @@ namespace casadi {
       if (has_codegen()) {
         if (verbose_) casadi_message("Codegenerating function '" + name_ + "'.");
         // JIT everything
-        CodeGenerator gen(jit_name);
+        Dict gen_opts;
+        if (jit_chunk_size_>0) {
+          gen_opts["chunk_size"] = jit_chunk_size_;
+          // Only the shell compiler accepts additional source files
+          gen_opts["chunk_files"] = compilerplugin_=="shell";
+        }
+        CodeGenerator gen(jit_name, gen_opts);
         gen.add(self());
         if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
-        compiler_ = Importer(gen.generate(), compilerplugin_, jit_options_);
+        string src = gen.generate();
+        // Chunks are compiled alongside the main file
+        vector<string> extra_sources = gen.source_files();
+        extra_sources.erase(extra_sources.begin());
+        Dict jit_options = jit_options_;
+        if (!extra_sources.empty()) jit_options["extra_sources"] = extra_sources;
+        compiler_ = Importer(src, compilerplugin_, jit_options);
         if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
         // Try to load
         eval_ = (eval_t)compiler_.get_function(name_);
@@ -394,10 +474,19 @@ namespace casadi {
     ProtoFunction::finalize(opts);
   }
 
+  Dict FunctionInternal::get_stats(void* mem) const {
+    Dict stats;
+    // Statistics from the just-in-time compilation
+    if (!compiler_.is_null()) stats["jit"] = compiler_->get_stats();
+    return stats;
+  }
+
   void ProtoFunction::finalize(const Dict& opts) {
     // Create memory object
     int mem = checkout();
     casadi_assert_dev(mem==0);
+    // Make it available, it will be the first to be checked out
+    release(mem);
   }
 
   int FunctionInternal::
@@ -409,6 +498,65 @@ namespace casadi {
     }
   }
 
+  int FunctionInternal::
+  eval_batch(const double** arg, double** res, int* iw, double* w, void* mem, int n) const {
+    // Evaluate one instance at a time, advancing the buffers in-place
+    int flag = 0, k;
+    for (k=0; k<n && !flag; ++k) {
+      if (k>0) {
+        for (int i=0; i<n_in_; ++i) if (arg[i]) arg[i] += nnz_in(i);
+        for (int i=0; i<n_out_; ++i) if (res[i]) res[i] += nnz_out(i);
+      }
+      flag = eval_gen(arg, res, iw, w, mem);
+    }
+    // Restore the buffers
+    if (k>1) {
+      for (int i=0; i<n_in_; ++i) if (arg[i]) arg[i] -= (k-1)*nnz_in(i);
+      for (int i=0; i<n_out_; ++i) if (res[i]) res[i] -= (k-1)*nnz_out(i);
+    }
+    return flag;
+  }
+
+  int FunctionInternal::
+  sp_forward_batch(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                   void* mem, int n) const {
+    // Propagate one set of seeds at a time, advancing the buffers in-place
+    int flag = 0, k;
+    for (k=0; k<n && !flag; ++k) {
+      if (k>0) {
+        for (int i=0; i<n_in_; ++i) if (arg[i]) arg[i] += nnz_in(i);
+        for (int i=0; i<n_out_; ++i) if (res[i]) res[i] += nnz_out(i);
+      }
+      flag = sp_forward(arg, res, iw, w, mem);
+    }
+    // Restore the buffers
+    if (k>1) {
+      for (int i=0; i<n_in_; ++i) if (arg[i]) arg[i] -= (k-1)*nnz_in(i);
+      for (int i=0; i<n_out_; ++i) if (res[i]) res[i] -= (k-1)*nnz_out(i);
+    }
+    return flag;
+  }
+
+  int FunctionInternal::
+  sp_reverse_batch(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                   void* mem, int n) const {
+    // Propagate one set of seeds at a time, advancing the buffers in-place
+    int flag = 0, k;
+    for (k=0; k<n && !flag; ++k) {
+      if (k>0) {
+        for (int i=0; i<n_in_; ++i) if (arg[i]) arg[i] += nnz_in(i);
+        for (int i=0; i<n_out_; ++i) if (res[i]) res[i] += nnz_out(i);
+      }
+      flag = sp_reverse(arg, res, iw, w, mem);
+    }
+    // Restore the buffers
+    if (k>1) {
+      for (int i=0; i<n_in_; ++i) if (arg[i]) arg[i] -= (k-1)*nnz_in(i);
+      for (int i=0; i<n_out_; ++i) if (res[i]) res[i] -= (k-1)*nnz_out(i);
+    }
+    return flag;
+  }
+
   void FunctionInternal::print_dimensions(ostream &stream) const {
     stream << " Number of inputs: " << n_in_ << endl;
     for (int i=0; i<n_in_; ++i) {
@@ -518,119 +666,153 @@ namespace casadi {
     typedef const bvec_t* arg_t;
     static inline void sp(const FunctionInternal *f,
                           const bvec_t** arg, bvec_t** res,
-                          int* iw, bvec_t* w, void* mem) {
-      f->sp_forward(arg, res, iw, w, mem);
+                          int* iw, bvec_t* w, void* mem, int n) {
+      f->sp_forward_batch(arg, res, iw, w, mem, n);
     }
   };
   template<> struct JacSparsityTraits<false> {
     typedef bvec_t* arg_t;
     static inline void sp(const FunctionInternal *f,
                           bvec_t** arg, bvec_t** res,
-                          int* iw, bvec_t* w, void* mem) {
-      f->sp_reverse(arg, res, iw, w, mem);
+                          int* iw, bvec_t* w, void* mem, int n) {
+      f->sp_reverse_batch(arg, res, iw, w, mem, n);
     }
   };
 
   template<bool fwd>
   Sparsity FunctionInternal::
   getJacSparsityGen(int iind, int oind, bool symmetric, int gr_i, int gr_o) const {
-    // Number of nonzero inputs and outputs
-    int nz_in = nnz_in(iind);
-    int nz_out = nnz_out(oind);
+    // Number of seed and sensitivity nonzeros
+    int nz_seed = fwd ? nnz_in(iind) : nnz_out(oind);
+    int nz_sens = fwd ? nnz_out(oind) : nnz_in(iind);
 
-    // Evaluation buffers
-    vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), 0);
-    vector<bvec_t*> res(sz_res(), 0);
-    vector<int> iw(sz_iw());
-    vector<bvec_t> w(sz_w(), 0);
+    // Number of sweeps we must make
+    int nsweep = nz_seed / bvec_size;
+    if (nz_seed % bvec_size) nsweep++;
 
-    // Seeds and sensitivities
-    vector<bvec_t> seed(nz_in, 0);
-    arg[iind] = get_ptr(seed);
-    vector<bvec_t> sens(nz_out, 0);
-    res[oind] = get_ptr(sens);
-    if (!fwd) std::swap(seed, sens);
+    // Sweeps are propagated in passes of (at most) nb sweeps
+    int nb = std::max(1, std::min(sparsity_batch_size_, nsweep));
+    int npass = nsweep / nb;
+    if (nsweep % nb) npass++;
 
-    // Number of forward sweeps we must make
-    int nsweep = seed.size() / bvec_size;
-    if (seed.size() % bvec_size) nsweep++;
+    // Number of threads, each processing every nt-th pass
+    int nt = sparsity_max_num_threads_>0 ? sparsity_max_num_threads_
+                                          : ThreadPool::instance().size();
+    nt = std::max(1, std::min(nt, npass));
 
     // Print
     if (verbose_) {
       casadi_message(str(nsweep) + string(fwd ? " forward" : " reverse") + " sweeps "
-                     "needed for " + str(seed.size()) + " directions");
-    }
-
-    // Progress
-    int progress = -10;
-
-    // Temporary vectors
-    std::vector<int> jcol, jrow;
+                     "needed for " + str(nz_seed) + " directions, " + str(npass) + " passes "
+                     "using " + str(nt) + " thread(s)");
+    }
+
+    // Triplets found by each thread
+    vector<vector<int> > jcol(nt), jrow(nt);
+
+    // Work performed by each thread
+    auto work = [&](int t) {
+      // Evaluation buffers
+      vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), 0);
+      vector<bvec_t*> res(sz_res(), 0);
+      vector<int> iw(sz_iw());
+      vector<bvec_t> w(sz_w_batch(nb), 0);
+
+      // Seeds and sensitivities for all sweeps of a pass
+      vector<bvec_t> seed(nb*nz_seed, 0), sens(nb*nz_sens, 0);
+      arg[iind] = get_ptr(fwd ? seed : sens);
+      res[oind] = get_ptr(fwd ? sens : seed);
+
+      // Memory object of this thread
+      scoped_checkout<FunctionInternal> mem(this);
+
+      // Progress
+      int progress = -10;
+
+      for (int p=t; p<npass; p+=nt) {
+        // Print progress
+        if (verbose_ && t==0) {
+          int progress_new = (p*100)/npass;
+          // Print when entering a new decade
+          if (progress_new / 10 > progress / 10) {
+            progress = progress_new;
+            casadi_message(str(progress) + " %");
+          }
+        }
 
-    // Loop over the variables, bvec_size variables at a time
-    for (int s=0; s<nsweep; ++s) {
+        // Number of sweeps in this pass
+        int nl = std::min(nb, nsweep-p*nb);
 
-      // Print progress
-      if (verbose_) {
-        int progress_new = (s*100)/nsweep;
-        // Print when entering a new decade
-        if (progress_new / 10 > progress / 10) {
-          progress = progress_new;
-          casadi_message(str(progress) + " %");
+        // Set the seeds, bvec_size directions per sweep
+        for (int k=0; k<nl; ++k) {
+          int offset = (p*nb+k)*bvec_size;
+          int ndir_local = std::min(bvec_size, nz_seed-offset);
+          for (int i=0; i<ndir_local; ++i) {
+            seed[k*nz_seed+offset+i] |= bvec_t(1)<<i;
+          }
         }
-      }
 
-      // Nonzero offset
-      int offset = s*bvec_size;
+        // Propagate the dependencies
+        JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
+                                    get_ptr(iw), get_ptr(w), memory(mem), nl);
 
-      // Number of local seed directions
-      int ndir_local = seed.size()-offset;
-      ndir_local = std::min(bvec_size, ndir_local);
-
-      for (int i=0; i<ndir_local; ++i) {
-        seed[offset+i] |= bvec_t(1)<<i;
-      }
+        for (int k=0; k<nl; ++k) {
+          // Nonzero offset
+          int offset = (p*nb+k)*bvec_size;
 
-      // Propagate the dependencies
-      JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
-                                  get_ptr(iw), get_ptr(w), memory(0));
+          // Number of local seed directions
+          int ndir_local = std::min(bvec_size, nz_seed-offset);
 
-      // Loop over the nonzeros of the output
-      for (int el=0; el<sens.size(); ++el) {
+          // Loop over the nonzeros of the output
+          bvec_t* sens_k = get_ptr(sens) + k*nz_sens;
+          for (int el=0; el<nz_sens; ++el) {
 
-        // Get the sparsity sensitivity
-        bvec_t spsens = sens[el];
+            // Get the sparsity sensitivity
+            bvec_t spsens = sens_k[el];
 
-        if (!fwd) {
-          // Clear the sensitivities for the next sweep
-          sens[el] = 0;
-        }
+            if (!fwd) {
+              // Clear the sensitivities for the next sweep
+              sens_k[el] = 0;
+            }
 
-        // If there is a dependency in any of the directions
-        if (spsens!=0) {
+            // If there is a dependency in any of the directions
+            if (spsens!=0) {
 
-          // Loop over seed directions
-          for (int i=0; i<ndir_local; ++i) {
+              // Loop over seed directions
+              for (int i=0; i<ndir_local; ++i) {
 
-            // If dependents on the variable
-            if ((bvec_t(1) << i) & spsens) {
-              // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+                // If dependents on the variable
+                if ((bvec_t(1) << i) & spsens) {
+                  // Add to pattern
+                  jcol[t].push_back(el);
+                  jrow[t].push_back(i+offset);
+                }
+              }
             }
           }
+
+          // Remove the seeds
+          for (int i=0; i<ndir_local; ++i) {
+            seed[k*nz_seed+offset+i] = 0;
+          }
         }
       }
+    };
 
-      // Remove the seeds
-      for (int i=0; i<ndir_local; ++i) {
-        seed[offset+i] = 0;
+    // Perform the sweeps
+    if (nt==1) {
+      work(0);
+    } else {
+      ThreadPool::instance().run(nt, work);
+      for (int t=1; t<nt; ++t) {
+        jcol[0].insert(jcol[0].end(), jcol[t].begin(), jcol[t].end());
+        jrow[0].insert(jrow[0].end(), jrow[t].begin(), jrow[t].end());
       }
     }
 
     // Construct sparsity pattern and return
-    if (!fwd) swap(jrow, jcol);
-    Sparsity ret = Sparsity::triplet(nz_out, nz_in, jcol, jrow);
+    if (!fwd) swap(jrow[0], jcol[0]);
+    Sparsity ret = Sparsity::triplet(nnz_out(oind), nnz_in(iind), jcol[0], jrow[0]);
     if (verbose_) {
       casadi_message("Formed Jacobian sparsity pattern (dimension " + str(ret.size()) + ", "
           + str(ret.nnz()) + " (" + str(ret.density()) + " %) nonzeros.");
@@ -1280,7 +1462,7 @@ namespace casadi {
 
       // Star coloring if symmetric
       if (verbose_) casadi_message("FunctionInternal::getPartition star_coloring");
-      D1 = A.star_coloring();
+      D1 = A.star_coloring(coloring_ordering_>=0 ? coloring_ordering_ : 1);
       if (verbose_) {
         casadi_message("Star coloring completed: " + str(D1.size2())
           + " directional derivatives needed ("
@@ -1297,6 +1479,9 @@ namespace casadi {
       if (w==0) allow_reverse = false;
       casadi_assert(allow_forward || allow_reverse, "Conflicting ad weights");
 
+      // Column ordering for the coloring
+      int ordering = coloring_ordering_>=0 ? coloring_ordering_ : 0;
+
       // Best coloring encountered so far (relatively tight upper bound)
       double best_coloring = numeric_limits<double>::infinity();
 
@@ -1318,7 +1503,7 @@ namespace casadi {
           if (verbose_) casadi_message("Unidirectional coloring (forward mode)");
           int max_colorings_to_test = best_coloring>=w*A.size1() ? A.size1() :
             floor(best_coloring/w);
-          D1 = AT.uni_coloring(A, max_colorings_to_test);
+          D1 = AT.uni_coloring(A, max_colorings_to_test, ordering, coloring_num_threads_);
           if (D1.is_null()) {
             if (verbose_) {
               casadi_message("Forward mode coloring interrupted (more than "
@@ -1338,7 +1523,7 @@ namespace casadi {
           int max_colorings_to_test = best_coloring>=(1-w)*A.size2() ? A.size2() :
             floor(best_coloring/(1-w));
 
-          D2 = A.uni_coloring(AT, max_colorings_to_test);
+          D2 = A.uni_coloring(AT, max_colorings_to_test, ordering, coloring_num_threads_);
           if (D2.is_null()) {
             if (verbose_) {
               casadi_message("Adjoint mode coloring interrupted (more than "
@@ -1713,6 +1898,24 @@ namespace casadi {
       << "return 0;\n"
       << "}\n\n";
 
+    // Memory objects, claimed without locking so that calls can be made in parallel
+    g.add_auxiliary(CodeGenerator::AUX_CAS);
+    g << "#ifndef CASADI_MAX_NUM_THREADS\n"
+      << "#define CASADI_MAX_NUM_THREADS 64\n"
+      << "#endif\n\n"
+      << "static casadi_atomic_long " << name_ << "_mem_used[CASADI_MAX_NUM_THREADS];\n\n"
+      << g.declare("int " + name_ + "_checkout(void)") << " {\n"
+      << "int mid;\n"
+      << "for (mid=0; mid<CASADI_MAX_NUM_THREADS; ++mid) {\n"
+      << "if (casadi_cas(" << name_ << "_mem_used+mid, 0, 1)) return mid;\n"
+      << "}\n"
+      << "return -1;\n"
+      << "}\n\n"
+      << g.declare("void " + name_ + "_release(int mem)") << " {\n"
+      << "if (mem>=0 && mem<CASADI_MAX_NUM_THREADS) "
+      << "casadi_cas(" << name_ << "_mem_used+mem, 1, 0);\n"
+      << "}\n\n";
+
     // Generate mex gateway for the function
     if (g.mex) {
       // Begin conditional compilation
@@ -2349,6 +2552,35 @@ namespace casadi {
     return type == "FunctionInternal";
   }
 
+  void FunctionInternal::serialize(SerializingStream& s) const {
+    s.pack(serialize_class());
+    serialize_body(s);
+  }
+
+  void FunctionInternal::serialize_body(SerializingStream& s) const {
+    casadi_error("'serialize' not defined for " + class_name());
+  }
+
+  Function FunctionInternal::deserialize(DeserializingStream& s) {
+    // Deserializers, by class name
+    typedef Function (*Deserializer)(DeserializingStream& s);
+    static const map<string, Deserializer> deserializers = {
+      {"SXFunction", SXFunction::deserialize},
+      {"MXFunction", MXFunction::deserialize},
+      {"Map", Map::deserialize},
+      {"Nlpsol", Nlpsol::deserialize},
+      {"Integrator", Integrator::deserialize},
+      {"Rootfinder", Rootfinder::deserialize},
+      {"Interpolant", Interpolant::deserialize},
+      {"Conic", Conic::deserialize}
+    };
+    string class_name;
+    s.unpack(class_name);
+    auto it = deserializers.find(class_name);
+    casadi_assert(it!=deserializers.end(), "Cannot deserialize a " + class_name);
+    return it->second(s);
+  }
+
   std::vector<MX> FunctionInternal::free_mx() const {
     casadi_error("'free_mx' only defined for 'MXFunction'");
   }
@@ -2465,10 +2697,14 @@ namespace casadi {
   }
 
   void ProtoFunction::clear_mem() {
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(mtx_);
+#endif // WITH_THREAD
     for (auto&& i : mem_) {
       if (i!=0) free_mem(i);
     }
     mem_.clear();
+    unused_ = std::stack<int>();
   }
 
   size_t FunctionInternal::get_n_in() {
@@ -2523,17 +2759,31 @@ namespace casadi {
   }
 
   void* ProtoFunction::memory(int ind) const {
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(mtx_);
+#endif // WITH_THREAD
     return mem_.at(ind);
   }
 
   int ProtoFunction::checkout() const {
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(mtx_);
+#endif // WITH_THREAD
     if (unused_.empty()) {
-      // Allocate a new memory object
+      // Allocate a new memory object, not kept if the initialization fails
       void* m = alloc_mem();
-      mem_.push_back(m);
-      if (init_mem(m)) {
+      int flag;
+      try {
+        flag = init_mem(m);
+      } catch (...) {
+        if (m!=0) free_mem(m);
+        throw;
+      }
+      if (flag) {
+        if (m!=0) free_mem(m);
         casadi_error("Failed to create or initialize memory object");
       }
+      mem_.push_back(m);
       return mem_.size()-1;
     } else {
       // Use an unused memory object
@@ -2544,6 +2794,9 @@ namespace casadi {
   }
 
   void ProtoFunction::release(int mem) const {
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(mtx_);
+#endif // WITH_THREAD
     unused_.push(mem);
   }
 
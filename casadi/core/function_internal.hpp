@@ -34,6 +34,9 @@
 #include "sparse_storage.hpp"
 #include "options.hpp"
 #include "shared_object_internal.hpp"
+#ifdef WITH_THREAD
+#include <mutex>
+#endif // WITH_THREAD
 
 // This macro is for documentation purposes
 #define INPUTSCHEME(name)
@@ -44,6 +47,9 @@
 /// \cond INTERNAL
 
 namespace casadi {
+  class SerializingStream;
+  class DeserializingStream;
+
   template<typename T>
   std::vector<std::pair<std::string, T>> zip(const std::vector<std::string>& id,
                                              const std::vector<T>& mat) {
@@ -119,12 +125,36 @@ namespace casadi {
 
     /// Verbose printout
     bool verbose_;
+
+    /// Options passed to construct, kept for serialization
+    Dict construct_opts_;
   private:
     /// Memory objects
     mutable std::vector<void*> mem_;
 
     /// Unused memory objects
     mutable std::stack<int> unused_;
+
+#ifdef WITH_THREAD
+    /// Protects mem_ and unused_ when called from multiple threads
+    mutable std::mutex mtx_;
+#endif // WITH_THREAD
+  };
+
+  /** \brief Checkout a memory object for the lifetime of the instance
+      Makes sure that the memory object is released also if an exception is thrown
+  */
+  template<typename T>
+  class scoped_checkout {
+  public:
+    explicit scoped_checkout(const T* f) : f_(f), mem_(f->checkout()) {}
+    ~scoped_checkout() { f_->release(mem_);}
+    operator int() const { return mem_;}
+  private:
+    scoped_checkout(const scoped_checkout&);
+    scoped_checkout& operator=(const scoped_checkout&);
+    const T* f_;
+    int mem_;
   };
 
   /** \brief Internal class for Function
@@ -196,6 +226,12 @@ namespace casadi {
     virtual int eval(const double** arg, double** res, int* iw, double* w, void* mem) const;
     ///@}
 
+    /** \brief  Evaluate numerically for a batch of \a n inputs
+        Inputs and outputs are stored as n consecutive instances, as for Map.
+        The w field must be of length sz_w_batch(n) */
+    virtual int eval_batch(const double** arg, double** res, int* iw, double* w,
+                           void* mem, int n) const;
+
     /** \brief  Evaluate with symbolic scalars */
     virtual int eval_sx(const SXElem** arg, SXElem** res, int* iw, SXElem* w, void* mem) const;
 
@@ -609,6 +645,16 @@ namespace casadi {
     /** \brief  Propagate sparsity backwards */
     virtual int sp_reverse(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, void* mem) const;
 
+    /** \brief  Propagate sparsity forward for a batch of \a n seeds
+        Seeds and sensitivities are stored as n consecutive instances, as for eval_batch.
+        The w field must be of length sz_w_batch(n) */
+    virtual int sp_forward_batch(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                                 void* mem, int n) const;
+
+    /** \brief  Propagate sparsity backwards for a batch of \a n seeds */
+    virtual int sp_reverse_batch(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                                 void* mem, int n) const;
+
     /** \brief Get number of temporary variables needed */
     void sz_work(size_t& sz_arg, size_t& sz_res, size_t& sz_iw, size_t& sz_w) const;
 
@@ -624,6 +670,9 @@ namespace casadi {
     /** \brief Get required length of w field */
     size_t sz_w() const { return sz_w_per_ + sz_w_tmp_;}
 
+    /** \brief Get required length of w field for batched evaluation */
+    virtual size_t sz_w_batch(int n) const { return sz_w();}
+
     /** \brief Ensure required length of arg field */
     void alloc_arg(size_t sz_arg, bool persistent=false);
 
@@ -640,7 +689,7 @@ namespace casadi {
     void alloc(const Function& f, bool persistent=false);
 
     /// Get all statistics
-    virtual Dict get_stats(void* mem) const { return Dict();}
+    virtual Dict get_stats(void* mem) const;
 
     /** \brief Set the (persistent) work vectors */
     virtual void set_work(void* mem, const double**& arg, double**& res,
@@ -706,6 +755,9 @@ namespace casadi {
     Importer compiler_;
     Dict jit_options_;
 
+    /// Split up the just-in-time compiled code in chunks compiled concurrently
+    int jit_chunk_size_;
+
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
@@ -715,6 +767,12 @@ namespace casadi {
     /// Weighting factor for derivative calculation and sparsity pattern calculation
     double ad_weight_, ad_weight_sp_;
 
+    /// Number of sparsity sweeps propagated together, threads for sparsity sweeps
+    int sparsity_batch_size_, sparsity_max_num_threads_;
+
+    /// Column ordering and number of threads for the graph coloring, -1 for default ordering
+    int coloring_ordering_, coloring_num_threads_;
+
     /// Maximum number of sensitivity directions
     int max_num_dir_;
 
@@ -739,6 +797,18 @@ namespace casadi {
     /** \brief Check if the function is of a particular type */
     virtual bool is_a(const std::string& type, bool recursive) const;
 
+    /** \brief Serialize the function, class name followed by body */
+    void serialize(SerializingStream& s) const;
+
+    /** \brief Class name identifying the deserializer */
+    virtual std::string serialize_class() const { return class_name();}
+
+    /** \brief Serialize the class specific data */
+    virtual void serialize_body(SerializingStream& s) const;
+
+    /** \brief Deserialize a function written by serialize */
+    static Function deserialize(DeserializingStream& s);
+
     /** \brief Can a derivative direction be skipped */
     template<typename MatType>
     static bool purgable(const std::vector<MatType>& seed);
@@ -910,9 +980,10 @@ namespace casadi {
     std::vector<D*> resp(sz_res());
     for (int i=0; i<n_out_; ++i) resp[i]=get_ptr(res[i]);
 
-    // Call memory-less
+    // Call memory-less, using a memory object that is not used by any other thread
+    scoped_checkout<FunctionInternal> mem(this);
     (void)eval_gen(get_ptr(argp), get_ptr(resp),
-                get_ptr(iw_tmp), get_ptr(w_tmp), memory(0));
+                get_ptr(iw_tmp), get_ptr(w_tmp), memory(mem));
   }
 
   template<typename M>
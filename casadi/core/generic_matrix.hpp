@@ -512,6 +512,18 @@ namespace casadi {
       return MatType::substitute_inplace(v, inout_vdef, inout_ex, reverse);
     }
 
+    /** \brief Common subexpression elimination
+     * Merge structurally identical subexpressions so that each is only represented,
+     * evaluated and differentiated once */
+    friend inline MatType cse(const MatType& e) {
+      return MatType::cse(e);
+    }
+
+    /** \brief Common subexpression elimination, shared between multiple expressions */
+    friend inline std::vector<MatType> cse(const std::vector<MatType>& e) {
+      return MatType::cse(e);
+    }
+
     /** \brief  Solve a system of equations: A*x = b
         The solve routine works similar to Matlab's backslash when A is square and nonsingular.
         The algorithm used is the following:
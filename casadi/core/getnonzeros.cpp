@@ -25,6 +25,7 @@
 
 #include "getnonzeros.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -552,5 +553,9 @@ namespace casadi {
     return true;
   }
 
+  void GetNonzeros::serialize_body(SerializingStream& s) const {
+    s.pack(sparsity());
+    s.pack(all());
+  }
 
 } // namespace casadi
@@ -73,6 +73,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_GETNONZEROS;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Get the nonzeros of matrix
     MX get_nzref(const Sparsity& sp, const std::vector<int>& nz) const override;
   };
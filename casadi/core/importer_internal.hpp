@@ -95,6 +95,9 @@ namespace casadi {
     /// Get a function pointer for numerical evaluation
     bool has_function(const std::string& symname) const;
 
+    /** \brief Get compilation statistics */
+    virtual Dict get_stats() const { return Dict();}
+
     /** \brief Does an entry exist? */
     bool has_meta(const std::string& cmd, int ind=-1) const;
 
@@ -25,6 +25,8 @@
 
 #include "integrator_impl.hpp"
 #include "casadi_misc.hpp"
+#include "rootfinder_impl.hpp"
+#include "thread_pool.hpp"
 
 using namespace std;
 namespace casadi {
@@ -506,6 +508,7 @@ namespace casadi {
   int Integrator::
   sp_forward(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, void* mem) const {
     if (verbose_) casadi_message(name_ + "::sp_forward");
+    scoped_checkout<FunctionInternal> mem_oracle(oracle_.get());
 
     // Work vectors
     bvec_t *tmp_x = w; w += nx_;
@@ -522,7 +525,7 @@ namespace casadi {
     fill_n(res1, static_cast<size_t>(DE_NUM_OUT), nullptr);
     res1[DE_ODE] = tmp_x;
     res1[DE_ALG] = tmp_z;
-    oracle_(arg1, res1, iw, w, 0);
+    oracle_(arg1, res1, iw, w, mem_oracle);
     if (arg[INTEGRATOR_X0]) {
       const bvec_t *tmp = arg[INTEGRATOR_X0];
       for (int i=0; i<nx_; ++i) tmp_x[i] |= *tmp++;
@@ -543,7 +546,7 @@ namespace casadi {
       arg1[DE_Z] = tmp_z;
       res1[DE_ODE] = res1[DE_ALG] = 0;
       res1[DE_QUAD] = res[INTEGRATOR_QF];
-      if (oracle_(arg1, res1, iw, w, 0)) return 1;
+      if (oracle_(arg1, res1, iw, w, mem_oracle)) return 1;
     }
 
     if (nrx_>0) {
@@ -558,7 +561,7 @@ namespace casadi {
       fill_n(res1, static_cast<size_t>(DE_NUM_OUT), nullptr);
       res1[DE_RODE] = tmp_rx;
       res1[DE_RALG] = tmp_rz;
-      oracle_(arg1, res1, iw, w, 0);
+      oracle_(arg1, res1, iw, w, mem_oracle);
       if (arg[INTEGRATOR_RX0]) {
         const bvec_t *tmp = arg[INTEGRATOR_RX0];
         for (int i=0; i<nrx_; ++i) tmp_rx[i] |= *tmp++;
@@ -579,7 +582,7 @@ namespace casadi {
         arg1[DE_RZ] = tmp_rz;
         res1[DE_RODE] = res1[DE_RALG] = 0;
         res1[DE_RQUAD] = res[INTEGRATOR_RQF];
-        if (oracle_(arg1, res1, iw, w, 0)) return 1;
+        if (oracle_(arg1, res1, iw, w, mem_oracle)) return 1;
       }
     }
     return 0;
@@ -587,6 +590,7 @@ namespace casadi {
 
   int Integrator::sp_reverse(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, void* mem) const {
     if (verbose_) casadi_message(name_ + "::sp_reverse");
+    scoped_checkout<FunctionInternal> mem_oracle(oracle_.get());
 
     // Work vectors
     bvec_t** arg1 = arg+n_in_;
@@ -651,7 +655,7 @@ namespace casadi {
       arg1[DE_RX] = tmp_rx;
       arg1[DE_RZ] = tmp_rz;
       arg1[DE_RP] = rp;
-      if (oracle_.rev(arg1, res1, iw, w, 0)) return 1;
+      if (oracle_.rev(arg1, res1, iw, w, mem_oracle)) return 1;
 
       // Propagate interdependencies
       fill_n(w, nrx_+nrz_, 0);
@@ -667,7 +671,7 @@ namespace casadi {
       res1[DE_RQUAD] = 0;
       arg1[DE_RX] = rx0;
       arg1[DE_RZ] = 0; // arg[INTEGRATOR_RZ0] is a guess, no dependency
-      if (oracle_.rev(arg1, res1, iw, w, 0)) return 1;
+      if (oracle_.rev(arg1, res1, iw, w, mem_oracle)) return 1;
     }
 
     // Get dependencies from forward quadratures
@@ -678,7 +682,7 @@ namespace casadi {
     arg1[DE_Z] = tmp_z;
     arg1[DE_P] = p;
     if (qf && nq_>0) {
-      if (oracle_.rev(arg1, res1, iw, w, 0)) return 1;
+      if (oracle_.rev(arg1, res1, iw, w, mem_oracle)) return 1;
     }
 
     // Propagate interdependencies
@@ -695,7 +699,7 @@ namespace casadi {
     res1[DE_QUAD] = 0;
     arg1[DE_X] = x0;
     arg1[DE_Z] = 0; // arg[INTEGRATOR_Z0] is a guess, no dependency
-    if (oracle_.rev(arg1, res1, iw, w, 0)) return 1;
+    if (oracle_.rev(arg1, res1, iw, w, mem_oracle)) return 1;
     return 0;
   }
 
@@ -1024,6 +1028,9 @@ namespace casadi {
 
     // Default options
     nk_ = 20;
+    max_checkpoints_ = -1;
+    staggered_ = false;
+    batch_num_threads_ = 1;
   }
 
   FixedStepIntegrator::~FixedStepIntegrator() {
@@ -1034,7 +1041,24 @@ namespace casadi {
   = {{&Integrator::options_},
      {{"number_of_finite_elements",
        {OT_INT,
-        "Number of finite elements"}}
+        "Number of finite elements"}},
+      {"max_checkpoints",
+       {OT_INT,
+        "Maximum number of states stored for the backward integration. If smaller "
+        "than the number of finite elements, states are stored at checkpoints "
+        "placed according to a binomial (revolve) schedule and the other states are "
+        "recomputed during the backward integration [default: no limit]"}},
+      {"forward_sensitivities",
+       {OT_STRING,
+        "Method for forward sensitivities: 'augmented' integrates an augmented DAE "
+        "including the nominal states again, 'staggered' propagates all directions "
+        "along the nominal solution step by step, reusing the factorized Jacobian of "
+        "each step. Problems with backward states always use 'augmented' "
+        "[default: augmented]"}},
+      {"batch_num_threads",
+       {OT_INT,
+        "Maximum number of threads when evaluating many trajectories at once, "
+        "e.g. in a map. 0 means the number of cores [default: 1]"}}
      }
   };
 
@@ -1046,12 +1070,28 @@ namespace casadi {
     for (auto&& op : opts) {
       if (op.first=="number_of_finite_elements") {
         nk_ = op.second;
+      } else if (op.first=="max_checkpoints") {
+        max_checkpoints_ = op.second;
+      } else if (op.first=="forward_sensitivities") {
+        string sens = op.second;
+        if (sens=="augmented") {
+          staggered_ = false;
+        } else if (sens=="staggered") {
+          staggered_ = true;
+        } else {
+          casadi_error("Unknown forward sensitivity method '" + sens + "'");
+        }
+      } else if (op.first=="batch_num_threads") {
+        batch_num_threads_ = op.second;
       }
     }
+    casadi_assert(batch_num_threads_>=0, "'batch_num_threads' must be nonnegative");
 
     // Number of finite elements and time steps
     casadi_assert_dev(nk_>0);
     h_ = (grid_.back() - grid_.front())/nk_;
+    if (max_checkpoints_<0) max_checkpoints_ = nk_;
+    casadi_assert(max_checkpoints_>0, "'max_checkpoints' must be positive");
 
     // Setup discrete time dynamics
     setupFG();
@@ -1059,6 +1099,12 @@ namespace casadi {
     // Get discrete time dimensions
     nZ_ = F_.nnz_in(DAE_Z);
     nRZ_ =  G_.is_null() ? 0 : G_.nnz_in(RDAE_RZ);
+
+    // Scalar discrete time dynamics for batched evaluation, if the DAE permits
+    F_batch_ = F_;
+    if (oracle_.is_a("SXFunction") && !F_.is_a("SXFunction")) {
+      F_batch_ = F_.expand(F_.name());
+    }
   }
 
   int FixedStepIntegrator::init_mem(void* mem) const {
@@ -1069,11 +1115,17 @@ namespace casadi {
     m->Z = DM::zeros(F_.sparsity_in(DAE_Z));
     m->RZ = G_.is_null() ? DM() : DM::zeros(G_.sparsity_in(RDAE_RZ));
 
-    // Allocate tape if backward states are present
-    if (nrx_>0) {
+    // Allocate tape or checkpoints if backward states are present
+    if (checkpointing()) {
+      m->cp_k.reserve(max_checkpoints_);
+      m->cp_x.resize(max_checkpoints_, vector<double>(nx_));
+      m->cp_Z.resize(max_checkpoints_, vector<double>(nZ_));
+    } else if (nrx_>0) {
       m->x_tape.resize(nk_+1, vector<double>(nx_));
       m->Z_tape.resize(nk_, vector<double>(nZ_));
     }
+    m->nrecompute = 0;
+    m->ncheckpoints = 0;
 
     // Allocate state
     m->x.resize(nx_);
@@ -1119,18 +1171,25 @@ namespace casadi {
     m->res[DAE_QUAD] = get_ptr(m->q);
 
     // Take time steps until end time has been reached
+    scoped_checkout<FunctionInternal> mem_F(F.get());
     while (m->k<k_out) {
+      // Checkpoint
+      if (checkpointing() && m->k==m->cp_next) {
+        add_checkpoint(m, m->k, get_ptr(m->x), m->Z.ptr());
+        m->cp_next = next_checkpoint(m->k, nk_, max_checkpoints_ - m->cp_k.size());
+      }
+
       // Update the previous step
       casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_prev));
       casadi_copy(get_ptr(m->Z), nZ_, get_ptr(m->Z_prev));
       casadi_copy(get_ptr(m->q), nq_, get_ptr(m->q_prev));
 
       // Take step
-      F(m->arg, m->res, m->iw, m->w, 0);
+      F(m->arg, m->res, m->iw, m->w, mem_F);
       casadi_axpy(nq_, 1., get_ptr(m->q_prev), get_ptr(m->q));
 
       // Tape
-      if (nrx_>0) {
+      if (nrx_>0 && !checkpointing()) {
         casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_tape.at(m->k+1)));
         casadi_copy(get_ptr(m->Z), m->Z.nnz(), get_ptr(m->Z_tape.at(m->k)));
       }
@@ -1173,6 +1232,7 @@ namespace casadi {
     m->res[RDAE_QUAD] = get_ptr(m->rq);
 
     // Take time steps until end time has been reached
+    scoped_checkout<FunctionInternal> mem_G(G.get());
     while (m->k>k_out) {
       // Advance time
       m->k--;
@@ -1183,10 +1243,55 @@ namespace casadi {
       casadi_copy(get_ptr(m->RZ), nRZ_, get_ptr(m->RZ_prev));
       casadi_copy(get_ptr(m->rq), nrq_, get_ptr(m->rq_prev));
 
+      // Forward solution at the step
+      const double *xk, *Zk;
+      if (checkpointing()) {
+        // Checkpoints after the step are no longer needed
+        casadi_assert_dev(!m->cp_k.empty());
+        while (m->cp_k.back()>m->k) m->cp_k.pop_back();
+
+        // Restore the last checkpoint
+        int j = m->cp_k.back();
+        casadi_copy(get_ptr(m->cp_x.at(m->cp_k.size()-1)), nx_, get_ptr(m->x_prev));
+        casadi_copy(get_ptr(m->cp_Z.at(m->cp_k.size()-1)), nZ_, get_ptr(m->Z_prev));
+
+        // Recompute up to the step, adding checkpoints on the way
+        while (j<m->k) {
+          int k_cp = next_checkpoint(j, m->k+1, max_checkpoints_ - m->cp_k.size());
+          k_cp = std::min(k_cp, m->k);
+          for (; j<k_cp; ++j) {
+            step_forward(m, j);
+            casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_prev));
+            casadi_copy(m->Z.ptr(), nZ_, get_ptr(m->Z_prev));
+          }
+          if (j<m->k) add_checkpoint(m, j, get_ptr(m->x_prev), get_ptr(m->Z_prev));
+        }
+
+        // Recompute the algebraic variables of the step
+        step_forward(m, m->k);
+        xk = get_ptr(m->x_prev);
+        Zk = m->Z.ptr();
+
+        // Restore the inputs of the backward dynamics
+        fill_n(m->arg, G.n_in(), nullptr);
+        m->arg[RDAE_T] = &m->t;
+        m->arg[RDAE_P] = get_ptr(m->p);
+        m->arg[RDAE_RX] = get_ptr(m->rx_prev);
+        m->arg[RDAE_RZ] = get_ptr(m->RZ_prev);
+        m->arg[RDAE_RP] = get_ptr(m->rp);
+        fill_n(m->res, G.n_out(), nullptr);
+        m->res[RDAE_ODE] = get_ptr(m->rx);
+        m->res[RDAE_ALG] = get_ptr(m->RZ);
+        m->res[RDAE_QUAD] = get_ptr(m->rq);
+      } else {
+        xk = get_ptr(m->x_tape.at(m->k));
+        Zk = get_ptr(m->Z_tape.at(m->k));
+      }
+
       // Take step
-      m->arg[RDAE_X] = get_ptr(m->x_tape.at(m->k));
-      m->arg[RDAE_Z] = get_ptr(m->Z_tape.at(m->k));
-      G(m->arg, m->res, m->iw, m->w, 0);
+      m->arg[RDAE_X] = xk;
+      m->arg[RDAE_Z] = Zk;
+      G(m->arg, m->res, m->iw, m->w, mem_G);
       casadi_axpy(nrq_, 1., get_ptr(m->rq_prev), get_ptr(m->rq));
     }
 
@@ -1221,11 +1326,220 @@ namespace casadi {
     casadi_fill(m->Z.ptr(), m->Z.nnz(), numeric_limits<double>::quiet_NaN());
 
     // Add the first element in the tape
-    if (nrx_>0) {
+    m->nrecompute = 0;
+    m->ncheckpoints = 0;
+    if (checkpointing()) {
+      // First checkpoint taken in advance, after derived classes have initialized Z
+      m->cp_k.clear();
+      m->cp_next = 0;
+    } else if (nrx_>0) {
       casadi_copy(x, nx_, get_ptr(m->x_tape.at(0)));
     }
   }
 
+  int FixedStepIntegrator::next_checkpoint(int j, int k, int n_free) const {
+    // With s free checkpoints and t recomputations of each step, the number of steps
+    // that can be reversed is binomial(s+t, s) (Griewank, 1992)
+    int l = k - j;
+    if (n_free<=0 || l<=1) return k;
+    int s = n_free;
+    // Smallest t such that binomial(s+t, s) >= l
+    int t = 0;
+    double beta = 1;
+    while (beta<l) {
+      t++;
+      beta = beta*(s+t)/t;
+    }
+    // The steps after the checkpoint are reversed with s-1 free checkpoints
+    double beta_after = 1;
+    for (int i=1; i<=t; ++i) beta_after = beta_after*(s-1+i)/i;
+    return k - static_cast<int>(std::min(beta_after, static_cast<double>(l-1)));
+  }
+
+  void FixedStepIntegrator::add_checkpoint(FixedStepMemory* m, int k, const double* x,
+                                           const double* Z) const {
+    int i = m->cp_k.size();
+    casadi_assert_dev(i<max_checkpoints_);
+    m->cp_k.push_back(k);
+    m->ncheckpoints = max(m->ncheckpoints, i+1);
+    casadi_copy(x, nx_, get_ptr(m->cp_x[i]));
+    casadi_copy(Z, nZ_, get_ptr(m->cp_Z[i]));
+  }
+
+  void FixedStepIntegrator::step_forward(FixedStepMemory* m, int k) const {
+    const Function& F = getExplicit();
+    double t = grid_.front() + k*h_;
+    fill_n(m->arg, F.n_in(), nullptr);
+    m->arg[DAE_T] = &t;
+    m->arg[DAE_X] = get_ptr(m->x_prev);
+    m->arg[DAE_Z] = get_ptr(m->Z_prev);
+    m->arg[DAE_P] = get_ptr(m->p);
+    fill_n(m->res, F.n_out(), nullptr);
+    m->res[DAE_ODE] = get_ptr(m->x);
+    m->res[DAE_ALG] = m->Z.ptr();
+    scoped_checkout<FunctionInternal> mem_F(F.get());
+    F(m->arg, m->res, m->iw, m->w, mem_F);
+    m->nrecompute++;
+  }
+
+  Dict FixedStepIntegrator::get_stats(void* mem) const {
+    Dict stats = Integrator::get_stats(mem);
+    auto m = static_cast<FixedStepMemory*>(mem);
+    stats["ncheckpoints"] = checkpointing() ? m->ncheckpoints : nrx_>0 ? nk_+1 : 0;
+    stats["nrecompute"] = m->nrecompute;
+    return stats;
+  }
+
+  int FixedStepIntegrator::batch_threads(int n) const {
+    int nt = batch_num_threads_>0 ? batch_num_threads_ : ThreadPool::instance().size();
+    return max(1, min(n, nt));
+  }
+
+  size_t FixedStepIntegrator::sz_w_batch(int n) const {
+    if (nrx_>0) return sz_w();
+    // States of all instances and work of the batched dynamics, for each thread
+    int nt = batch_threads(n);
+    int nb = (max(n, 1) + nt - 1)/nt;
+    size_t sz = nb*(1 + 2*nx_ + 2*nZ_ + 2*nq_ + np_) + F_batch_.sz_w_batch(nb);
+    return max(sz_w(), nt*sz);
+  }
+
+  int FixedStepIntegrator::eval_batch(const double** arg, double** res, int* iw, double* w,
+                                      void* mem, int n) const {
+    // Backward problem requires the tape of each instance
+    if (nrx_>0 || n<=1) return FunctionInternal::eval_batch(arg, res, iw, w, mem, n);
+    if (verbose_) casadi_message(name_ + "::eval_batch");
+    auto m = static_cast<FixedStepMemory*>(mem);
+    for (auto&& s : m->fstats) s.second.reset();
+    m->fstats.at(name_).tic();
+
+    // Explicit discrete time dynamics, evaluated for all instances of a thread at once
+    const Function& F = F_batch_;
+    size_t sz_arg, sz_res, sz_iw, sz_w;
+    F.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+
+    // Work vectors of each thread
+    int nt = batch_threads(n);
+    int nb = (n + nt - 1)/nt;
+    size_t sz_wt = nb*(1 + 2*nx_ + 2*nZ_ + 2*nq_ + np_) + F.sz_w_batch(nb);
+    vector<const double*> arg_t(nt*sz_arg);
+    vector<double*> res_t(nt*sz_res);
+    vector<int> iw_t(nt*sz_iw);
+
+    // Error flag for each thread
+    vector<int> flag(nt, 0);
+
+    // Propagate the instances begin, ..., end-1 of thread t
+    auto work = [&](int t) {
+      int begin = (t*n)/nt, end = ((t+1)*n)/nt, c = end - begin;
+      const double** arg1 = get_ptr(arg_t) + t*sz_arg;
+      double** res1 = get_ptr(res_t) + t*sz_res;
+      int* iw1 = get_ptr(iw_t) + t*sz_iw;
+      double* w1 = w + t*sz_wt;
+
+      // Memory objects of this thread
+      scoped_checkout<FunctionInternal> mem1(this);
+      auto m1 = static_cast<FixedStepMemory*>(memory(mem1));
+      scoped_checkout<FunctionInternal> mem_F(F.get());
+
+      // States of all instances stored consecutively, as for eval_batch
+      double* tt = w1; w1 += c;
+      double* x = w1; w1 += nx_*c;
+      double* x_prev = w1; w1 += nx_*c;
+      double* Z = w1; w1 += nZ_*c;
+      double* Z_prev = w1; w1 += nZ_*c;
+      double* q = w1; w1 += nq_*c;
+      double* q_prev = w1; w1 += nq_*c;
+      double* p = w1; w1 += np_*c;
+
+      // Initial conditions, with the initial guess for Z of each instance
+      const double* x0 = arg[INTEGRATOR_X0];
+      const double* z0 = arg[INTEGRATOR_Z0];
+      const double* p0 = arg[INTEGRATOR_P];
+      for (int i=0; i<c; ++i) {
+        int j = begin + i;
+        reset(m1, grid_.front(), x0 ? x0 + j*nx_ : 0, z0 ? z0 + j*nz_ : 0,
+              p0 ? p0 + j*np_ : 0);
+        casadi_copy(get_ptr(m1->x), nx_, x + i*nx_);
+        casadi_copy(m1->Z.ptr(), nZ_, Z + i*nZ_);
+        casadi_copy(get_ptr(m1->p), np_, p + i*np_);
+      }
+      casadi_fill(q, nq_*c, 0.);
+
+      // Outputs of the instances of this thread
+      double* xf = res[INTEGRATOR_XF];
+      double* zf = res[INTEGRATOR_ZF];
+      double* qf = res[INTEGRATOR_QF];
+
+      // Take time steps, storing the solution at the output times
+      int k = 0, kout = 0;
+      for (int g=0; g<grid_.size(); ++g) {
+        if (g==0 && !output_t0_) continue;
+        int k_out = std::ceil((grid_[g] - grid_.front())/h_);
+        k_out = std::min(k_out, nk_);
+        for (; k<k_out; ++k) {
+          // Update the previous step
+          casadi_fill(tt, c, grid_.front() + k*h_);
+          casadi_copy(x, nx_*c, x_prev);
+          casadi_copy(Z, nZ_*c, Z_prev);
+          casadi_copy(q, nq_*c, q_prev);
+
+          // Take the step for all instances
+          fill_n(arg1, F.n_in(), nullptr);
+          arg1[DAE_T] = tt;
+          arg1[DAE_X] = x_prev;
+          arg1[DAE_Z] = Z_prev;
+          arg1[DAE_P] = p;
+          fill_n(res1, F.n_out(), nullptr);
+          res1[DAE_ODE] = x;
+          res1[DAE_ALG] = Z;
+          res1[DAE_QUAD] = q;
+          if (F.eval_batch(arg1, res1, iw1, w1, c, mem_F)) {
+            flag[t] = 1;
+            return;
+          }
+          casadi_axpy(nq_*c, 1., q_prev, q);
+        }
+
+        // Store the solution at the output time
+        for (int i=0; i<c; ++i) {
+          int j = begin + i;
+          if (xf) casadi_copy(x + i*nx_, nx_, xf + (j*ntout_ + kout)*nx_);
+          if (zf) casadi_copy(Z + (i+1)*nZ_ - nz_, nz_, zf + (j*ntout_ + kout)*nz_);
+          if (qf) casadi_copy(q + i*nq_, nq_, qf + (j*ntout_ + kout)*nq_);
+        }
+        kout++;
+      }
+    };
+
+    // Propagate the trajectories in parallel
+    ThreadPool::instance().run(nt, work);
+
+    // No backward problem
+    for (int i=INTEGRATOR_RXF; i<INTEGRATOR_NUM_OUT; ++i) {
+      casadi_fill(res[i], n*nnz_out(i), 0.);
+    }
+    m->fstats.at(name_).toc();
+    if (print_time_) print_fstats(m);
+
+    // Return error flag
+    for (int f : flag) if (f) return 1;
+    return 0;
+  }
+
+  Function FixedStepIntegrator::
+  get_forward(int nfwd, const std::string& name,
+              const std::vector<std::string>& inames,
+              const std::vector<std::string>& onames,
+              const Dict& opts) const {
+    // Augmented DAE unless staggered direct method
+    if (!staggered_ || nrx_>0) {
+      return Integrator::get_forward(nfwd, name, inames, onames, opts);
+    }
+    if (verbose_) casadi_message(name_ + "::get_forward (staggered)");
+    return Function::create(new FixedStepForward(name, nfwd), opts);
+  }
+
   void FixedStepIntegrator::resetB(IntegratorMemory* mem, double t, const double* rx,
                                    const double* rz, const double* rp) const {
     auto m = static_cast<FixedStepMemory*>(mem);
@@ -1294,6 +1608,7 @@ namespace casadi {
     rootfinder_ = rootfinder(name_ + "_rootfinder", implicit_function_name,
                                   F_, rootfinder_options);
     alloc(rootfinder_);
+    F_batch_ = rootfinder_;
 
     // Allocate a root-finding solver for the backward problem
     if (nRZ_>0) {
@@ -1312,6 +1627,225 @@ namespace casadi {
     }
   }
 
+  FixedStepForward::FixedStepForward(const std::string& name, int nfwd)
+    : FunctionInternal(name), nfwd_(nfwd), f_(0), implicit_(false) {
+  }
+
+  FixedStepForward::~FixedStepForward() {
+    clear_mem();
+  }
+
+  Sparsity FixedStepForward::get_sparsity_in(int i) {
+    if (i<INTEGRATOR_NUM_IN) {
+      // Non-differentiated input
+      return derivative_of_.sparsity_in(i);
+    } else if (i<INTEGRATOR_NUM_IN+INTEGRATOR_NUM_OUT) {
+      // Non-differentiated output
+      return derivative_of_.sparsity_out(i-INTEGRATOR_NUM_IN);
+    } else {
+      // Forward seeds
+      return repmat(derivative_of_.sparsity_in(i-INTEGRATOR_NUM_IN-INTEGRATOR_NUM_OUT),
+                    1, nfwd_);
+    }
+  }
+
+  Sparsity FixedStepForward::get_sparsity_out(int i) {
+    return repmat(derivative_of_.sparsity_out(i), 1, nfwd_);
+  }
+
+  std::string FixedStepForward::get_name_in(int i) {
+    if (i<INTEGRATOR_NUM_IN) {
+      return derivative_of_.name_in(i);
+    } else if (i<INTEGRATOR_NUM_IN+INTEGRATOR_NUM_OUT) {
+      return "out_" + derivative_of_.name_out(i-INTEGRATOR_NUM_IN);
+    } else {
+      return "fwd_" + derivative_of_.name_in(i-INTEGRATOR_NUM_IN-INTEGRATOR_NUM_OUT);
+    }
+  }
+
+  std::string FixedStepForward::get_name_out(int i) {
+    return "fwd_" + derivative_of_.name_out(i);
+  }
+
+  void FixedStepForward::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    FunctionInternal::init(opts);
+
+    // Get the differentiated integrator
+    f_ = derivative_of_.get<FixedStepIntegrator>();
+    casadi_assert(f_!=0, "FixedStepForward requires a fixed step integrator");
+    casadi_assert_dev(f_->nrx_==0);
+    implicit_ = dynamic_cast<const ImplicitFixedStepIntegrator*>(f_)!=0;
+
+    // Functions for the sensitivity equations of a step
+    fwd_ = f_->F_.forward(nfwd_);
+    alloc(f_->getExplicit());
+    alloc(fwd_);
+    if (implicit_ && f_->nZ_>0) {
+      jac_ = f_->F_.jacobian_old(DAE_Z, DAE_ALG);
+      alloc(jac_);
+
+      // Same linear solver as the rootfinder, if any
+      string linear_solver = "csparse";
+      const Rootfinder* rf = f_->getExplicit().get<Rootfinder>();
+      if (rf && !rf->linsol_.is_null()) linear_solver = rf->linsol_.plugin_name();
+      linsol_ = Linsol(name_ + "_linsol", linear_solver, jac_.sparsity_out(0));
+    }
+
+    // Current and previous state with sensitivities, quadratures, algebraic variables
+    int nx = f_->nx_, nZ = f_->nZ_, nq = f_->nq_, np = f_->np_;
+    alloc_w(2*nx*(1+nfwd_) + nZ*(2+nfwd_) + 2*nq*(1+nfwd_) + np*(1+nfwd_), true);
+    alloc_w(nx*nfwd_ + nZ*nfwd_ + nq*nfwd_, true);
+    if (!jac_.is_null()) alloc_w(jac_.nnz_out(0), true);
+  }
+
+  int FixedStepForward::eval(const double** arg, double** res, int* iw, double* w,
+                             void* mem) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+    int nx = f_->nx_, nz = f_->nz_, nq = f_->nq_, np = f_->np_, nZ = f_->nZ_;
+    int ntout = f_->ntout_;
+    const vector<double>& grid = f_->grid_;
+
+    // Nondifferentiated inputs and forward seeds
+    const double* x0 = arg[INTEGRATOR_X0];
+    const double* z0 = arg[INTEGRATOR_Z0];
+    const double* p = arg[INTEGRATOR_P];
+    const double** seed = arg + INTEGRATOR_NUM_IN + INTEGRATOR_NUM_OUT;
+
+    // Forward sensitivities, direction d of output k at d*ntout*n + k*n
+    double* fwd_xf = res[INTEGRATOR_XF];
+    double* fwd_zf = res[INTEGRATOR_ZF];
+    double* fwd_qf = res[INTEGRATOR_QF];
+    for (int i=INTEGRATOR_RXF; i<INTEGRATOR_NUM_OUT; ++i) {
+      casadi_fill(res[i], nfwd_*nnz_out(i), 0.);
+    }
+
+    // Work vectors: states and sensitivities stored as [nominal, dir 0, dir 1, ...]
+    double *x = w; w += nx*(1+nfwd_);
+    double *x_prev = w; w += nx*(1+nfwd_);
+    double *Z = w; w += nZ*(1+nfwd_);
+    double *Z_prev = w; w += nZ;
+    double *q = w; w += nq*(1+nfwd_);
+    double *q_prev = w; w += nq*(1+nfwd_);
+    double *pp = w; w += np*(1+nfwd_);
+    double *tmp_x = w; w += nx*nfwd_;
+    double *tmp_Z = w; w += nZ*nfwd_;
+    double *tmp_q = w; w += nq*nfwd_;
+    double *J = 0;
+    if (!jac_.is_null()) {
+      J = w;
+      w += jac_.nnz_out(0);
+    }
+    arg += n_in_;
+    res += n_out_;
+
+    // Initial conditions, with the initial guess for Z from the integrator
+    f_->reset(m, grid.front(), x0, z0, p);
+    casadi_copy(get_ptr(m->x), nx, x);
+    casadi_copy(m->Z.ptr(), nZ, Z);
+    casadi_fill(q, nq*(1+nfwd_), 0.);
+    casadi_copy(p, np, pp);
+    casadi_copy(seed[INTEGRATOR_X0], nx*nfwd_, x + nx);
+    casadi_copy(seed[INTEGRATOR_P], np*nfwd_, pp + np);
+    casadi_fill(Z + nZ, nZ*nfwd_, 0.);
+
+    // Nominal discrete time dynamics
+    const Function& F = f_->getExplicit();
+
+    // Memory objects of the nested functions, held for the duration of the call
+    scoped_checkout<FunctionInternal> mem_F(F.get()), mem_fwd(fwd_.get());
+
+    // Take time steps, storing the solution at the output times
+    int k = 0, kout = 0;
+    for (int g=0; g<grid.size(); ++g) {
+      if (g==0 && !f_->output_t0_) continue;
+
+      // Discrete time sought
+      int k_out = std::ceil((grid[g] - grid.front())/f_->h_);
+      k_out = std::min(k_out, f_->nk_);
+      for (; k<k_out; ++k) {
+        double t = grid.front() + k*f_->h_;
+
+        // Update the previous step
+        casadi_copy(x, nx*(1+nfwd_), x_prev);
+        casadi_copy(Z, nZ, Z_prev);
+        casadi_copy(q, nq*(1+nfwd_), q_prev);
+
+        // Nominal step
+        fill_n(arg, F.n_in(), nullptr);
+        arg[DAE_T] = &t;
+        arg[DAE_X] = x_prev;
+        arg[DAE_Z] = Z_prev;
+        arg[DAE_P] = pp;
+        fill_n(res, F.n_out(), nullptr);
+        res[DAE_ODE] = x;
+        res[DAE_ALG] = Z;
+        res[DAE_QUAD] = q;
+        if (F(arg, res, iw, w, mem_F)) return 1;
+        casadi_axpy(nq, 1., q_prev, q);
+
+        // Directional derivatives with respect to the states and parameters, all directions
+        fill_n(arg, fwd_.n_in(), nullptr);
+        arg[DAE_T] = &t;
+        arg[DAE_X] = x_prev;
+        arg[DAE_Z] = Z;
+        arg[DAE_P] = pp;
+        arg[DAE_NUM_IN + DAE_NUM_OUT + DAE_X] = x_prev + nx;
+        arg[DAE_NUM_IN + DAE_NUM_OUT + DAE_P] = pp + np;
+        fill_n(res, fwd_.n_out(), nullptr);
+        res[DAE_ODE] = x + nx;
+        res[DAE_ALG] = implicit_ ? tmp_Z : Z + nZ;
+        res[DAE_QUAD] = tmp_q;
+        if (fwd_(arg, res, iw, w, mem_fwd)) return 1;
+        casadi_axpy(nq*nfwd_, 1., tmp_q, q + nq);
+
+        // Implicit scheme: sensitivities of Z from the linearized residual
+        if (!jac_.is_null()) {
+          scoped_checkout<FunctionInternal> mem_jac(jac_.get());
+          scoped_checkout<Linsol> mem_linsol(&linsol_);
+
+          // Jacobian at the nominal solution, factorized once for all directions
+          fill_n(arg, jac_.n_in(), nullptr);
+          arg[DAE_T] = &t;
+          arg[DAE_X] = x_prev;
+          arg[DAE_Z] = Z;
+          arg[DAE_P] = pp;
+          fill_n(res, jac_.n_out(), nullptr);
+          res[0] = J;
+          if (jac_(arg, res, iw, w, mem_jac)) return 1;
+          if (linsol_.nfact(J, mem_linsol)) return 1;
+
+          // Solve for all directions as a multiple right-hand-side system
+          for (int i=0; i<nZ*nfwd_; ++i) Z[nZ+i] = -tmp_Z[i];
+          if (linsol_.solve(J, Z + nZ, nfwd_, false, mem_linsol)) return 1;
+
+          // Contribution of the sensitivities of Z
+          fill_n(arg, fwd_.n_in(), nullptr);
+          arg[DAE_T] = &t;
+          arg[DAE_X] = x_prev;
+          arg[DAE_Z] = Z;
+          arg[DAE_P] = pp;
+          arg[DAE_NUM_IN + DAE_NUM_OUT + DAE_Z] = Z + nZ;
+          fill_n(res, fwd_.n_out(), nullptr);
+          res[DAE_ODE] = tmp_x;
+          res[DAE_QUAD] = tmp_q;
+          if (fwd_(arg, res, iw, w, mem_fwd)) return 1;
+          casadi_axpy(nx*nfwd_, 1., tmp_x, x + nx);
+          casadi_axpy(nq*nfwd_, 1., tmp_q, q + nq);
+        }
+      }
+
+      // Store the sensitivities at the output time
+      for (int d=0; d<nfwd_; ++d) {
+        if (fwd_xf) casadi_copy(x + nx*(1+d), nx, fwd_xf + (d*ntout + kout)*nx);
+        if (fwd_zf) casadi_copy(Z + nZ*(1+d) + nZ - nz, nz, fwd_zf + (d*ntout + kout)*nz);
+        if (fwd_qf) casadi_copy(q + nq*(1+d), nq, fwd_qf + (d*ntout + kout)*nq);
+      }
+      kout++;
+    }
+    return 0;
+  }
+
   template<typename XType>
   Function Integrator::map2oracle(const std::string& name,
     const std::map<std::string, XType>& d, const Dict& opts) {
@@ -1392,4 +1926,9 @@ namespace casadi {
     return Function(name, de_in, de_out, DE_INPUTS, DE_OUTPUTS, opts);
   }
 
+  void Integrator::serialize_body(SerializingStream& s) const {
+    s.pack(std::string(plugin_name()));
+    OracleFunction::serialize_body(s);
+  }
+
 } // namespace casadi
@@ -29,6 +29,7 @@
 #include "integrator.hpp"
 #include "oracle_function.hpp"
 #include "plugin_interface.hpp"
+#include "linsol.hpp"
 
 /// \cond INTERNAL
 
@@ -80,6 +81,15 @@ namespace casadi {
     const Options& get_options() const override { return options_;}
     ///@}
 
+    /** \brief Class name identifying the deserializer */
+    std::string serialize_class() const override { return "Integrator";}
+
+    /** \brief Serialize the plugin name followed by the oracle */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize, instantiating the plugin */
+    static Function deserialize(DeserializingStream& s) { return deserialize_plugin<Integrator>(s);}
+
     /** \brief  Initialize */
     void init(const Dict& opts) override;
 
@@ -237,6 +247,19 @@ namespace casadi {
 
     // Tape
     std::vector<std::vector<double> > x_tape, Z_tape;
+
+    // Checkpoints: discrete time, state and previous algebraic variables
+    std::vector<int> cp_k;
+    std::vector<std::vector<double> > cp_x, cp_Z;
+
+    // Discrete time of the next checkpoint in the forward integration
+    int cp_next;
+
+    // Largest number of checkpoints stored at the same time
+    int ncheckpoints;
+
+    // Number of recomputed steps
+    int nrecompute;
   };
 
   class CASADI_EXPORT FixedStepIntegrator : public Integrator {
@@ -285,6 +308,45 @@ namespace casadi {
     void retreat(IntegratorMemory* mem, double t,
                          double* rx, double* rz, double* rq) const override;
 
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Evaluate n instances, propagating all trajectories together
+
+        The states of all instances are advanced one step at a time, with a single
+        batched call of the discrete time dynamics per step, and the instances are
+        distributed over "batch_num_threads" threads. Problems with backward states
+        are evaluated one instance at a time.
+    */
+    int eval_batch(const double** arg, double** res, int* iw, double* w,
+                   void* mem, int n) const override;
+
+    /** \brief Size of the work vector for eval_batch */
+    size_t sz_w_batch(int n) const override;
+
+    /// Number of threads used by eval_batch for n instances
+    int batch_threads(int n) const;
+
+    ///@{
+    /** \brief Generate a function that calculates \a nfwd forward derivatives */
+    Function get_forward(int nfwd, const std::string& name,
+                         const std::vector<std::string>& inames,
+                         const std::vector<std::string>& onames,
+                         const Dict& opts) const override;
+    ///@}
+
+    /// Is the forward solution stored at checkpoints only?
+    bool checkpointing() const { return nrx_>0 && max_checkpoints_<nk_;}
+
+    /// Discrete time of the next checkpoint, binomial schedule for reversing steps j..k-1
+    int next_checkpoint(int j, int k, int n_free) const;
+
+    /// Store a checkpoint
+    void add_checkpoint(FixedStepMemory* m, int k, const double* x, const double* Z) const;
+
+    /// Take a forward step from x_prev, Z_prev to x, Z, without quadratures
+    void step_forward(FixedStepMemory* m, int k) const;
+
     /// Get explicit dynamics
     virtual const Function& getExplicit() const { return F_;}
 
@@ -294,14 +356,26 @@ namespace casadi {
     // Discrete time dynamics
     Function F_, G_;
 
+    // Explicit discrete time dynamics used by eval_batch
+    Function F_batch_;
+
     // Number of finite elements
     int nk_;
 
+    // Maximum number of states stored for the backward integration
+    int max_checkpoints_;
+
     // Time step size
     double h_;
 
     /// Number of algebraic variables for the discrete time integration
     int nZ_, nRZ_;
+
+    /// Forward sensitivities by the staggered direct method
+    bool staggered_;
+
+    /// Maximum number of threads used by eval_batch
+    int batch_num_threads_;
   };
 
   class CASADI_EXPORT ImplicitFixedStepIntegrator : public FixedStepIntegrator {
@@ -332,6 +406,80 @@ namespace casadi {
     Function rootfinder_, backward_rootfinder_;
   };
 
+  /** \brief Forward sensitivities of a fixed step integrator, staggered direct method
+
+      The nominal solution is advanced one step at a time as in the integrator
+      itself. After each step, all forward directions are propagated through the
+      step as one block: For implicit schemes, the Jacobian of the step residual
+      with respect to the discrete time algebraic variables is factorized once at
+      the converged nominal solution and the sensitivity equations of all directions
+      are solved with this factorization as a multiple right-hand-side system.
+      Unlike the default approach, the nominal states are not integrated again as
+      part of an augmented DAE and the enlarged augmented Newton systems are avoided.
+  */
+  class CASADI_EXPORT FixedStepForward : public FunctionInternal {
+  public:
+    // Constructor
+    FixedStepForward(const std::string& name, int nfwd);
+
+    /** \brief Destructor */
+    ~FixedStepForward() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "FixedStepForward";}
+
+    /// @{
+    /** \brief Sparsities of function inputs and outputs */
+    Sparsity get_sparsity_in(int i) override;
+    Sparsity get_sparsity_out(int i) override;
+    /// @}
+
+    ///@{
+    /** \brief Number of function inputs and outputs */
+    size_t get_n_in() override { return 2*INTEGRATOR_NUM_IN + INTEGRATOR_NUM_OUT;}
+    size_t get_n_out() override { return INTEGRATOR_NUM_OUT;}
+    ///@}
+
+    ///@{
+    /** \brief Names of function input and outputs */
+    std::string get_name_in(int i) override;
+    std::string get_name_out(int i) override;
+    ///@}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block, same as for the integrator */
+    void* alloc_mem() const override { return f_->alloc_mem();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override { return f_->init_mem(mem);}
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { f_->free_mem(mem);}
+
+    /// Evaluate numerically
+    int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
+
+    /// Number of directions
+    int nfwd_;
+
+    /// Differentiated integrator
+    const FixedStepIntegrator* f_;
+
+    /// Implicit discrete time dynamics?
+    bool implicit_;
+
+    /// Forward derivatives of the discrete time dynamics
+    Function fwd_;
+
+    /// Jacobian of the discrete time residual with respect to the algebraic variables
+    Function jac_;
+
+    /// Linear solver for the sensitivity equations of implicit schemes
+    Linsol linsol_;
+  };
+
 } // namespace casadi
 /// \endcond
 
@@ -26,6 +26,7 @@
 #include "interpolant_impl.hpp"
 #include "casadi_misc.hpp"
 #include "mx_node.hpp"
+#include "serializing_stream.hpp"
 #include <typeinfo>
 
 using namespace std;
@@ -121,4 +122,27 @@ namespace casadi {
 
   const std::string Interpolant::infix_ = "interpolant";
 
+  void Interpolant::serialize_body(SerializingStream& s) const {
+    s.pack(std::string(plugin_name()));
+    s.pack(name_);
+    s.pack(grid_);
+    s.pack(offset_);
+    s.pack(values_);
+    s.pack(construct_opts_);
+  }
+
+  Function Interpolant::deserialize(DeserializingStream& s) {
+    std::string plugin, name;
+    std::vector<double> grid, values;
+    std::vector<int> offset;
+    Dict opts;
+    s.unpack(plugin);
+    s.unpack(name);
+    s.unpack(grid);
+    s.unpack(offset);
+    s.unpack(values);
+    s.unpack(opts);
+    return Function::create(getPlugin(plugin).creator(name, grid, offset, values), opts);
+  }
+
 } // namespace casadi
@@ -67,6 +67,15 @@ namespace casadi {
     std::string get_name_out(int i) override;
     /// @}
 
+    /** \brief Class name identifying the deserializer */
+    std::string serialize_class() const override { return "Interpolant";}
+
+    /** \brief Serialize the plugin name followed by the grid and values */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize, instantiating the plugin */
+    static Function deserialize(DeserializingStream& s);
+
     // Creator function for internal class
     typedef Interpolant* (*Creator)(const std::string& name,
                                     const std::vector<double>& grid,
@@ -24,6 +24,7 @@
 
 
 #include "inverse.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -61,4 +62,7 @@ namespace casadi {
     }
   }
 
+  void Inverse::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
@@ -122,7 +122,7 @@ namespace casadi {
 
     // Perform pivoting, if required
     if (!m->is_sfact) {
-      if (sfact(A)) return 1;
+      if (sfact(A, mem)) return 1;
     }
 
     m->is_nfact = false;
@@ -153,12 +153,24 @@ namespace casadi {
     return (*this)->rank((*this)->memory(mem), A);
   }
 
+  Dict Linsol::stats(int mem) const {
+    return (*this)->get_stats((*this)->memory(mem));
+  }
+
   int Linsol::solve(const double* A, double* x, int nrhs, bool tr, int mem) const {
     auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
     casadi_assert(m->is_nfact, "Linear system has not been factorized");
     return (*this)->solve(m, A, x, nrhs, tr);
   }
 
+  int Linsol::checkout() const {
+    return (*this)->checkout();
+  }
+
+  void Linsol::release(int mem) const {
+    (*this)->release(mem);
+  }
+
   bool has_linsol(const string& name) {
     return Linsol::has_plugin(name);
   }
@@ -106,6 +106,9 @@ namespace casadi {
       */
     int rank(const DM& A) const;
 
+    /** \brief Get all statistics obtained at the end of the last factorization */
+    Dict stats(int mem=0) const;
+
     #ifndef SWIG
     ///@{
     /// Low-level API
@@ -115,6 +118,12 @@ namespace casadi {
     int neig(const double* A, int mem=0) const;
     int rank(const double* A, int mem=0) const;
     ///@}
+
+    /// Checkout a memory object, e.g. for solving in parallel
+    int checkout() const;
+
+    /// Release a memory object
+    void release(int mem) const;
     #endif // SWIG
   };
 
@@ -106,6 +106,9 @@ namespace casadi {
     virtual void generate(CodeGenerator& g, const std::string& A, const std::string& x,
                           int nrhs, bool tr) const;
 
+    /// Get all statistics
+    virtual Dict get_stats(void* mem) const { return Dict();}
+
     // Creator function for internal class
     typedef LinsolInternal* (*Creator)(const std::string& name, const Sparsity& sp);
 
@@ -24,23 +24,52 @@
 
 
 #include "map.hpp"
+#include "thread_pool.hpp"
+#include "serializing_stream.hpp"
+
+#ifdef WITH_THREAD
+#include <mutex>
+#include <memory>
+#endif // WITH_THREAD
 
 using namespace std;
 
 namespace casadi {
 
-  Function Map::create(const std::string& parallelization, const Function& f, int n) {
+  Function Map::create(const std::string& parallelization, const Function& f, int n,
+                       const Dict& opts) {
     // Create instance of the right class
     string name = f.name() + "_" + str(n);
     if (parallelization == "serial") {
-      return Function::create(new Map(name, f, n), Dict());
+      return Function::create(new Map(name, f, n), opts);
     } else if (parallelization== "openmp") {
-      return Function::create(new MapOmp(name, f, n), Dict());
+      return Function::create(new MapOmp(name, f, n), opts);
+    } else if (parallelization== "thread") {
+      return Function::create(new MapThread(name, f, n), opts);
     } else {
       casadi_error("Unknown parallelization: " + parallelization);
     }
   }
 
+  void Map::serialize_body(SerializingStream& s) const {
+    s.pack(parallelization());
+    s.pack(f_);
+    s.pack(n_);
+    s.pack(construct_opts_);
+  }
+
+  Function Map::deserialize(DeserializingStream& s) {
+    string parallelization;
+    Function f;
+    int n;
+    Dict opts;
+    s.unpack(parallelization);
+    s.unpack(f);
+    s.unpack(n);
+    s.unpack(opts);
+    return create(parallelization, f, n, opts);
+  }
+
   Map::Map(const std::string& name, const Function& f, int n)
     : FunctionInternal(name), f_(f), n_(n) {
   }
@@ -55,7 +84,7 @@ namespace casadi {
     // Allocate sufficient memory for serial evaluation
     alloc_arg(f_.sz_arg());
     alloc_res(f_.sz_res());
-    alloc_w(f_.sz_w());
+    alloc_w(f_->sz_w_batch(n_));
     alloc_iw(f_.sz_iw());
   }
 
@@ -65,8 +94,9 @@ namespace casadi {
     copy_n(arg, n_in_, arg1);
     T** res1 = res+n_out_;
     copy_n(res, n_out_, res1);
+    scoped_checkout<FunctionInternal> mem_f(f_.get());
     for (int i=0; i<n_; ++i) {
-      if (f_(arg1, res1, iw, w)) return 1;
+      if (f_(arg1, res1, iw, w, mem_f)) return 1;
       for (int j=0; j<n_in_; ++j) {
         if (arg1[j]) arg1[j] += f_.nnz_in(j);
       }
@@ -231,7 +261,13 @@ namespace casadi {
   }
 
   int Map::eval(const double** arg, double** res, int* iw, double* w, void* mem) const {
-    return eval_gen(arg, res, iw, w);
+    const double** arg1 = arg+n_in_;
+    copy_n(arg, n_in_, arg1);
+    double** res1 = res+n_out_;
+    copy_n(res, n_out_, res1);
+    // Let the function evaluate all instances at once
+    scoped_checkout<FunctionInternal> mem_f(f_.get());
+    return f_->eval_batch(arg1, res1, iw, w, f_.memory(mem_f), n_);
   }
 
   MapOmp::~MapOmp() {
@@ -315,4 +351,140 @@ namespace casadi {
     alloc_iw(f_.sz_iw() * n_);
   }
 
+  Options MapThread::options_
+  = {{&FunctionInternal::options_},
+     {{"max_num_threads",
+       {OT_INT,
+        "Maximum number of threads used for the evaluation [default: number of cores]"}},
+      {"chunk_size",
+       {OT_INT,
+        "Number of evaluations a thread claims at a time [default: automatic]"}}
+     }
+  };
+
+  MapThread::~MapThread() {
+  }
+
+  void MapThread::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    Map::init(opts);
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="max_num_threads") {
+        max_num_threads_ = op.second;
+      } else if (op.first=="chunk_size") {
+        chunk_size_ = op.second;
+      }
+    }
+    casadi_assert(max_num_threads_>=0, "Option 'max_num_threads' must be nonnegative");
+    casadi_assert(chunk_size_>=0, "Option 'chunk_size' must be nonnegative");
+
+    // Number of threads actually used
+    num_threads_ = max_num_threads_>0 ? max_num_threads_ : ThreadPool::instance().size();
+    num_threads_ = min(n_, num_threads_);
+
+    // Allocate sufficient memory for each thread
+    alloc_arg(f_.sz_arg() * num_threads_);
+    alloc_res(f_.sz_res() * num_threads_);
+    alloc_w(f_.sz_w() * num_threads_);
+    alloc_iw(f_.sz_iw() * num_threads_);
+  }
+
+  int MapThread::eval(const double** arg, double** res, int* iw, double* w, void* mem) const {
+#ifndef WITH_THREAD
+    return Map::eval(arg, res, iw, w, mem);
+#else // WITH_THREAD
+    // Quick return if serial
+    if (num_threads_==1) return Map::eval(arg, res, iw, w, mem);
+
+    size_t sz_arg, sz_res, sz_iw, sz_w;
+    f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
+
+    // Evaluations not yet claimed, initially evenly distributed over the threads
+    struct Range {
+      mutex mtx;
+      int begin, end;
+    };
+    unique_ptr<Range[]> todo(new Range[num_threads_]);
+    for (int t=0; t<num_threads_; ++t) {
+      todo[t].begin = (t*n_)/num_threads_;
+      todo[t].end = ((t+1)*n_)/num_threads_;
+    }
+
+    // Number of evaluations claimed at a time
+    int chunk = chunk_size_>0 ? chunk_size_ : max(1, n_/(8*num_threads_));
+
+    // Claim the next chunk for thread t, stealing from other threads if needed
+    auto claim = [&](int t, int& begin, int& end) {
+      while (true) {
+        // Take a chunk from the front of the own range
+        {
+          lock_guard<mutex> lock(todo[t].mtx);
+          if (todo[t].begin<todo[t].end) {
+            begin = todo[t].begin;
+            end = min(begin+chunk, todo[t].end);
+            todo[t].begin = end;
+            return true;
+          }
+        }
+        // Steal the back half of the remaining range of another thread
+        bool stolen = false;
+        for (int k=1; k<num_threads_ && !stolen; ++k) {
+          Range& r = todo[(t+k) % num_threads_];
+          lock_guard<mutex> lock(r.mtx);
+          int rem = r.end - r.begin;
+          if (rem>0) {
+            begin = r.end - (rem+1)/2;
+            end = r.end;
+            r.end = begin;
+            stolen = true;
+          }
+        }
+        if (!stolen) return false;
+        // Make it the own range
+        lock_guard<mutex> lock(todo[t].mtx);
+        todo[t].begin = begin;
+        todo[t].end = end;
+      }
+    };
+
+    // Error flag for each thread
+    vector<int> flag(num_threads_, 0);
+
+    // Work performed by each thread
+    auto work = [&](int t) {
+      // Work vectors and memory object of this thread
+      const double** arg1 = arg + n_in_ + t*sz_arg;
+      double** res1 = res + n_out_ + t*sz_res;
+      int* iw1 = iw + t*sz_iw;
+      double* w1 = w + t*sz_w;
+      scoped_checkout<FunctionInternal> m(f_.get());
+
+      int begin, end;
+      while (!flag[t] && claim(t, begin, end)) {
+        for (int i=begin; i<end; ++i) {
+          for (int j=0; j<n_in_; ++j) {
+            arg1[j] = arg[j] ? arg[j] + i*f_.nnz_in(j) : 0;
+          }
+          for (int j=0; j<n_out_; ++j) {
+            res1[j] = res[j] ? res[j] + i*f_.nnz_out(j) : 0;
+          }
+          if (f_(arg1, res1, iw1, w1, m)) {
+            flag[t] = 1;
+            break;
+          }
+        }
+      }
+    };
+
+    // Evaluate in parallel
+    ThreadPool::instance().run(num_threads_, work);
+
+    // Return error flag
+    for (int f : flag) if (f) return 1;
+    return 0;
+#endif // WITH_THREAD
+  }
+
 } // namespace casadi
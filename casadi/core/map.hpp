@@ -40,7 +40,7 @@ namespace casadi {
   public:
     // Create function (use instead of constructor)
     static Function create(const std::string& parallelization,
-                           const Function& f, int n);
+                           const Function& f, int n, const Dict& opts=Dict());
 
     /** \brief Destructor */
     ~Map() override;
@@ -131,6 +131,15 @@ namespace casadi {
     /** Obtain information about node */
     Dict info() const override { return {{"f", f_}, {"n", n_}}; }
 
+    /** \brief Class name identifying the deserializer */
+    std::string serialize_class() const override { return "Map";}
+
+    /** \brief Serialize the mapped function and the parallelization */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize, recreating the map */
+    static Function deserialize(DeserializingStream& s);
+
   protected:
     // Constructor (protected, use create function)
     Map(const std::string& name, const Function& f, int n);
@@ -174,6 +183,55 @@ namespace casadi {
     void codegen_body(CodeGenerator& g) const override;
   };
 
+  /** A map Evaluate in parallel using a persistent pool of threads
+      Each thread owns a contiguous range of the evaluations and works through it
+      in chunks. A thread which runs out of work steals half of the remaining range
+      of another thread. Work vectors are only allocated for each thread, not for
+      each evaluation.
+  */
+  class CASADI_EXPORT MapThread : public Map {
+    friend class Map;
+  protected:
+    // Constructor (protected, use create function in Map)
+    MapThread(const std::string& name, const Function& f, int n)
+      : Map(name, f, n), max_num_threads_(0), num_threads_(1), chunk_size_(0) {}
+
+    /** \brief  Destructor */
+    ~MapThread() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "MapThread";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /// Type of parallellization
+    std::string parallelization() const override { return "thread"; }
+
+    /** Obtain information about node */
+    Dict info() const override {
+      return {{"f", f_}, {"n", n_}, {"num_threads", num_threads_}};
+    }
+
+    // Maximum number of threads, 0 for all threads of the pool
+    int max_num_threads_;
+
+    // Number of threads used for evaluation
+    int num_threads_;
+
+    // Number of evaluations claimed at a time, 0 for automatic
+    int chunk_size_;
+  };
+
 } // namespace casadi
 /// \endcond
 
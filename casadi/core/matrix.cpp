@@ -25,6 +25,8 @@
 #define CASADI_MATRIX_CPP
 #include "sx_function.hpp"
 #include "sx_node.hpp"
+#include "unary_sx.hpp"
+#include "binary_sx.hpp"
 #include "linsol.hpp"
 #include "expm.hpp"
 #include <chrono>
@@ -1978,7 +1980,7 @@ namespace casadi {
     int n=A.size1();
 
     // Calculate entries in L and D
-    vector<int> iw(2*n);
+    vector<int> iw(3*n);
     vector<Scalar> D_nz(n), L_nz(L_sp.nnz()), w(n);
     casadi_ldl(A.sparsity(), get_ptr(parent), L_sp, get_ptr(A.nonzeros()),
                get_ptr(L_nz), get_ptr(D_nz), get_ptr(iw), get_ptr(w));
@@ -2418,6 +2420,16 @@ namespace casadi {
     casadi_error("'substitute_inplace' not defined for " + type_name());
   }
 
+  template<typename Scalar>
+  Matrix<Scalar> Matrix<Scalar>::cse(const Matrix<Scalar>& e) {
+    return e;
+  }
+
+  template<typename Scalar>
+  std::vector<Matrix<Scalar> > Matrix<Scalar>::cse(const std::vector<Matrix<Scalar> >& e) {
+    return e;
+  }
+
   template<typename Scalar>
   bool Matrix<Scalar>::depends_on(const Matrix<Scalar> &x, const Matrix<Scalar> &arg) {
     casadi_error("'depends_on' not defined for " + type_name());
@@ -3208,6 +3220,90 @@ namespace casadi {
     }
   }
 
+  template<>
+  SX SX::cse(const SX& e) {
+    return cse(vector<SX>{e}).front();
+  }
+
+  template<>
+  vector<SX> SX::cse(const vector<SX>& e) {
+    // Sort the expression
+    Function f("tmp", vector<SX>(), e);
+    SXFunction *ff = f.get<SXFunction>();
+
+    // Get references to the internal data structures
+    const vector<ScalarAtomic>& algorithm = ff->algorithm_;
+    vector<SXElem> work(f.sz_w());
+
+    // Iterator to the binary operations
+    vector<SXElem>::const_iterator b_it=ff->operations_.begin();
+
+    // Iterator to stack of constants
+    vector<SXElem>::const_iterator c_it = ff->constants_.begin();
+
+    // Iterator to free variables
+    vector<SXElem>::const_iterator p_it = ff->free_vars_.begin();
+
+    // Operations encountered so far, hashed by operation and dependencies
+    unordered_multimap<size_t, SXElem> cache;
+
+    // Return value
+    vector<SX> ret = e;
+
+    // Evaluate the algorithm
+    for (vector<ScalarAtomic>::const_iterator it=algorithm.begin(); it<algorithm.end(); ++it) {
+      switch (it->op) {
+      case OP_OUTPUT:     ret.at(it->i0)->at(it->i2) = work[it->i1]; break;
+      case OP_CONST:      work[it->i0] = *c_it++; break;
+      case OP_PARAMETER:  work[it->i0] = *p_it++; break;
+      default:
+        {
+          // Original operation
+          const SXElem& orig = *b_it++;
+          bool binary = orig.n_dep()==2;
+
+          // Dependencies, after elimination
+          const SXElem& x = work[it->i1];
+          const SXElem& y = work[binary ? it->i2 : it->i1];
+
+          // Hash key, independent of the order for commutative operations
+          const SXNode *a = x.get(), *b = binary ? y.get() : 0;
+          bool comm = binary && operation_checker<CommChecker>(it->op);
+          if (comm && b<a) swap(a, b);
+          size_t key = it->op;
+          hash_combine(key, a);
+          hash_combine(key, b);
+
+          // Look for an identical operation
+          const SXElem* match = 0;
+          auto r = cache.equal_range(key);
+          for (auto c=r.first; c!=r.second && !match; ++c) {
+            const SXElem& cand = c->second;
+            if (cand.op()!=it->op) continue;
+            const SXNode *ca = cand.dep(0).get(), *cb = binary ? cand.dep(1).get() : 0;
+            if (comm && cb<ca) swap(ca, cb);
+            if (ca==a && cb==b) match = &cand;
+          }
+
+          if (match) {
+            work[it->i0] = *match;
+          } else {
+            // Keep the original node unless its dependencies have been replaced
+            if (orig.dep(0).get()==x.get() && (!binary || orig.dep(1).get()==y.get())) {
+              work[it->i0] = orig;
+            } else if (binary) {
+              work[it->i0] = BinarySX::create(it->op, x, y);
+            } else {
+              work[it->i0] = UnarySX::create(it->op, x);
+            }
+            cache.insert(make_pair(key, work[it->i0]));
+          }
+        }
+      }
+    }
+    return ret;
+  }
+
   template<>
   bool SX::depends_on(const SX &x, const SX &arg) {
     if (x.nnz()==0) return false;
@@ -292,6 +292,8 @@ namespace casadi {
                                   std::vector<Matrix<Scalar> >& vdef,
                                   std::vector<Matrix<Scalar> >& ex,
                                   bool revers);
+    static Matrix<Scalar> cse(const Matrix<Scalar>& e);
+    static std::vector<Matrix<Scalar> > cse(const std::vector<Matrix<Scalar> >& e);
     static Matrix<Scalar> pinv(const Matrix<Scalar> &x);
     static Matrix<Scalar> pinv(const Matrix<Scalar> &A,
                                  const std::string& lsolver, const Dict& opts);
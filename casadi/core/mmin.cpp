@@ -24,6 +24,7 @@
 
 
 #include "mmin.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 namespace casadi {
@@ -46,4 +47,10 @@ namespace casadi {
     return "max(" + arg.at(0) + ")";
   }
 
+  void MMin::serialize_body(SerializingStream& s) const {
+  }
+
+  void MMax::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
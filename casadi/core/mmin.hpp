@@ -50,6 +50,9 @@ namespace casadi {
 
     /** \brief Get the operation */
     int op() const override { return OP_MMIN;}
+
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
   };
 
   /** \brief Matrix maximum
@@ -71,6 +74,9 @@ namespace casadi {
 
     /** \brief Get the operation */
     int op() const override { return OP_MMAX;}
+
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
   };
 
 } // namespace casadi
@@ -24,6 +24,7 @@
 
 
 #include "monitor.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -129,4 +130,8 @@ namespace casadi {
     }
   }
 
+  void Monitor::serialize_body(SerializingStream& s) const {
+    s.pack(comment_);
+  }
+
 } // namespace casadi
@@ -26,6 +26,7 @@
 #include "multiple_output.hpp"
 #include "function_internal.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -56,4 +57,8 @@ namespace casadi {
     return arg.at(0) + "{" + str(oind_) + "}";
   }
 
+  void OutputNode::serialize_body(SerializingStream& s) const {
+    s.pack(oind_);
+  }
+
 } // namespace casadi
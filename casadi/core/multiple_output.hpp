@@ -86,6 +86,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return -1;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Create a horizontal concatenation node
     MX get_horzcat(const std::vector<MX>& x) const override { return dep()->get_horzcat(x);}
 
@@ -29,6 +29,21 @@
 #include "multiplication.hpp"
 #include "casadi_misc.hpp"
 #include "function_internal.hpp"
+#include "serializing_stream.hpp"
+
+#ifdef WITH_BLAS
+extern "C" {
+  /// Dense matrix-matrix multiplication (BLAS)
+  void dgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+              const double* alpha, const double* a, const int* lda, const double* b,
+              const int* ldb, const double* beta, double* c, const int* ldc);
+
+  /// Dense matrix-vector multiplication (BLAS)
+  void dgemv_(const char* trans, const int* m, const int* n, const double* alpha,
+              const double* a, const int* lda, const double* x, const int* incx,
+              const double* beta, double* y, const int* incy);
+}
+#endif // WITH_BLAS
 
 using namespace std;
 
@@ -120,6 +135,29 @@ namespace casadi {
                           g.work(res[0], nnz()), sparsity(), "w", false) << '\n';
   }
 
+  int DenseMultiplication::eval(const double** arg, double** res, int* iw, double* w) const {
+    if (arg[0]!=res[0]) copy(arg[0], arg[0]+dep(0).nnz(), res[0]);
+    int nrow_x = dep(1).size1(), ncol_x = dep(1).size2(), ncol_y = dep(2).size2();
+    if (nrow_x==0 || ncol_x==0 || ncol_y==0) return 0;
+#ifdef WITH_BLAS
+    const double one = 1;
+    if (ncol_y==1) {
+      const int inc = 1;
+      dgemv_("N", &nrow_x, &ncol_x, &one, arg[1], &nrow_x, arg[2], &inc, &one, res[0], &inc);
+    } else {
+      dgemm_("N", "N", &nrow_x, &ncol_y, &ncol_x, &one, arg[1], &nrow_x, arg[2], &ncol_x,
+             &one, res[0], &nrow_x);
+    }
+#else // WITH_BLAS
+    if (ncol_y==1) {
+      casadi_mv_dense(arg[1], nrow_x, ncol_x, arg[2], res[0], false);
+    } else {
+      casadi_mtimes_dense(arg[1], nrow_x, ncol_x, arg[2], ncol_y, res[0]);
+    }
+#endif // WITH_BLAS
+    return 0;
+  }
+
   void DenseMultiplication::
   generate(CodeGenerator& g,
            const std::vector<int>& arg, const std::vector<int>& res) const {
@@ -129,18 +167,23 @@ namespace casadi {
                           g.work(res[0], nnz())) << '\n';
     }
 
-    int nrow_x = dep(1).size1(), nrow_y = dep(2).size1(), ncol_y = dep(2).size2();
-    g.local("rr", "casadi_real", "*");
-    g.local("ss", "casadi_real", "*");
-    g.local("tt", "casadi_real", "*");
-    g.local("i", "int");
-    g.local("j", "int");
-    g.local("k", "int");
-    g << "for (i=0, rr=" << g.work(res[0], nnz()) <<"; i<" << ncol_y << "; ++i)"
-      << " for (j=0; j<" << nrow_x << "; ++j, ++rr)"
-      << " for (k=0, ss=" << g.work(arg[1], dep(1).nnz()) << "+j, tt="
-      << g.work(arg[2], dep(2).nnz()) << "+i*" << nrow_y << "; k<" << nrow_y << "; ++k)"
-      << " *rr += ss[k*" << nrow_x << "]**tt++;\n";
+    // Perform dense matrix multiplication
+    int nrow_x = dep(1).size1(), ncol_x = dep(1).size2(), ncol_y = dep(2).size2();
+    if (ncol_y==1) {
+      g << g.mv(g.work(arg[1], dep(1).nnz()), nrow_x, ncol_x,
+                g.work(arg[2], dep(2).nnz()), g.work(res[0], nnz()), false) << '\n';
+    } else {
+      g << g.mtimes(g.work(arg[1], dep(1).nnz()), nrow_x, ncol_x,
+                    g.work(arg[2], dep(2).nnz()), ncol_y, g.work(res[0], nnz())) << '\n';
+    }
+  }
+
+  void Multiplication::serialize_body(SerializingStream& s) const {
+    s.pack(false);
+  }
+
+  void DenseMultiplication::serialize_body(SerializingStream& s) const {
+    s.pack(true);
   }
 
 } // namespace casadi
@@ -82,6 +82,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_MTIMES;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Can the operation be performed inplace (i.e. overwrite the result)
     int n_inplace() const override { return 1;}
 
@@ -107,9 +110,15 @@ namespace casadi {
     DenseMultiplication(const MX& z, const MX& x, const MX& y)
         : Multiplication(z, x, y) {}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /** \brief  Destructor */
     ~DenseMultiplication() override {}
 
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, int* iw, double* w) const override;
+
     /** \brief Generate code for the operation */
     void generate(CodeGenerator& g,
                           const std::vector<int>& arg, const std::vector<int>& res) const override;
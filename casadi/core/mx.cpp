@@ -1225,6 +1225,112 @@ namespace casadi {
     return x->disp(args);
   }
 
+  MX MX::cse(const MX& e) {
+    return cse(vector<MX>{e}).front();
+  }
+
+  vector<MX> MX::cse(const vector<MX>& e) {
+    // Sort the expression
+    Function f("tmp", vector<MX>{}, e);
+    MXFunction *ff = f.get<MXFunction>();
+
+    // Get references to the internal data structures
+    const vector<MXAlgEl>& algorithm = ff->algorithm_;
+    vector<MX> work(ff->workloc_.size()-1);
+
+    // Storage for split outputs
+    vector<vector<MX> > res_split(e.size());
+    for (int i=0; i<e.size(); ++i) res_split[i].resize(e[i].n_primitives());
+
+    // Operations encountered so far, hashed by operation and dependencies
+    unordered_multimap<size_t, MX> cache;
+
+    // Outputs of the multiple-output operations kept
+    unordered_map<const MXNode*, vector<MX> > outputs;
+
+    vector<MX> arg1, res1;
+    vector<const MXNode*> dep;
+    for (auto it=algorithm.begin(); it!=algorithm.end(); ++it) {
+      if (it->op==OP_OUTPUT) {
+        res_split.at(it->data->ind()).at(it->data->segment()) = work[it->arg.front()];
+      } else if (it->op==OP_PARAMETER) {
+        work[it->res.front()] = it->data;
+      } else {
+        // Arguments of the operation, after elimination
+        bool changed = false;
+        arg1.resize(it->arg.size());
+        for (int i=0; i<arg1.size(); ++i) {
+          int el = it->arg[i]; // index of the argument
+          arg1[i] = el<0 ? it->data->dep(i) : work[el];
+          if (arg1[i].get()!=it->data->dep(i).get()) changed = true;
+        }
+
+        // Keep the original node unless its arguments have been replaced
+        MX node = it->data;
+        if (changed) {
+          res1.resize(it->res.size());
+          it->data->eval_mx(arg1, res1);
+          if (!it->data->has_output()) {
+            node = res1.front();
+          } else {
+            // Locate the new multiple-output node
+            bool found = !res1.empty();
+            for (int c=0; c<res1.size() && found; ++c) {
+              found = res1[c].is_output() && res1[c].which_output()==c;
+              if (found && c==0) {
+                node = res1[c]->dep();
+              } else if (found) {
+                found = res1[c]->dep().get()==node.get();
+              }
+            }
+            // Not found, use the outputs without elimination
+            if (!found) {
+              for (int c=0; c<res1.size(); ++c) {
+                if (it->res[c]>=0) work[it->res[c]] = res1[c];
+              }
+              continue;
+            }
+          }
+        }
+
+        // Hash key, independent of the order of the dependencies
+        dep.resize(node.n_dep());
+        for (int i=0; i<dep.size(); ++i) dep[i] = node->dep(i).get();
+        sort(dep.begin(), dep.end());
+        size_t key = node.op();
+        hash_combine(key, dep.size());
+        for (const MXNode* d : dep) hash_combine(key, d);
+
+        // Look for an equivalent operation
+        const MX* match = 0;
+        auto r = cache.equal_range(key);
+        for (auto c=r.first; c!=r.second && !match; ++c) {
+          if (MXNode::is_equal(c->second.get(), node.get(), 1)) match = &c->second;
+        }
+        if (!match) match = &cache.insert(make_pair(key, node))->second;
+
+        // Get the result
+        if (it->data->has_output()) {
+          vector<MX>& out = outputs[match->get()];
+          if (out.empty()) {
+            out.resize(it->res.size());
+            for (int c=0; c<out.size(); ++c) out[c] = match->get_output(c);
+          }
+          for (int c=0; c<out.size(); ++c) {
+            if (it->res[c]>=0) work[it->res[c]] = out[c];
+          }
+        } else {
+          work[it->res.front()] = *match;
+        }
+      }
+    }
+
+    // Join split outputs
+    vector<MX> ret(e.size());
+    for (int i=0; i<ret.size(); ++i) ret[i] = e[i].join_primitives(res_split[i]);
+    return ret;
+  }
+
   void MX::substitute_inplace(const std::vector<MX>& v, std::vector<MX>& vdef,
                              std::vector<MX>& ex, bool reverse) {
     casadi_assert(v.size()==vdef.size(),
@@ -427,6 +427,8 @@ namespace casadi {
     static void substitute_inplace(const std::vector<MX>& v,
                                   std::vector<MX>& vdef,
                                   std::vector<MX>& ex, bool reverse);
+    static MX cse(const MX& e);
+    static std::vector<MX> cse(const std::vector<MX>& e);
     static MX solve(const MX& A, const MX& b, const std::string& lsolver="csparse",
                     const Dict& dict = Dict());
     static MX inv_minor(const MX& A);
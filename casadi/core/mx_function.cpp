@@ -28,6 +28,8 @@
 #include "global_options.hpp"
 #include "casadi_interrupt.hpp"
 #include "io_instruction.hpp"
+#include "serializing_stream.hpp"
+#include "getnonzeros.hpp"
 
 #include <stack>
 #include <typeinfo>
@@ -54,7 +56,15 @@ namespace casadi {
         "Default input values"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"cse",
+       {OT_BOOL,
+        "Perform common subexpression elimination on the output expressions [default: false]"}},
+      {"fuse_nodes",
+       {OT_BOOL,
+        "Compile the algorithm for numeric evaluation, fusing chains of elementwise "
+        "operations and data movement into instructions without virtual dispatch "
+        "[default: true]"}}
      }
   };
 
@@ -89,6 +99,8 @@ namespace casadi {
 
     // Default (temporary) options
     bool live_variables = true;
+    bool cse_opt = false;
+    bool fuse_nodes = true;
 
     // Read options
     for (auto&& op : opts) {
@@ -96,9 +108,16 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables = op.second;
+      } else if (op.first=="cse") {
+        cse_opt = op.second;
+      } else if (op.first=="fuse_nodes") {
+        fuse_nodes = op.second;
       }
     }
 
+    // Merge identical subexpressions
+    if (cse_opt) out_ = MX::cse(out_);
+
     // Check/set default inputs
     if (default_in_.empty()) {
       default_in_.resize(n_in_, 0);
@@ -373,6 +392,115 @@ namespace casadi {
         break;
       }
     }
+
+    // Compile the numeric program
+    exec_.clear();
+    exec_ew_.clear();
+    exec_loc_.clear();
+    exec_nz_.clear();
+    if (fuse_nodes) compile_exec();
+  }
+
+  void MXFunction::compile_exec() {
+    for (int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      MXExecEl x;
+      x.kind = EXEC_GENERIC;
+      x.op = k;
+      x.n = 0;
+      x.res = x.arg0 = x.arg1 = -1;
+      if (e.op==OP_INPUT) {
+        x.kind = EXEC_INPUT;
+        x.op = e.data->ind();
+        x.n = e.data.nnz();
+        x.res = workloc_[e.res.front()];
+        x.arg0 = e.data->offset();
+      } else if (e.op==OP_OUTPUT) {
+        x.kind = EXEC_OUTPUT;
+        x.op = e.data->ind();
+        x.n = e.data.dep().nnz();
+        x.res = e.data->offset();
+        x.arg0 = workloc_[e.arg.front()];
+      } else if (e.res.size()==1 && e.res[0]>=0
+                 && (e.data->is_unary() || e.data->is_binary())) {
+        // Elementwise operation, possibly with a scalar argument
+        x.op = e.op;
+        x.n = e.data.nnz();
+        x.res = workloc_[e.res[0]];
+        x.arg0 = workloc_[e.arg[0]];
+        if (e.data->is_unary()) {
+          x.kind = EXEC_UNARY;
+        } else {
+          x.arg1 = workloc_[e.arg[1]];
+          if (x.n!=1 && e.data->dep(0).nnz()==1) {
+            x.kind = EXEC_BINARY_SCX;
+          } else if (x.n!=1 && e.data->dep(1).nnz()==1) {
+            x.kind = EXEC_BINARY_SCY;
+          } else {
+            x.kind = EXEC_BINARY;
+          }
+        }
+        // Append to the preceding fused block or start a new one
+        if (exec_.empty() || exec_.back().kind!=EXEC_FUSED) {
+          MXExecEl b;
+          b.kind = EXEC_FUSED;
+          b.op = b.n = b.res = -1;
+          b.arg0 = b.arg1 = exec_ew_.size();
+          exec_.push_back(b);
+        }
+        exec_ew_.push_back(x);
+        exec_.back().arg1 = exec_ew_.size();
+        continue;
+      } else if (e.op==OP_RESHAPE && e.res[0]>=0) {
+        // Reshape is a copy, or nothing at all if evaluated in-place
+        x.kind = EXEC_COPY;
+        x.n = e.data.nnz();
+        x.res = workloc_[e.res[0]];
+        x.arg0 = workloc_[e.arg[0]];
+        if (x.res==x.arg0) continue;
+      } else if ((e.op==OP_HORZCAT || e.op==OP_VERTCAT || e.op==OP_DIAGCAT) && e.res[0]>=0) {
+        // Concatenation becomes a sequence of copies
+        int r = workloc_[e.res[0]];
+        for (int i=0; i<e.arg.size(); ++i) {
+          x.kind = EXEC_COPY;
+          x.n = e.data->dep(i).nnz();
+          x.res = r;
+          x.arg0 = workloc_[e.arg[i]];
+          if (x.n>0) exec_.push_back(x);
+          r += x.n;
+        }
+        continue;
+      } else if (e.op==OP_GETNONZEROS && e.res[0]>=0) {
+        // Contiguous ranges are copied, other patterns gathered
+        vector<int> nz = static_cast<const GetNonzeros*>(e.data.get())->all();
+        x.n = nz.size();
+        x.res = workloc_[e.res[0]];
+        x.arg0 = workloc_[e.arg[0]];
+        bool contiguous = true;
+        for (int i=0; i<nz.size() && contiguous; ++i) {
+          contiguous = nz[i]>=0 && nz[i]==nz[0]+i;
+        }
+        if (contiguous) {
+          x.kind = EXEC_COPY;
+          if (x.n>0) x.arg0 += nz[0];
+        } else {
+          x.kind = EXEC_GATHER;
+          x.arg1 = exec_nz_.size();
+          exec_nz_.insert(exec_nz_.end(), nz.begin(), nz.end());
+        }
+      } else {
+        // Any other node: precompute the pointer offsets
+        x.arg0 = exec_loc_.size();
+        for (int a : e.arg) exec_loc_.push_back(a>=0 ? workloc_[a] : -1);
+        for (int r : e.res) exec_loc_.push_back(r>=0 ? workloc_[r] : -1);
+      }
+      exec_.push_back(x);
+    }
+
+    if (verbose_) {
+      casadi_message("Compiled " + str(algorithm_.size()) + " nodes into "
+                     + str(exec_.size()) + " instructions");
+    }
   }
 
   int MXFunction::eval(const double** arg, double** res, int* iw, double* w, void* mem) const {
@@ -389,6 +517,72 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Execute the compiled program, if available
+    if (!exec_.empty()) {
+      const double nan = numeric_limits<double>::quiet_NaN();
+      for (auto&& x : exec_) {
+        switch (x.kind) {
+        case EXEC_INPUT:
+          if (arg[x.op]==0) {
+            fill_n(w+x.res, x.n, 0.);
+          } else {
+            copy_n(arg[x.op]+x.arg0, x.n, w+x.res);
+          }
+          break;
+        case EXEC_OUTPUT:
+          if (res[x.op]) copy_n(w+x.arg0, x.n, res[x.op]+x.res);
+          break;
+        case EXEC_FUSED:
+          for (auto it=exec_ew_.begin()+x.arg0; it!=exec_ew_.begin()+x.arg1; ++it) {
+            const double* a0 = w+it->arg0;
+            double* r = w+it->res;
+            if (it->kind==EXEC_UNARY) {
+              if (it->n==1) {
+                casadi_math<double>::fun(it->op, *a0, nan, *r);
+              } else {
+                casadi_math<double>::fun(it->op, a0, nan, r, it->n);
+              }
+            } else if (it->n==1) {
+              casadi_math<double>::fun(it->op, *a0, w[it->arg1], *r);
+            } else if (it->kind==EXEC_BINARY) {
+              casadi_math<double>::fun(it->op, a0, w+it->arg1, r, it->n);
+            } else if (it->kind==EXEC_BINARY_SCX) {
+              casadi_math<double>::fun(it->op, *a0, w+it->arg1, r, it->n);
+            } else {
+              casadi_math<double>::fun(it->op, a0, w[it->arg1], r, it->n);
+            }
+          }
+          break;
+        case EXEC_COPY:
+          copy_n(w+x.arg0, x.n, w+x.res);
+          break;
+        case EXEC_GATHER:
+          {
+            const double* a0 = w+x.arg0;
+            double* r = w+x.res;
+            const int* nz = get_ptr(exec_nz_)+x.arg1;
+            for (int i=0; i<x.n; ++i) r[i] = nz[i]>=0 ? a0[nz[i]] : 0;
+          }
+          break;
+        default:
+          {
+            const AlgEl& e = algorithm_[x.op];
+            const int* loc = get_ptr(exec_loc_)+x.arg0;
+            for (int i=0; i<e.arg.size(); ++i) {
+              arg1[i] = *loc>=0 ? w+*loc : 0;
+              loc++;
+            }
+            for (int i=0; i<e.res.size(); ++i) {
+              res1[i] = *loc>=0 ? w+*loc : 0;
+              loc++;
+            }
+            if (e.data->eval(arg1, res1, iw, w)) return 1;
+          }
+        }
+      }
+      return 0;
+    }
+
     // Evaluate all of the nodes of the algorithm:
     // should only evaluate nodes that have not yet been calculated!
     for (auto&& e : algorithm_) {
@@ -1583,4 +1777,27 @@ namespace casadi {
     }
   }
 
+  void MXFunction::serialize_body(SerializingStream& s) const {
+    s.pack(name_);
+    s.pack(name_in_);
+    s.pack(name_out_);
+    s.pack(construct_opts_);
+    s.pack(in_);
+    s.pack(out_);
+  }
+
+  Function MXFunction::deserialize(DeserializingStream& s) {
+    string name;
+    vector<string> name_in, name_out;
+    Dict opts;
+    vector<MX> arg, res;
+    s.unpack(name);
+    s.unpack(name_in);
+    s.unpack(name_out);
+    s.unpack(opts);
+    s.unpack(arg);
+    s.unpack(res);
+    return Function(name, arg, res, name_in, name_out, opts);
+  }
+
 } // namespace casadi
@@ -53,6 +53,24 @@ namespace casadi {
     /// Work vector indices of the results
     std::vector<int> res;
   };
+
+  /** \brief  An element of the compiled numeric program of an MXFunction */
+  struct MXExecEl {
+    /// Kind of instruction
+    int kind;
+
+    /// Operator index, function input/output index or place in the algorithm
+    int op;
+
+    /// Number of nonzeros
+    int n;
+
+    /// Work vector offset of the result (-1 if none)
+    int res;
+
+    /// Work vector offsets of the arguments, or ranges in auxiliary tables
+    int arg0, arg1;
+  };
 #endif // SWIG
 
   /** \brief  Internal node class for MXFunction
@@ -71,6 +89,27 @@ namespace casadi {
     /** \brief Offsets for elements in the w_ vector */
     std::vector<int> workloc_;
 
+#ifndef SWIG
+    /** \brief Kinds of instructions in the compiled numeric program */
+    enum ExecKind {EXEC_INPUT, EXEC_OUTPUT, EXEC_FUSED, EXEC_COPY, EXEC_GATHER, EXEC_GENERIC,
+                   EXEC_UNARY, EXEC_BINARY, EXEC_BINARY_SCX, EXEC_BINARY_SCY};
+
+    /** \brief Compiled numeric program, empty if node fusion is disabled */
+    std::vector<MXExecEl> exec_;
+
+    /** \brief Elementwise operations of fused blocks, executed in sequence */
+    std::vector<MXExecEl> exec_ew_;
+
+    /** \brief Precomputed work vector offsets for generic nodes (-1 for null) */
+    std::vector<int> exec_loc_;
+
+    /** \brief Nonzero indices for gather instructions */
+    std::vector<int> exec_nz_;
+
+    /** \brief Compile the algorithm into a numeric program */
+    void compile_exec();
+#endif // SWIG
+
     /// Free variables
     std::vector<MX> free_vars_;
 
@@ -98,6 +137,12 @@ namespace casadi {
     /** \brief Check if the function is of a particular type */
     bool is_a(const std::string& type, bool recursive) const override;
 
+    /** \brief Serialize the expression graph */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize, rebuilding the expression graph */
+    static Function deserialize(DeserializingStream& s);
+
     ///@{
     /** \brief Options */
     static Options options_;
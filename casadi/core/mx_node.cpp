@@ -50,6 +50,10 @@
 #include "repmat.hpp"
 #include "casadi_find.hpp"
 #include "einstein.hpp"
+#include "symbolic_mx.hpp"
+#include "constant_mx.hpp"
+#include "casadi_call.hpp"
+#include "serializing_stream.hpp"
 
 // Template implementations
 #include "setnonzeros_impl.hpp"
@@ -937,4 +941,138 @@ namespace casadi {
     }
   }
 
+  void MXNode::serialize(SerializingStream& s) const {
+    s.pack(op());
+    s.pack(n_dep());
+    for (int i=0; i<n_dep(); ++i) s.pack(dep(i));
+    serialize_body(s);
+  }
+
+  void MXNode::serialize_body(SerializingStream& s) const {
+    casadi_error("'serialize' not defined for " + class_name());
+  }
+
+  MX MXNode::deserialize(DeserializingStream& s) {
+    int op, n_dep;
+    s.unpack(op);
+    s.unpack(n_dep);
+    casadi_assert(n_dep>=0, "Corrupted serialized data");
+    vector<MX> dep(n_dep);
+    for (auto&& e : dep) s.unpack(e);
+    auto d = [&](int i) -> const MX& {
+      casadi_assert(i<n_dep, "Corrupted serialized data");
+      return dep[i];
+    };
+    switch (op) {
+    case OP_PARAMETER:
+      {
+        string name;
+        Sparsity sp;
+        s.unpack(name);
+        s.unpack(sp);
+        return MX::create(new SymbolicMX(name, sp));
+      }
+    case OP_CONST:
+      {
+        DM x;
+        s.unpack(x);
+        return MX::create(ConstantMX::create(x));
+      }
+    case OP_MTIMES:
+      {
+        bool dense;
+        s.unpack(dense);
+        if (dense) return MX::create(new DenseMultiplication(d(0), d(1), d(2)));
+        return MX::create(new Multiplication(d(0), d(1), d(2)));
+      }
+    case OP_TRANSPOSE:
+      {
+        bool dense;
+        s.unpack(dense);
+        if (dense) return MX::create(new DenseTranspose(d(0)));
+        return MX::create(new Transpose(d(0)));
+      }
+    case OP_RESHAPE:
+    case OP_PROJECT:
+      {
+        Sparsity sp;
+        s.unpack(sp);
+        if (op==OP_RESHAPE) return MX::create(new Reshape(d(0), sp));
+        return MX::create(new Project(d(0), sp));
+      }
+    case OP_GETNONZEROS:
+      {
+        Sparsity sp;
+        vector<int> nz;
+        s.unpack(sp);
+        s.unpack(nz);
+        return GetNonzeros::create(sp, d(0), nz);
+      }
+    case OP_SETNONZEROS:
+    case OP_ADDNONZEROS:
+      {
+        vector<int> nz;
+        s.unpack(nz);
+        if (op==OP_ADDNONZEROS) return SetNonzeros<true>::create(d(0), d(1), nz);
+        return SetNonzeros<false>::create(d(0), d(1), nz);
+      }
+    case OP_HORZCAT: return MX::create(new Horzcat(dep));
+    case OP_VERTCAT: return MX::create(new Vertcat(dep));
+    case OP_DIAGCAT: return MX::create(new Diagcat(dep));
+    case OP_HORZSPLIT:
+    case OP_VERTSPLIT:
+    case OP_DIAGSPLIT:
+      {
+        vector<int> offset1, offset2;
+        s.unpack(offset1);
+        s.unpack(offset2);
+        if (op==OP_HORZSPLIT) return MX::create(new Horzsplit(d(0), offset2));
+        if (op==OP_VERTSPLIT) return MX::create(new Vertsplit(d(0), offset1));
+        return MX::create(new Diagsplit(d(0), offset1, offset2));
+      }
+    case OP_CALL: return Call::deserialize(s, dep);
+    case -1:
+      {
+        int oind;
+        s.unpack(oind);
+        return d(0).get_output(oind);
+      }
+    case OP_NORMF: return MX::create(new NormF(d(0)));
+    case OP_NORM2: return MX::create(new Norm2(d(0)));
+    case OP_NORM1: return MX::create(new Norm1(d(0)));
+    case OP_NORMINF: return MX::create(new NormInf(d(0)));
+    case OP_DOT: return MX::create(new Dot(d(0), d(1)));
+    case OP_BILIN: return MX::create(new Bilin(d(0), d(1), d(2)));
+    case OP_RANK1: return MX::create(new Rank1(d(0), d(1), d(2), d(3)));
+    case OP_DETERMINANT: return MX::create(new Determinant(d(0)));
+    case OP_INVERSE: return MX::create(new Inverse(d(0)));
+    case OP_MMIN: return MX::create(new MMin(d(0)));
+    case OP_MMAX: return MX::create(new MMax(d(0)));
+    case OP_MONITOR:
+    case OP_ASSERTION:
+      {
+        string msg;
+        s.unpack(msg);
+        if (op==OP_MONITOR) return MX::create(new Monitor(d(0), msg));
+        return MX::create(new Assertion(d(0), d(1), msg));
+      }
+    default:
+      // Elementwise operations
+      casadi_assert(op>=0 && op<NUM_BUILT_IN_OPS, "Corrupted serialized data");
+      if (n_dep==1) {
+        return MX::create(new UnaryMX(static_cast<Operation>(op), d(0)));
+      } else if (n_dep==2) {
+        bool scx, scy;
+        s.unpack(scx);
+        s.unpack(scy);
+        Operation o = static_cast<Operation>(op);
+        if (scx && scy) return MX::create(new BinaryMX<true, true>(o, dep[0], dep[1]));
+        if (scx) return MX::create(new BinaryMX<true, false>(o, dep[0], dep[1]));
+        if (scy) return MX::create(new BinaryMX<false, true>(o, dep[0], dep[1]));
+        return MX::create(new BinaryMX<false, false>(o, dep[0], dep[1]));
+      }
+      casadi_error("Corrupted serialized data");
+    }
+  }
+
 } // namespace casadi
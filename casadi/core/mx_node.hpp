@@ -36,6 +36,9 @@
 #include <stack>
 
 namespace casadi {
+  class SerializingStream;
+  class DeserializingStream;
+
   /** \brief Node class for MX objects
       \author Joel Andersson
       \date 2010
@@ -173,6 +176,15 @@ namespace casadi {
     /** Obtain information about node */
     virtual Dict info() const;
 
+    /** \brief Serialize the node, operation and dependencies followed by body */
+    void serialize(SerializingStream& s) const;
+
+    /** \brief Serialize the class specific data */
+    virtual void serialize_body(SerializingStream& s) const;
+
+    /** \brief Deserialize a node written by serialize */
+    static MX deserialize(DeserializingStream& s);
+
     /** \brief Check if two nodes are equivalent up to a given depth */
     static bool is_equal(const MXNode* x, const MXNode* y, int depth);
     virtual bool is_equal(const MXNode* node, int depth) const { return false;}
@@ -537,4 +537,9 @@ namespace casadi {
     oracle_.disp(stream, true);
   }
 
+  void Nlpsol::serialize_body(SerializingStream& s) const {
+    s.pack(std::string(plugin_name()));
+    OracleFunction::serialize_body(s);
+  }
+
 } // namespace casadi
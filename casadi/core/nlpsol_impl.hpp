@@ -118,6 +118,15 @@ namespace casadi {
     const Options& get_options() const override { return options_;}
     ///@}
 
+    /** \brief Class name identifying the deserializer */
+    std::string serialize_class() const override { return "Nlpsol";}
+
+    /** \brief Serialize the plugin name followed by the oracle */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize, instantiating the plugin */
+    static Function deserialize(DeserializingStream& s) { return deserialize_plugin<Nlpsol>(s);}
+
     /** \brief  Print description */
     void disp_more(std::ostream& stream) const override;
 
@@ -24,6 +24,7 @@
 
 
 #include "norm.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 namespace casadi {
@@ -91,4 +92,7 @@ namespace casadi {
     return "||" + arg.at(0) + "||_inf";
   }
 
+  void Norm::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
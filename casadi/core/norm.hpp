@@ -44,6 +44,9 @@ namespace casadi {
 
     /** \brief  Destructor */
     ~Norm() override {}
+
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
   };
 
   /** \brief Represents a Frobenius norm
@@ -184,6 +184,15 @@ DM Opti::value(const SX& x, const std::vector<MX>& values) const {
   }
 }
 
+std::vector<DM> Opti::values(const std::vector<MX>& x,
+                             const std::vector<MX>& assignments) const {
+  try {
+    return (*this)->values(x, assignments);
+  } catch (exception& e) {
+    THROW_ERROR("values", e.what());
+  }
+}
+
 Dict Opti::stats() const {
   try {
     return (*this)->stats();
@@ -684,6 +693,10 @@ DM OptiSol::value(const DM& x, const std::vector<MX>& values) const {
 DM OptiSol::value(const SX& x, const std::vector<MX>& values) const {
   return optistack_.value(x, values);
 }
+std::vector<DM> OptiSol::values(const std::vector<MX>& x,
+                                const std::vector<MX>& assignments) const {
+  return optistack_.values(x, assignments);
+}
 
 std::vector<MX> OptiSol::value_variables() const {
   return optistack_.value_variables();
@@ -202,6 +202,18 @@ public:
   native_DM value(const SX& x, const std::vector<MX>& values=std::vector<MX>()) const;
   /// @}
 
+  /** \brief Obtain values of several expressions at once
+  *
+  * Equivalent to calling 'value' on each expression, but evaluated with a
+  * single helper function, which is cached for subsequent calls with the
+  * same expressions.
+  *
+  * \param[in] assignments Optional assignment expressions (e.g. x==3)
+  *            to overrule the current value
+  */
+  std::vector<DM> values(const std::vector<MX>& x,
+                         const std::vector<MX>& assignments=std::vector<MX>()) const;
+
   /** \brief Get statistics
   *
   * nlpsol stats are passed as-is.
@@ -523,6 +535,14 @@ class CASADI_EXPORT OptiSol : public SWIG_IF_ELSE(PrintableCommon, Printable<Opt
     native_DM value(const SX& x, const std::vector<MX>& values=std::vector<MX>()) const;
     /// @}
 
+    /** \brief Obtain values of several expressions at once
+    *
+    * \param[in] assignments Optional assignment expressions (e.g. x==3)
+    *            to overrule the current value
+    */
+    std::vector<DM> values(const std::vector<MX>& x,
+                           const std::vector<MX>& assignments=std::vector<MX>()) const;
+
     /// get assignment expressions for the optimal solution
     std::vector<MX> value_variables() const;
     std::vector<MX> value_parameters() const;
@@ -953,19 +953,40 @@ DMDict OptiNode::solve_actual(const DMDict& arg) {
   return solver_(arg);
 }
 
-DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
-  std::vector<MX> x   = symvar(expr, OPTI_VAR);
-  std::vector<MX> p   = symvar(expr, OPTI_PAR);
-  std::vector<MX> lam = symvar(expr, OPTI_DUAL_G);
-
-  Function helper = Function("helper", std::vector<MX>{veccat(x), veccat(p), veccat(lam)}, {expr});
-  if (helper.has_free())
+const OptiNode::ValueHelper& OptiNode::value_helper(const std::vector<MX>& expr) const {
+  // Look up in the cache
+  std::vector<MXNode*> key;
+  for (const auto& e : expr) key.push_back(e.get());
+  auto it = value_cache_.find(key);
+  if (it!=value_cache_.end()) return it->second;
+
+  // Create a new helper function
+  ValueHelper h;
+  h.expr = expr;
+  MX all = veccat(expr);
+  h.x   = symvar(all, OPTI_VAR);
+  h.p   = symvar(all, OPTI_PAR);
+  h.lam = symvar(all, OPTI_DUAL_G);
+  h.f = Function("helper", std::vector<MX>{veccat(h.x), veccat(h.p), veccat(h.lam)}, expr);
+  if (h.f.has_free())
     casadi_error("This expression has symbols that are not defined "
       "within Opti using variable/parameter.");
 
+  // Expressions that are built anew for each call never hit, keep the cache bounded
+  if (value_cache_.size()>=1000) value_cache_.clear();
+  return value_cache_[key] = h;
+}
+
+DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
+  return this->values(std::vector<MX>{expr}, values).front();
+}
+
+std::vector<DM> OptiNode::values(const std::vector<MX>& expr,
+                                 const std::vector<MX>& assignments) const {
+  const ValueHelper& h = value_helper(expr);
 
   std::map<int, MX> temp;
-  for (const auto& v : values) {
+  for (const auto& v : assignments) {
     casadi_assert_dev(v.is_op(OP_EQ));
     int i = meta(v.dep(1)).i;
     casadi_assert_dev(v.dep(0).is_constant());
@@ -974,7 +995,7 @@ DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
 
   bool undecided_vars = false;
   std::vector<DM> x_num;
-  for (const auto& e : x) {
+  for (const auto& e : h.x) {
     int i = meta(e).i;
     x_num.push_back(latest_[i]);
 
@@ -992,21 +1013,21 @@ DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
 
   if (undecided_vars) {
     assert_solved();
-    for (const auto& e : x)
+    for (const auto& e : h.x)
       casadi_assert(symbol_active_[meta(e).count],
         "This expression has symbols that do not appear in the constraints and objective:\n" +
         describe(e, 1));
   }
 
   std::vector<DM> p_num;
-  for (const auto& e : p) {
+  for (const auto& e : h.p) {
     p_num.push_back(values_[meta(e).i]);
   }
 
   std::vector<DM> lam_num;
-  if (lam.size()>0) {
+  if (h.lam.size()>0) {
     assert_solved();
-    for (const auto& e : lam) {
+    for (const auto& e : h.lam) {
       casadi_assert(symbol_active_[meta(e).count],
         "This expression has a dual for a constraint that is not given to Opti:\n" +
         describe(e, 1));
@@ -1014,8 +1035,7 @@ DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
     }
   }
 
-  std::vector<DM> arg = helper(std::vector<DM>{veccat(x_num), veccat(p_num), veccat(lam_num)});
-  return arg[0];
+  return h.f(std::vector<DM>{veccat(x_num), veccat(p_num), veccat(lam_num)});
 }
 
 void OptiNode::assert_active_symbol(const MX& m) const {
@@ -108,6 +108,10 @@ public:
   }
   /// @}
 
+  /// Obtain values of several expressions at once, evaluated in a single function call
+  std::vector<DM> values(const std::vector<MX>& x,
+                         const std::vector<MX>& assignments=std::vector<MX>()) const;
+
   /// Copy
   Opti copy() const;
 
@@ -353,6 +357,22 @@ private:
   /// Bounds helper function: p -> lbg, ubg
   Function bounds_;
 
+  /// Helper function for evaluating expressions numerically
+  struct ValueHelper {
+    /// Expressions, keeping the nodes used as cache key alive
+    std::vector<MX> expr;
+    /// Variables, parameters and duals the expressions depend on
+    std::vector<MX> x, p, lam;
+    /// (x, p, lam) -> expr
+    Function f;
+  };
+
+  /// Helper functions for 'value', keyed on the expression nodes
+  mutable std::map<std::vector<MXNode*>, ValueHelper> value_cache_;
+
+  /// Get a (cached) helper function for evaluating expressions
+  const ValueHelper& value_helper(const std::vector<MX>& expr) const;
+
   /// Constraints verbatim as passed in with 'subject_to'
   std::vector<MX> g_;
 
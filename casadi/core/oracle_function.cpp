@@ -35,6 +35,8 @@ namespace casadi {
 
   OracleFunction::OracleFunction(const std::string& name, const Function& oracle)
   : FunctionInternal(name), oracle_(oracle) {
+    eval_cache_ = false;
+    fuse_functions_ = false;
   }
 
   OracleFunction::~OracleFunction() {
@@ -51,7 +53,20 @@ namespace casadi {
       {"specific_options",
        {OT_DICT,
         "Options for specific auto-generated functions,"
-        " overwriting the defaults from common_options. Nested dictionary."}}
+        " overwriting the defaults from common_options. Nested dictionary."}},
+      {"eval_cache",
+       {OT_BOOL,
+        "Remember the last evaluation of each auto-generated function and serve "
+        "calls with identical inputs from it, also for functions whose outputs are "
+        "a subset, e.g. the objective from an evaluation of its gradient. "
+        "Cache hits are not counted as evaluations in the statistics, "
+        "but reported as n_hit_<function> [default: false]"}},
+      {"fuse_functions",
+       {OT_BOOL,
+        "Evaluate auto-generated functions with identical inputs together in one "
+        "function, so that subsequent calls at the same inputs are served from the "
+        "cache. A fused evaluation is counted in the statistics of the function whose "
+        "call triggered it. Only used together with eval_cache [default: false]"}}
     }
   };
 
@@ -71,6 +86,10 @@ namespace casadi {
             " Type mismatch for entry '" + i.first+ "': "
             " got type " + i.second.get_description() + ".");
         }
+      } else if (op.first=="eval_cache") {
+        eval_cache_ = op.second;
+      } else if (op.first=="fuse_functions") {
+        fuse_functions_ = op.second;
       }
     }
   }
@@ -86,6 +105,60 @@ namespace casadi {
       }
     }
 
+    // Fuse auto-generated functions with identical inputs
+    if (eval_cache_ && fuse_functions_) {
+      map<vector<string>, vector<string> > groups;
+      for (auto&& e : all_functions_) {
+        if (e.second.jit) groups[e.second.f.name_in()].push_back(e.first);
+      }
+      int n_fused = 0;
+      for (auto&& g : groups) {
+        if (g.second.size()<2) continue;
+        // Union of the outputs and auxiliary outputs
+        vector<string> s_out;
+        Function::AuxOut aux;
+        for (const string& fname : g.second) {
+          const RegFun& r = all_functions_.at(fname);
+          for (const string& o : r.s_out) {
+            if (find(s_out.begin(), s_out.end(), o)==s_out.end()) s_out.push_back(o);
+          }
+          aux.insert(r.aux.begin(), r.aux.end());
+        }
+        string fused = "fused_" + str(n_fused++);
+        create_function(fused, g.first, s_out, aux);
+        for (const string& fname : g.second) all_functions_[fname].fused = fused;
+      }
+    }
+
+    // Functions with the same inputs that can serve each other from the cache
+    if (eval_cache_) {
+      for (auto&& e : all_functions_) {
+        RegFun& r = e.second;
+        r.providers.clear();
+        if (!r.jit) continue;
+        for (auto&& e2 : all_functions_) {
+          const RegFun& r2 = e2.second;
+          if (e2.first==e.first || !r2.jit || r2.f.name_in()!=r.f.name_in()) continue;
+          bool match = true;
+          for (int i=0; i<r.f.n_in() && match; ++i) {
+            match = r.f.sparsity_in(i)==r2.f.sparsity_in(i);
+          }
+          // Corresponding outputs
+          vector<int> ind;
+          for (int i=0; i<r.f.n_out() && match; ++i) {
+            const vector<string>& name_out = r2.f.name_out();
+            auto it = find(name_out.begin(), name_out.end(), r.f.name_out(i));
+            match = it!=name_out.end();
+            if (match) {
+              ind.push_back(it-name_out.begin());
+              match = r.f.sparsity_out(i)==r2.f.sparsity_out(ind.back());
+            }
+          }
+          if (match) r.providers.push_back(make_pair(e2.first, ind));
+        }
+      }
+    }
+
     // Set corresponding monitors
     for (const string& fname : monitor) {
       auto it = all_functions_.find(fname);
@@ -126,8 +199,14 @@ namespace casadi {
     // Combine specific and common options
     Dict opt = combine(specific_options, common_options_);
 
-    // Generate the function
-    Function ret = oracle_.factory(fname, s_in, s_out, aux, opt);
+    // Generate the function, unless restored from a serialized instance
+    Function ret;
+    auto r_it = restored_functions_.find(fname);
+    if (r_it!=restored_functions_.end()) {
+      ret = r_it->second;
+    } else {
+      ret = oracle_.factory(fname, s_in, s_out, aux, opt);
+    }
 
     // Make sure that it's sound
     if (ret.has_free()) {
@@ -136,6 +215,9 @@ namespace casadi {
 
     // Save and return
     set_function(ret, fname, true);
+    RegFun& r = all_functions_[fname];
+    r.s_out = s_out;
+    r.aux = aux;
     return ret;
   }
 
@@ -163,14 +245,8 @@ namespace casadi {
     // Get function
     const Function& f = get_function(fcn);
 
-    // Get statistics structure
-    FStats& fstats = m->fstats.at(fcn);
-
-    // Number of inputs and outputs
-    int n_in = f.n_in(), n_out = f.n_out();
-
-    // Prepare stats, start timer
-    fstats.tic();
+    // Number of inputs
+    int n_in = f.n_in();
 
     // Input buffers
     if (arg) {
@@ -200,25 +276,67 @@ namespace casadi {
       casadi_message(s.str());
     }
 
-    // Evaluate memory-less
+    // Quick return if the outputs are available from an earlier evaluation
+    if (eval_cache_ && from_cache(m, fcn)) {
+      if (monitored) casadi_message(fcn + " outputs taken from cache");
+      return 0;
+    }
+
+    // Function that is evaluated, possibly a fused function
+    const string& fused = all_functions_.at(fcn).fused;
+    const string& fcn_eval = eval_cache_ && !fused.empty() ? fused : fcn;
+    const Function& fe = fcn_eval==fcn ? f : get_function(fcn_eval);
+    int n_out = fe.n_out();
+
+    // Get statistics structure, a fused evaluation counts for the function requested
+    FStats& fstats = m->fstats.at(fcn);
+
+    // Prepare stats, start timer
+    fstats.tic();
+
+    // Evaluate into the cache, saving the requested outputs
+    OracleMemory::Cache* c = 0;
+    if (eval_cache_) {
+      c = &m->cache.at(fcn_eval);
+      c->valid = false;
+      double* in = get_ptr(c->in);
+      for (int i=0; i<n_in; ++i) {
+        if (m->arg[i]) {
+          copy_n(m->arg[i], fe.nnz_in(i), in);
+        } else {
+          fill_n(in, fe.nnz_in(i), 0.);
+        }
+        in += fe.nnz_in(i);
+      }
+      double* out = get_ptr(c->out);
+      for (int i=0; i<n_out; ++i) {
+        m->res_req[i] = m->res[i];
+        m->res[i] = out;
+        out += fe.nnz_out(i);
+      }
+    }
+
+    // Evaluate with a memory object of its own, the oracle may be shared
+    int flag = 0;
     try {
-      f(m->arg, m->res, m->iw, m->w, 0);
+      scoped_checkout<FunctionInternal> mem_fe(fe.get());
+      fe(m->arg, m->res, m->iw, m->w, mem_fe);
     } catch(exception& ex) {
       // Fatal error
-      casadi_warning(name_ + ":" + fcn + " failed:" + std::string(ex.what()));
-      return 1;
+      casadi_warning(name_ + ":" + fcn_eval + " failed:" + std::string(ex.what()));
+      flag = 1;
     }
 
     // Print output nonzeros
-    if (monitored) {
+    if (!flag && monitored) {
       std::stringstream s;
-      s << fcn << " output nonzeros:\n";
+      s << fcn_eval << " output nonzeros:\n";
       for (int i=0; i<n_out; ++i) {
-        s << " " << i << " (" << f.name_out(i) << "): ";
+        s << " " << i << " (" << fe.name_out(i) << "): ";
         if (m->res[i]) {
           // Print nonzeros
           s << "[";
-          for (int k=0; k<f.nnz_out(i); ++k) {
+          for (int k=0; k<fe.nnz_out(i); ++k) {
             if (k!=0) s << ", ";
             s << m->res[i][k];
           }
@@ -232,33 +350,89 @@ namespace casadi {
     }
 
     // Make sure not NaN or Inf
-    for (int i=0; i<n_out; ++i) {
+    for (int i=0; i<n_out && !flag; ++i) {
       if (!m->res[i]) continue;
-      if (!all_of(m->res[i], m->res[i]+f.nnz_out(i), [](double v) { return isfinite(v);})) {
+      if (!all_of(m->res[i], m->res[i]+fe.nnz_out(i), [](double v) { return isfinite(v);})) {
         std::stringstream ss;
 
-        auto it = find_if(m->res[i], m->res[i]+f.nnz_out(i), [](double v) { return !isfinite(v);});
+        auto it = find_if(m->res[i], m->res[i]+fe.nnz_out(i),
+                          [](double v) { return !isfinite(v);});
         int k = distance(m->res[i], it);
         bool is_nan = isnan(m->res[i][k]);
-        ss << name_ << ":" << fcn << " failed: " << (is_nan? "NaN" : "Inf") <<
-        " detected for output " << f.name_out(i) << ", at " << f.sparsity_out(i).repr_el(k) << ".";
+        ss << name_ << ":" << fcn_eval << " failed: " << (is_nan? "NaN" : "Inf") <<
+        " detected for output " << fe.name_out(i) << ", at "
+        << fe.sparsity_out(i).repr_el(k) << ".";
 
         if (regularity_check_) {
+          if (c) for (int j=0; j<n_out; ++j) m->res[j] = m->res_req[j];
           casadi_error(ss.str());
         } else {
           casadi_warning(ss.str());
         }
-        return -1;
+        flag = -1;
       }
     }
 
+    // Restore the requested outputs
+    if (c) for (int i=0; i<n_out; ++i) m->res[i] = m->res_req[i];
+    if (flag) return flag;
+
     // Update stats
     fstats.toc();
 
+    // Copy the requested outputs from the cache
+    if (c) {
+      c->valid = true;
+      if (fcn_eval==fcn) {
+        const double* out = get_ptr(c->out);
+        for (int i=0; i<n_out; ++i) {
+          if (m->res[i]) copy_n(out, fe.nnz_out(i), m->res[i]);
+          out += fe.nnz_out(i);
+        }
+      } else {
+        casadi_assert_dev(from_cache(m, fcn));
+      }
+    }
+
     // Success
     return 0;
   }
 
+  bool OracleFunction::from_cache(OracleMemory* m, const std::string& fcn) const {
+    const RegFun& r = all_functions_.at(fcn);
+    const Function& f = r.f;
+    // Try the own cache first, then the functions with more outputs
+    for (int k=-1; k<static_cast<int>(r.providers.size()); ++k) {
+      const string& pname = k<0 ? fcn : r.providers[k].first;
+      const OracleMemory::Cache& c = m->cache.at(pname);
+      if (!c.valid) continue;
+      // Do the inputs match?
+      bool match = true;
+      const double* in = get_ptr(c.in);
+      for (int i=0; i<f.n_in() && match; ++i) {
+        if (m->arg[i]) {
+          match = equal(in, in+f.nnz_in(i), m->arg[i]);
+        } else {
+          match = all_of(in, in+f.nnz_in(i), [](double v) { return v==0;});
+        }
+        in += f.nnz_in(i);
+      }
+      if (!match) continue;
+      // Copy the requested outputs
+      const Function& pf = k<0 ? f : get_function(pname);
+      for (int i=0; i<f.n_out(); ++i) {
+        if (!m->res[i]) continue;
+        int j = k<0 ? i : r.providers[k].second[i];
+        const double* out = get_ptr(c.out);
+        for (int jj=0; jj<j; ++jj) out += pf.nnz_out(jj);
+        copy_n(out, f.nnz_out(i), m->res[i]);
+      }
+      m->cache.at(fcn).n_hit++;
+      return true;
+    }
+    return false;
+  }
+
   std::string OracleFunction::
   generate_dependencies(const std::string& fname, const Dict& opts) const {
     CodeGenerator gen(fname, opts);
@@ -317,12 +491,16 @@ namespace casadi {
     auto m = static_cast<OracleMemory*>(mem);
 
     // Add timing statistics
-    Dict stats;
+    Dict stats = FunctionInternal::get_stats(mem);
     for (auto&& s : m->fstats) {
       stats["n_call_" +s.first] = s.second.n_call;
       stats["t_wall_" +s.first] = s.second.t_wall;
       stats["t_proc_" +s.first] = s.second.t_proc;
     }
+    // Calls served from the evaluation cache
+    for (auto&& c : m->cache) {
+      stats["n_hit_" +c.first] = c.second.n_hit;
+    }
     return stats;
   }
 
@@ -334,6 +512,21 @@ namespace casadi {
     for (auto&& e : all_functions_) {
       m->fstats[e.first] = FStats();
     }
+
+    // Create evaluation caches
+    if (eval_cache_) {
+      int max_n_out = 0;
+      for (auto&& e : all_functions_) {
+        const Function& f = e.second.f;
+        OracleMemory::Cache& c = m->cache[e.first];
+        c.in.resize(f.nnz_in());
+        c.out.resize(f.nnz_out());
+        c.valid = false;
+        c.n_hit = 0;
+        max_n_out = max(max_n_out, f.n_out());
+      }
+      m->res_req.resize(max_n_out);
+    }
     return 0;
   }
 
@@ -375,5 +568,17 @@ namespace casadi {
     return all_functions_.find(fname) != all_functions_.end();
   }
 
+  void OracleFunction::serialize_body(SerializingStream& s) const {
+    s.pack(name_);
+    s.pack(oracle_);
+    // Generated functions that can be restored without calling the factory
+    std::map<std::string, Function> generated;
+    for (auto&& e : all_functions_) {
+      const Function& f = e.second.f;
+      if (f.is_a("SXFunction") || f.is_a("MXFunction")) generated[e.first] = f;
+    }
+    s.pack(generated);
+    s.pack(construct_opts_);
+  }
 
 } // namespace casadi
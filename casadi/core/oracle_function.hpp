@@ -27,6 +27,7 @@
 #define CASADI_ORACLE_FUNCTION_HPP
 
 #include "function_internal.hpp"
+#include "serializing_stream.hpp"
 #include "timing.hpp"
 
 /// \cond INTERNAL
@@ -43,6 +44,22 @@ namespace casadi {
     // Function specific statistics
     std::map<std::string, FStats> fstats;
 
+    // Last evaluation of a function, used to serve repeated calls
+    struct Cache {
+      // Input and output nonzeros, all inputs and outputs concatenated
+      std::vector<double> in, out;
+      // Does the cache hold an evaluation?
+      bool valid = false;
+      // Number of calls served from the cache
+      int n_hit = 0;
+    };
+
+    // Evaluation caches, if enabled
+    std::map<std::string, Cache> cache;
+
+    // Outputs requested by the caller, saved while evaluating into the cache
+    std::vector<double*> res_req;
+
     // Add a statistic
     void add_stat(const std::string& s) {
       bool added = fstats.insert(std::make_pair(s, FStats())).second;
@@ -68,10 +85,27 @@ namespace casadi {
       Function f;
       bool jit;
       bool monitored = false;
+      // Outputs and auxiliary outputs used when creating f, cf. create_function
+      std::vector<std::string> s_out;
+      Function::AuxOut aux;
+      // Other functions with the same inputs whose outputs include all outputs of f,
+      // with the corresponding output indices
+      std::vector<std::pair<std::string, std::vector<int> > > providers;
+      // Fused function evaluated in place of f, if any
+      std::string fused;
     };
 
     // All NLP functions
     std::map<std::string, RegFun> all_functions_;
+
+    // Deserialized functions, reused by create_function
+    std::map<std::string, Function> restored_functions_;
+
+    /// Serve repeated calls at identical inputs from an evaluation cache
+    bool eval_cache_;
+
+    /// Evaluate functions with identical inputs together
+    bool fuse_functions_;
   public:
     /** \brief  Constructor */
     OracleFunction(const std::string& name, const Function& oracle);
@@ -114,6 +148,9 @@ namespace casadi {
     int calc_function(OracleMemory* m, const std::string& fcn,
                       const double* const* arg=0) const;
 
+    // Copy the outputs from the cache if the inputs match a cached evaluation
+    bool from_cache(OracleMemory* m, const std::string& fcn) const;
+
     // Get list of dependency functions
     std::vector<std::string> get_function() const override;
 
@@ -150,6 +187,29 @@ namespace casadi {
 
     /// Get all statistics
     Dict get_stats(void* mem) const override;
+
+    /** \brief Serialize the oracle and the generated functions */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize a plugin instance, reusing the generated functions */
+    template<typename Derived>
+    static Function deserialize_plugin(DeserializingStream& s) {
+      std::string plugin, name;
+      Function oracle;
+      std::map<std::string, Function> restored;
+      Dict opts;
+      s.unpack(plugin);
+      s.unpack(name);
+      s.unpack(oracle);
+      s.unpack(restored);
+      s.unpack(opts);
+      Derived* node = Derived::instantiate(name, plugin, oracle);
+      Function ret = Function::create(node);
+      node->restored_functions_ = restored;
+      ret->construct(opts);
+      node->restored_functions_.clear();
+      return ret;
+    }
   };
 
 } // namespace casadi
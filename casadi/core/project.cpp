@@ -27,6 +27,7 @@
 #include <vector>
 #include <sstream>
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -96,5 +97,8 @@ namespace casadi {
                            g.work(res.front(), nnz()), sparsity(), "w") << "\n";
   }
 
+  void Project::serialize_body(SerializingStream& s) const {
+    s.pack(sparsity());
+  }
 
 } // namespace casadi
@@ -80,6 +80,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_PROJECT;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /** \brief Get required length of w field */
     size_t sz_w() const override { return size1();}
   };
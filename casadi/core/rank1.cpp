@@ -24,6 +24,7 @@
 
 
 #include "rank1.hpp"
+#include "serializing_stream.hpp"
 using namespace std;
 namespace casadi {
 
@@ -137,4 +138,7 @@ namespace casadi {
                          g.work(arg[2], dep(2).nnz()), g.work(arg[3], dep(3).nnz())) << "\n";
   }
 
+  void Rank1::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
@@ -85,6 +85,9 @@ namespace casadi {
 
     /** \brief Get the operation */
     int op() const override { return OP_RANK1;}
+
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
   };
 
 
@@ -25,6 +25,7 @@
 
 #include "reshape.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -141,4 +142,8 @@ namespace casadi {
     dep()->reset_input();
   }
 
+  void Reshape::serialize_body(SerializingStream& s) const {
+    s.pack(sparsity());
+  }
+
 } // namespace casadi
@@ -83,6 +83,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_RESHAPE;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Can the operation be performed inplace (i.e. overwrite the result)
     int n_inplace() const override { return 1;}
 
@@ -244,6 +244,7 @@ namespace casadi {
 
   int Rootfinder::
   sp_forward(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, void* mem) const {
+    scoped_checkout<FunctionInternal> mem_oracle(oracle_.get());
     bvec_t* tmp1 = w; w += n_;
     bvec_t* tmp2 = w; w += n_;
 
@@ -254,7 +255,7 @@ namespace casadi {
     bvec_t** res1 = res+n_out_;
     fill_n(res1, n_out_, static_cast<bvec_t*>(0));
     res1[iout_] = tmp1;
-    oracle_(arg1, res1, iw, w, 0);
+    oracle_(arg1, res1, iw, w, mem_oracle);
 
     // "Solve" in order to propagate to z
     fill_n(tmp2, n_, 0);
@@ -266,12 +267,13 @@ namespace casadi {
       arg1[iin_] = tmp2;
       copy(res, res+n_out_, res1);
       res1[iout_] = 0;
-      oracle_(arg1, res1, iw, w, 0);
+      oracle_(arg1, res1, iw, w, mem_oracle);
     }
     return 0;
   }
 
   int Rootfinder::sp_reverse(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, void* mem) const {
+    scoped_checkout<FunctionInternal> mem_oracle(oracle_.get());
     bvec_t* tmp1 = w; w += n_;
     bvec_t* tmp2 = w; w += n_;
 
@@ -291,7 +293,7 @@ namespace casadi {
     copy(arg, arg+n_in_, arg1);
     arg1[iin_] = tmp1;
     if (n_out_>1) {
-      if (oracle_.rev(arg1, res1, iw, w, 0)) return 1;
+      if (oracle_.rev(arg1, res1, iw, w, mem_oracle)) return 1;
     }
 
     // "Solve" in order to get seed
@@ -302,7 +304,7 @@ namespace casadi {
     for (int i=0; i<n_out_; ++i) res1[i] = 0;
     res1[iout_] = tmp2;
     arg1[iin_] = 0; // just a guess
-    if (oracle_.rev(arg1, res1, iw, w, 0)) return 1;
+    if (oracle_.rev(arg1, res1, iw, w, mem_oracle)) return 1;
     return 0;
   }
 
@@ -427,4 +429,9 @@ namespace casadi {
     }
   }
 
+  void Rootfinder::serialize_body(SerializingStream& s) const {
+    s.pack(std::string(plugin_name()));
+    OracleFunction::serialize_body(s);
+  }
+
 } // namespace casadi
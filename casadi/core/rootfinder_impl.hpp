@@ -79,6 +79,15 @@ namespace casadi {
     const Options& get_options() const override { return options_;}
     ///@}
 
+    /** \brief Class name identifying the deserializer */
+    std::string serialize_class() const override { return "Rootfinder";}
+
+    /** \brief Serialize the plugin name followed by the oracle */
+    void serialize_body(SerializingStream& s) const override;
+
+    /** \brief Deserialize, instantiating the plugin */
+    static Function deserialize(DeserializingStream& s) { return deserialize_plugin<Rootfinder>(s);}
+
     /// Initialize
     void init(const Dict& opts) override;
 
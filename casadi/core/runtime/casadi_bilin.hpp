@@ -3,12 +3,32 @@
 template<typename T1>
 T1 casadi_bilin(const T1* A, const int* sp_A, const T1* x, const T1* y) {
   // Get sparsities
-  int ncol_A = sp_A[1];
+  int nrow_A = sp_A[0], ncol_A = sp_A[1];
   const int *colind_A = sp_A+2, *row_A = sp_A + 2 + ncol_A+1;
   // Return value
-  T1 ret=0;
+  T1 ret=0, s0, s1, s2, s3;
+  const T1 *A0, *A1, *A2, *A3;
   // Loop over the columns of A
   int cc, rr, el;
+  if (colind_A[ncol_A]==nrow_A*ncol_A) {
+    // Dense A: dot products with four columns at a time
+    for (cc=0; cc+4<=ncol_A; cc+=4) {
+      A0 = A+cc*nrow_A; A1 = A0+nrow_A; A2 = A1+nrow_A; A3 = A2+nrow_A;
+      s0 = s1 = s2 = s3 = 0;
+      for (rr=0; rr<nrow_A; ++rr) {
+        s0 += A0[rr]*x[rr]; s1 += A1[rr]*x[rr]; s2 += A2[rr]*x[rr]; s3 += A3[rr]*x[rr];
+      }
+      ret += s0*y[cc] + s1*y[cc+1] + s2*y[cc+2] + s3*y[cc+3];
+    }
+    // Remaining columns
+    for (; cc<ncol_A; ++cc) {
+      A0 = A+cc*nrow_A;
+      s0 = 0;
+      for (rr=0; rr<nrow_A; ++rr) s0 += A0[rr]*x[rr];
+      ret += s0*y[cc];
+    }
+    return ret;
+  }
   for (cc=0; cc<ncol_A; ++cc) {
     // Loop over the nonzeros of A
     for (el=colind_A[cc]; el<colind_A[cc+1]; ++el) {
@@ -10,8 +10,8 @@ void casadi_interpn_weights(int ndim, const T1* grid, const int* offset, const T
     // Grid
     const T1* g = grid + offset[i];
     int ng = offset[i+1]-offset[i];
-    // Find left index
-    int j = index[i] = casadi_low(xi, g, ng, lookup_mode[i]);
+    // Find left index, using the previous one as a hint
+    int j = index[i] = casadi_low(xi, g, ng, lookup_mode[i], index[i]);
     // Get interpolation/extrapolation alpha
     alpha[i] = (xi-g[j])/(g[j+1]-g[j]);
   }
@@ -0,0 +1,281 @@
+// NOLINT(legal/copyright)
+// SYMBOL "ipqp_prob"
+// Problem structure of a QP solved with casadi_ipqp:
+// minimize 1/2*x'*H*x + g'*x subject to lbx <= x <= ubx, lba <= A*x <= uba
+template<typename T1>
+struct casadi_ipqp_prob {
+  // Number of variables and constraints
+  int nx, na;
+  // Sparsity patterns of H and A
+  const int *sp_h, *sp_a;
+  // Sparsity pattern of the permuted KKT matrix (upper triangular part) and its L factor
+  const int *sp_kkt, *sp_l;
+  // Elimination tree of the permuted KKT matrix, fill-reducing permutation
+  const int *parent, *perm;
+  // KKT nonzero corresponding to each nonzero of H (-1 if not used), A and the diagonal
+  const int *kkt_h, *kkt_a, *kkt_d;
+  // Convergence tolerance, regularization, smallest initial slack and multiplier
+  T1 tol, reg, s0;
+  // Maximum number of iterations
+  int max_iter;
+};
+// C-REPLACE "casadi_ipqp_prob<T1>" "struct casadi_ipqp_prob"
+
+// SYMBOL "ipqp_work"
+// Work vector sizes for casadi_ipqp
+template<typename T1>
+void casadi_ipqp_work(const casadi_ipqp_prob<T1>* p, int* sz_iw, int* sz_w) {
+  int nz = p->nx + p->na;
+  *sz_iw = 3*nz;
+  *sz_w = 25*nz + p->sp_kkt[2+nz] + p->sp_l[2+nz];
+}
+
+// SYMBOL "ipqp"
+// Sparse primal-dual interior point method with Mehrotra's predictor-corrector.
+// The bounds are imposed on z = [x; A*x], with slacks for the finite lower and upper
+// bounds. Equal lower and upper bounds are treated as equality constraints. After
+// elimination of the slacks, each iteration factorizes the quasidefinite system
+// [H + S_x + reg*I, A'; A, -inv(S_a + reg*I)] with a sparse LDL^T factorization, S
+// being the diagonal barrier Hessian. x0, lam_x0 and lam_a0 are used for warm starts.
+// Returns 0 if converged, 1 if the maximum number of iterations was reached and 2
+// if the iterations failed.
+// len[iw] >= 3*(nx+na), len[w] given by casadi_ipqp_work
+template<typename T1>
+int casadi_ipqp(const casadi_ipqp_prob<T1>* p, const T1* h, const T1* g, const T1* a,
+                const T1* lbx, const T1* ubx, const T1* lba, const T1* uba,
+                const T1* x0, const T1* lam_x0, const T1* lam_a0,
+                T1* x, T1* f, T1* lam_a, T1* lam_x, int* iter, int* iw, T1* w) {
+  // Local variables
+  int nx, na, nz, nnz_h, nnz_a, nnz_kkt, i, k, m, flag, has_eq_x;
+  T1 mu, mu_aff, sigma, alpha, pr, du;
+  T1 *z, *lbz, *ubz, *lam, *sl, *su, *ll, *lu, *dz, *dlam, *dsl, *dsu, *dll, *dlu,
+     *sig, *c, *rl, *ru, *rcl, *rcu, *rd, *v, *kkt, *l, *d, *rhs, *lw;
+  // Dimensions
+  nx = p->nx;
+  na = p->na;
+  nz = nx + na;
+  nnz_h = p->sp_h[2+p->sp_h[1]];
+  nnz_a = p->sp_a[2+p->sp_a[1]];
+  nnz_kkt = p->sp_kkt[2+nz];
+  // Work vectors
+  z = w; w += nz;
+  lbz = w; w += nz;
+  ubz = w; w += nz;
+  lam = w; w += nz;
+  sl = w; w += nz;
+  su = w; w += nz;
+  ll = w; w += nz;
+  lu = w; w += nz;
+  dz = w; w += nz;
+  dlam = w; w += nz;
+  dsl = w; w += nz;
+  dsu = w; w += nz;
+  dll = w; w += nz;
+  dlu = w; w += nz;
+  sig = w; w += nz;
+  c = w; w += nz;
+  rl = w; w += nz;
+  ru = w; w += nz;
+  rcl = w; w += nz;
+  rcu = w; w += nz;
+  rd = w; w += nz;
+  v = w; w += nz;
+  rhs = w; w += nz;
+  d = w; w += nz;
+  lw = w; w += nz;
+  kkt = w; w += nnz_kkt;
+  l = w;
+  // Bounds on z
+  casadi_copy(lbx, nx, lbz);
+  casadi_copy(lba, na, lbz+nx);
+  casadi_copy(ubx, nx, ubz);
+  casadi_copy(uba, na, ubz+nx);
+  // Initial guess, slacks and multipliers for the inequality constraints
+  casadi_copy(x0, nx, z);
+  casadi_fill(z+nx, na, 0.);
+  casadi_mv(a, p->sp_a, z, z+nx, 0);
+  casadi_copy(lam_x0, nx, lam);
+  casadi_copy(lam_a0, na, lam+nx);
+  m = 0;
+  has_eq_x = 0;
+  for (i=0; i<nz; ++i) {
+    sl[i] = su[i] = ll[i] = lu[i] = 0;
+    if (lbz[i]==ubz[i]) {
+      if (i<nx) has_eq_x = 1;
+      continue;
+    }
+    if (isfinite(lbz[i])) {
+      sl[i] = fmax(z[i]-lbz[i], p->s0);
+      ll[i] = fmax(-lam[i], p->s0);
+      m++;
+    }
+    if (isfinite(ubz[i])) {
+      su[i] = fmax(ubz[i]-z[i], p->s0);
+      lu[i] = fmax(lam[i], p->s0);
+      m++;
+    }
+    lam[i] = lu[i] - ll[i];
+  }
+  flag = 0;
+  alpha = 1;
+  for (*iter=0; ; ++*iter) {
+    // Dual residual
+    casadi_copy(g, nx, rd);
+    casadi_mv(h, p->sp_h, z, rd, 0);
+    casadi_axpy(nx, 1., lam, rd);
+    casadi_mv(a, p->sp_a, lam+nx, rd, 1);
+    du = casadi_norm_inf(nx, rd);
+    // Primal residuals and complementarity
+    pr = mu = 0;
+    for (i=0; i<nz; ++i) {
+      rl[i] = ru[i] = 0;
+      if (lbz[i]==ubz[i]) {
+        rl[i] = z[i] - lbz[i];
+      } else {
+        if (isfinite(lbz[i])) {
+          rl[i] = z[i] - lbz[i] - sl[i];
+          mu += sl[i]*ll[i];
+        }
+        if (isfinite(ubz[i])) {
+          ru[i] = ubz[i] - z[i] - su[i];
+          mu += su[i]*lu[i];
+        }
+      }
+      pr = fmax(pr, fmax(fabs(rl[i]), fabs(ru[i])));
+    }
+    if (m>0) mu /= m;
+    // Termination
+    if (pr<=p->tol && du<=p->tol && mu<=p->tol) break;
+    if (!isfinite(pr+du+mu)) {
+      flag = 2;
+      break;
+    }
+    if (*iter>=p->max_iter) {
+      flag = 1;
+      break;
+    }
+    // Barrier Hessian
+    for (i=0; i<nz; ++i) {
+      sig[i] = 0;
+      if (lbz[i]==ubz[i]) {
+        sig[i] = 1./p->reg;
+      } else {
+        if (isfinite(lbz[i])) sig[i] += ll[i]/sl[i];
+        if (isfinite(ubz[i])) sig[i] += lu[i]/su[i];
+      }
+    }
+    // Assemble and factorize the KKT matrix
+    casadi_fill(kkt, nnz_kkt, 0.);
+    if (h) {
+      for (k=0; k<nnz_h; ++k) if (p->kkt_h[k]>=0) kkt[p->kkt_h[k]] += h[k];
+    }
+    if (a) {
+      for (k=0; k<nnz_a; ++k) kkt[p->kkt_a[k]] += a[k];
+    }
+    for (i=0; i<nx; ++i) kkt[p->kkt_d[i]] += sig[i] + p->reg;
+    for (i=nx; i<nz; ++i) kkt[p->kkt_d[i]] -= 1./(sig[i] + p->reg);
+    casadi_ldl(p->sp_kkt, p->parent, p->sp_l, kkt, l, d, iw, lw);
+    for (i=0; i<nz; ++i) if (d[i]==0) flag = 2;
+    if (flag) break;
+    // Predictor (k=0) and corrector (k=1) steps
+    for (k=0; k<2; ++k) {
+      // Right-hand sides of the complementarity conditions
+      if (k==0) {
+        for (i=0; i<nz; ++i) {
+          rcl[i] = -sl[i]*ll[i];
+          rcu[i] = -su[i]*lu[i];
+        }
+      } else {
+        // Centering parameter from the complementarity after the affine step
+        mu_aff = 0;
+        for (i=0; i<nz; ++i) {
+          mu_aff += (sl[i] + alpha*dsl[i])*(ll[i] + alpha*dll[i]);
+          mu_aff += (su[i] + alpha*dsu[i])*(lu[i] + alpha*dlu[i]);
+        }
+        if (m>0) mu_aff /= m;
+        sigma = mu>0 ? mu_aff/mu : 0;
+        sigma = sigma*sigma*sigma;
+        for (i=0; i<nz; ++i) {
+          if (isfinite(lbz[i])) rcl[i] = sigma*mu - sl[i]*ll[i] - dsl[i]*dll[i];
+          if (isfinite(ubz[i])) rcu[i] = sigma*mu - su[i]*lu[i] - dsu[i]*dlu[i];
+        }
+      }
+      // Eliminate the slacks: dlam = sig*dz + c
+      for (i=0; i<nz; ++i) {
+        if (lbz[i]==ubz[i]) {
+          c[i] = rl[i]/p->reg;
+        } else if (isfinite(lbz[i]) || isfinite(ubz[i])) {
+          c[i] = 0;
+          if (isfinite(lbz[i])) c[i] -= (rcl[i] - ll[i]*rl[i])/sl[i];
+          if (isfinite(ubz[i])) c[i] += (rcu[i] - lu[i]*ru[i])/su[i];
+        } else {
+          c[i] = -lam[i];
+        }
+      }
+      // Solve the KKT system for [dx; dlam_a]
+      for (i=0; i<nx; ++i) rhs[i] = -rd[i] - c[i];
+      for (i=nx; i<nz; ++i) rhs[i] = -c[i]/(sig[i] + p->reg);
+      for (i=0; i<nz; ++i) lw[i] = rhs[p->perm[i]];
+      casadi_ldl_solve(lw, 1, p->sp_l, l, d);
+      for (i=0; i<nz; ++i) rhs[p->perm[i]] = lw[i];
+      // Primal step
+      casadi_copy(rhs, nx, dz);
+      casadi_fill(dz+nx, na, 0.);
+      casadi_mv(a, p->sp_a, dz, dz+nx, 0);
+      // Dual step
+      casadi_copy(rhs+nx, na, dlam+nx);
+      for (i=0; i<nx; ++i) dlam[i] = sig[i]*dz[i] + c[i];
+      if (has_eq_x) {
+        // Multipliers for fixed variables from the stationarity conditions
+        casadi_fill(v, nx, 0.);
+        casadi_mv(h, p->sp_h, dz, v, 0);
+        casadi_mv(a, p->sp_a, dlam+nx, v, 1);
+        for (i=0; i<nx; ++i) if (lbz[i]==ubz[i]) dlam[i] = -rd[i] - v[i];
+      }
+      // Slack steps
+      for (i=0; i<nz; ++i) {
+        dsl[i] = dll[i] = dsu[i] = dlu[i] = 0;
+        if (lbz[i]==ubz[i]) continue;
+        if (isfinite(lbz[i])) {
+          dsl[i] = dz[i] + rl[i];
+          dll[i] = (rcl[i] - ll[i]*dsl[i])/sl[i];
+        }
+        if (isfinite(ubz[i])) {
+          dsu[i] = ru[i] - dz[i];
+          dlu[i] = (rcu[i] - lu[i]*dsu[i])/su[i];
+        }
+      }
+      // Largest step keeping slacks and multipliers positive
+      alpha = 1;
+      for (i=0; i<nz; ++i) {
+        if (dsl[i]<0) alpha = fmin(alpha, -sl[i]/dsl[i]);
+        if (dll[i]<0) alpha = fmin(alpha, -ll[i]/dll[i]);
+        if (dsu[i]<0) alpha = fmin(alpha, -su[i]/dsu[i]);
+        if (dlu[i]<0) alpha = fmin(alpha, -lu[i]/dlu[i]);
+      }
+    }
+    // Take the step, staying away from the boundary
+    alpha = fmin(1., 0.995*alpha);
+    casadi_axpy(nz, alpha, dz, z);
+    casadi_axpy(nz, alpha, dsl, sl);
+    casadi_axpy(nz, alpha, dsu, su);
+    casadi_axpy(nz, alpha, dll, ll);
+    casadi_axpy(nz, alpha, dlu, lu);
+    for (i=0; i<nz; ++i) {
+      if (lbz[i]!=ubz[i] && (isfinite(lbz[i]) || isfinite(ubz[i]))) {
+        lam[i] = lu[i] - ll[i];
+      } else {
+        lam[i] += alpha*dlam[i];
+      }
+    }
+  }
+  // Get solution
+  casadi_copy(z, nx, x);
+  casadi_copy(lam, nx, lam_x);
+  casadi_copy(lam+nx, na, lam_a);
+  if (f) {
+    *f = h ? casadi_bilin(h, p->sp_h, z, z)/2 : 0;
+    if (g) *f += casadi_dot(nx, g, z);
+  }
+  return flag;
+}
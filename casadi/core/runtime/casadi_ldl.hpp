@@ -79,7 +79,7 @@ void casadi_ldl_row(const int* sp, const int* parent, int* l_colind, int* l_row,
 // Calculate the nonzeros of the L factor (strictly lower entries only)
 // as well as D for an LDL^T factorization
 // Ref: User Guide for LDL by Tim Davis
-// len[iw] >= 2*n
+// len[iw] >= 3*n
 // len[w] >= n
 template<typename T1>
 void casadi_ldl(const int* sp_a, const int* parent, const int* sp_l,
@@ -91,9 +91,10 @@ void casadi_ldl(const int* sp_a, const int* parent, const int* sp_l,
   // Work vectors
   int *visited=iw; iw+=n;
   int *currcol=iw; iw+=n;
+  int *pattern=iw; iw+=n;
   T1* y = w; w+=n;
   // Local variables
-  int r, c, k, k2;
+  int r, c, k, k2, len, top;
   T1 yr;
   // Keep track of current nonzero for each column of L
   for (c=0; c<n; ++c) currcol[c] = l_colind[c];
@@ -103,23 +104,145 @@ void casadi_ldl(const int* sp_a, const int* parent, const int* sp_l,
     visited[c] = c;
     // Get nonzeros of column c in a dense vector
     y[c]=0; // Make sure y is all-zero until index c
-    for (k=colind[c]; k<colind[c+1] && (r=row[k])<=c; ++k) y[r] = a[k];
+    top = n;
+    for (k=colind[c]; k<colind[c+1] && (r=row[k])<=c; ++k) {
+      y[r] = a[k];
+      // Follow path from r to root of etree, stop at visited node
+      for (len=0; visited[r]!=c; r=parent[r]) {
+        pattern[len++] = r;
+        visited[r] = c; // mark r as visited
+      }
+      // Push path onto the stack, L(c,:) pattern in topological order
+      while (len>0) pattern[--top] = pattern[--len];
+    }
     // Get D(c,c) and clear Y(c)
     d[c] = y[c];
     y[c] = 0;
     // Loop over matching entries in L(:,c), i.e. L(c,:)
-    for (k=colind[c]; k<colind[c+1] && (r=row[k])<c; ++k) {
-      while (visited[r]!=c) {
-        // Get and clear y(r)
-        yr = y[r];
-        y[r] = 0;
-        for (k2=l_colind[r]; k2<l_colind[r+1]; ++k2) y[l_row[k2]] -= l[k2]*yr;
-        // The nonzero entry L(c,r)
-        d[c] -= (l[currcol[r]++]=yr/d[r]) * yr;
-        visited[r] = c; // mark r as visited
-        r=parent[r]; // proceed to parent row
+    for (; top<n; ++top) {
+      r = pattern[top];
+      // Get and clear y(r)
+      yr = y[r];
+      y[r] = 0;
+      // Only the entries of L(:,r) that have already been computed
+      for (k2=l_colind[r]; k2<currcol[r]; ++k2) y[l_row[k2]] -= l[k2]*yr;
+      // The nonzero entry L(c,r)
+      d[c] -= (l[currcol[r]++]=yr/d[r]) * yr;
+    }
+  }
+}
+
+// SYMBOL "ldl_sn"
+// Supernodal variant of casadi_ldl, same output but with dense kernels
+// Supernode s consists of the columns sn[s] to sn[s+1]-1 of L, which share
+// the same sparsity pattern below the diagonal block. Unlike casadi_ldl,
+// the sparsity pattern of A must be symmetric and the lower triangular
+// entries are used.
+// len[iw] >= 2*n + 3*nsn
+// len[w] >= maximum number of rows times maximum number of columns of a supernode
+template<typename T1>
+void casadi_ldl_sn(const int* sp_a, const int* sp_l, int nsn, const int* sn,
+                   const T1* a, T1* l, T1* d, int *iw, T1* w) {
+  // Extract sparsities
+  int n = sp_a[0];
+  const int *colind = sp_a+2, *row = sp_a+n+3;
+  const int *l_colind = sp_l+2, *l_row = sp_l+n+3;
+  // Work vectors
+  int *map=iw; iw+=n;
+  int *col2sn=iw; iw+=n;
+  int *head=iw; iw+=nsn;
+  int *next=iw; iw+=nsn;
+  int *pos=iw; iw+=nsn;
+  // Local variables
+  int s, t, tn, f, e, nc, len, ft, nct, lent, p0, p1, ld, r, i, j, k, kk, ii, jj, o, o2;
+  T1 c;
+  // Supernode of each column, no pending updates
+  for (s=0; s<nsn; ++s) {
+    head[s] = -1;
+    for (j=sn[s]; j<sn[s+1]; ++j) col2sn[j] = s;
+  }
+  // Loop over supernodes
+  for (s=0; s<nsn; ++s) {
+    f = sn[s];
+    e = sn[s+1];
+    nc = e-f;
+    // Rows of the supernode: f followed by the rows of L(:,f)
+    len = 1 + l_colind[f+1] - l_colind[f];
+    map[f] = 0;
+    for (i=1; i<len; ++i) map[l_row[l_colind[f]+i-1]] = i;
+    // Entry (ii, jj), ii>jj, of the supernode is stored in l at l_colind[f+jj]+ii-jj-1
+    for (jj=0; jj<nc; ++jj) {
+      j = f+jj;
+      d[j] = 0;
+      for (k=l_colind[j]; k<l_colind[j+1]; ++k) l[k] = 0;
+      for (k=colind[j]; k<colind[j+1]; ++k) {
+        r = row[k];
+        if (r==j) {
+          d[j] = a[k];
+        } else if (r>j) {
+          l[l_colind[j]+map[r]-jj-1] = a[k];
+        }
       }
     }
+    // Apply pending updates from descendant supernodes
+    t = head[s];
+    while (t>=0) {
+      tn = next[t];
+      ft = sn[t];
+      nct = sn[t+1]-ft;
+      lent = 1 + l_colind[ft+1] - l_colind[ft];
+      // Rows p0 to p1-1 of supernode t belong to supernode s
+      p0 = pos[t];
+      for (p1=p0; p1<lent && l_row[l_colind[ft]+p1-1]<e; ++p1) {}
+      // Dense product W = L_t(p0:lent,:) * D_t * L_t(p0:p1,:)^T, lower part
+      ld = lent-p0;
+      for (i=0; i<ld*(p1-p0); ++i) w[i] = 0;
+      for (kk=0; kk<nct; ++kk) {
+        o = l_colind[ft+kk]-kk-1;
+        for (jj=p0; jj<p1; ++jj) {
+          c = d[ft+kk]*l[o+jj];
+          o2 = (jj-p0)*ld-p0;
+          for (i=jj; i<lent; ++i) w[o2+i] += c*l[o+i];
+        }
+      }
+      // Subtract W from supernode s
+      for (jj=p0; jj<p1; ++jj) {
+        j = l_row[l_colind[ft]+jj-1]-f;
+        o2 = (jj-p0)*ld-p0;
+        d[f+j] -= w[o2+jj];
+        for (i=jj+1; i<lent; ++i) {
+          ii = map[l_row[l_colind[ft]+i-1]];
+          l[l_colind[f+j]+ii-j-1] -= w[o2+i];
+        }
+      }
+      // Move t to the supernode of its next row
+      pos[t] = p1;
+      if (p1<lent) {
+        r = col2sn[l_row[l_colind[ft]+p1-1]];
+        next[t] = head[r];
+        head[r] = t;
+      }
+      t = tn;
+    }
+    // Dense LDL^T factorization of the supernode
+    for (jj=0; jj<nc; ++jj) {
+      j = f+jj;
+      o = l_colind[j]-jj-1;
+      for (kk=0; kk<jj; ++kk) {
+        o2 = l_colind[f+kk]-kk-1;
+        c = d[f+kk]*l[o2+jj];
+        d[j] -= c*l[o2+jj];
+        for (ii=jj+1; ii<len; ++ii) l[o+ii] -= c*l[o2+ii];
+      }
+      for (ii=jj+1; ii<len; ++ii) l[o+ii] /= d[j];
+    }
+    // Schedule the update of the supernode of the first row below the block
+    pos[s] = nc;
+    if (nc<len) {
+      r = col2sn[l_row[l_colind[f]+nc-1]];
+      next[s] = head[r];
+      head[r] = s;
+    }
   }
 }
 
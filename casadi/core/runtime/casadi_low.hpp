@@ -1,18 +1,56 @@
 // NOLINT(legal/copyright)
 // SYMBOL "low"
 template<typename T1>
-int casadi_low(T1 x, const double* grid, int ng, int lookup_mode) {
-  if (lookup_mode) {
+int casadi_low(T1 x, const double* grid, int ng, int lookup_mode, int hint) {
+  int i, lo, hi, mid, step;
+  if (lookup_mode==1) {
+    // Exact: floored division (uniform grids)
     double g0 = grid[0];
     int ret = (int) ((x-g0)*(ng-1)/(grid[ng-1]-g0)); // NOLINT(readability/casting)
     if (ret<0) ret=0;
     if (ret>ng-2) ret=ng-2;
     return ret;
-  } else {
-    int i;
+  } else if (lookup_mode==0) {
+    // Linear: for-loop + break
     for (i=0; i<ng-2; ++i) {
       if (x < grid[i+1]) break;
     }
     return i;
   }
+  // Bracket lo <= result < hi
+  lo = 0;
+  hi = ng-1;
+  if (lookup_mode==3) {
+    // Hint: bracket the result with increasing steps away from the hint
+    step = 1;
+    lo = hint<0 ? 0 : hint>ng-2 ? ng-2 : hint;
+    if (lo<ng-2 && !(x < grid[lo+1])) {
+      // Search upwards
+      lo++;
+      for (hi=lo+1; hi<ng-1 && !(x < grid[hi]); hi=lo+step) {
+        lo = hi;
+        step *= 2;
+      }
+      if (hi>ng-1) hi = ng-1;
+    } else {
+      // Search downwards
+      hi = lo+1;
+      while (lo>0 && x < grid[lo]) {
+        hi = lo;
+        lo -= step;
+        step *= 2;
+        if (lo<0) lo = 0;
+      }
+    }
+  }
+  // Binary search
+  while (hi-lo>1) {
+    mid = lo+(hi-lo)/2;
+    if (x < grid[mid]) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  return lo;
 }
@@ -0,0 +1,59 @@
+// NOLINT(legal/copyright)
+// SYMBOL "mtimes_dense"
+template<typename T1>
+void casadi_mtimes_dense(const T1* x, int nrow_x, int ncol_x, const T1* y, int ncol_y, T1* z) {
+  int i, j, k, ii, kk, i1, k1;
+  T1 a0, a1, a2, a3, b0, b1, b2, b3;
+  T1 c00, c10, c20, c30, c01, c11, c21, c31, c02, c12, c22, c32, c03, c13, c23, c33;
+  const T1 *xk, *y0, *y1, *y2, *y3;
+  T1 *z0, *z1, *z2, *z3;
+  if (!x || !y || !z) return;
+  // Loop over blocks of the inner dimension and of the rows
+  for (kk=0; kk<ncol_x; kk+=256) {
+    k1 = kk+256<ncol_x ? kk+256 : ncol_x;
+    for (ii=0; ii<nrow_x; ii+=64) {
+      i1 = ii+64<nrow_x ? ii+64 : nrow_x;
+      // Four columns of z at a time
+      for (j=0; j+4<=ncol_y; j+=4) {
+        y0 = y+j*ncol_x; y1 = y0+ncol_x; y2 = y1+ncol_x; y3 = y2+ncol_x;
+        z0 = z+j*nrow_x; z1 = z0+nrow_x; z2 = z1+nrow_x; z3 = z2+nrow_x;
+        // 4-by-4 tiles held in registers
+        for (i=ii; i+4<=i1; i+=4) {
+          c00=c10=c20=c30=c01=c11=c21=c31=c02=c12=c22=c32=c03=c13=c23=c33=0;
+          for (k=kk; k<k1; ++k) {
+            xk = x+i+k*nrow_x;
+            a0 = xk[0]; a1 = xk[1]; a2 = xk[2]; a3 = xk[3];
+            b0 = y0[k]; b1 = y1[k]; b2 = y2[k]; b3 = y3[k];
+            c00 += a0*b0; c10 += a1*b0; c20 += a2*b0; c30 += a3*b0;
+            c01 += a0*b1; c11 += a1*b1; c21 += a2*b1; c31 += a3*b1;
+            c02 += a0*b2; c12 += a1*b2; c22 += a2*b2; c32 += a3*b2;
+            c03 += a0*b3; c13 += a1*b3; c23 += a2*b3; c33 += a3*b3;
+          }
+          z0[i] += c00; z0[i+1] += c10; z0[i+2] += c20; z0[i+3] += c30;
+          z1[i] += c01; z1[i+1] += c11; z1[i+2] += c21; z1[i+3] += c31;
+          z2[i] += c02; z2[i+1] += c12; z2[i+2] += c22; z2[i+3] += c32;
+          z3[i] += c03; z3[i+1] += c13; z3[i+2] += c23; z3[i+3] += c33;
+        }
+        // Remaining rows
+        for (; i<i1; ++i) {
+          c00=c01=c02=c03=0;
+          for (k=kk; k<k1; ++k) {
+            a0 = x[i+k*nrow_x];
+            c00 += a0*y0[k]; c01 += a0*y1[k]; c02 += a0*y2[k]; c03 += a0*y3[k];
+          }
+          z0[i] += c00; z1[i] += c01; z2[i] += c02; z3[i] += c03;
+        }
+      }
+      // Remaining columns
+      for (; j<ncol_y; ++j) {
+        y0 = y+j*ncol_x;
+        z0 = z+j*nrow_x;
+        for (k=kk; k<k1; ++k) {
+          b0 = y0[k];
+          xk = x+k*nrow_x;
+          for (i=ii; i<i1; ++i) z0[i] += xk[i]*b0;
+        }
+      }
+    }
+  }
+}
@@ -2,19 +2,41 @@
 // SYMBOL "mv_dense"
 template<typename T1>
 void casadi_mv_dense(const T1* x, int nrow_x, int ncol_x, const T1* y, T1* z, int tr) {
-  if (!x || !y || !z) return;
   int i, j;
+  T1 s0, s1, s2, s3;
+  const T1 *x0, *x1, *x2, *x3;
+  if (!x || !y || !z) return;
   if (tr) {
-    for (i=0; i<ncol_x; ++i) {
+    // Dot products with four columns of x at a time
+    for (i=0; i+4<=ncol_x; i+=4) {
+      x0 = x+i*nrow_x; x1 = x0+nrow_x; x2 = x1+nrow_x; x3 = x2+nrow_x;
+      s0 = s1 = s2 = s3 = 0;
       for (j=0; j<nrow_x; ++j) {
-        z[i] += *x++ * y[j];
+        s0 += x0[j]*y[j]; s1 += x1[j]*y[j]; s2 += x2[j]*y[j]; s3 += x3[j]*y[j];
       }
+      z[i] += s0; z[i+1] += s1; z[i+2] += s2; z[i+3] += s3;
+    }
+    // Remaining columns
+    for (; i<ncol_x; ++i) {
+      x0 = x+i*nrow_x;
+      s0 = 0;
+      for (j=0; j<nrow_x; ++j) s0 += x0[j]*y[j];
+      z[i] += s0;
     }
   } else {
-    for (i=0; i<ncol_x; ++i) {
+    // Linear combination of four columns of x at a time
+    for (i=0; i+4<=ncol_x; i+=4) {
+      x0 = x+i*nrow_x; x1 = x0+nrow_x; x2 = x1+nrow_x; x3 = x2+nrow_x;
+      s0 = y[i]; s1 = y[i+1]; s2 = y[i+2]; s3 = y[i+3];
       for (j=0; j<nrow_x; ++j) {
-        z[j] += *x++ * y[i];
+        z[j] += x0[j]*s0 + x1[j]*s1 + x2[j]*s2 + x3[j]*s3;
       }
     }
+    // Remaining columns
+    for (; i<ncol_x; ++i) {
+      x0 = x+i*nrow_x;
+      s0 = y[i];
+      for (j=0; j<nrow_x; ++j) z[j] += x0[j]*s0;
+    }
   }
 }
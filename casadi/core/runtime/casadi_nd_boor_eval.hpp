@@ -24,7 +24,7 @@ void casadi_nd_boor_eval(T1* ret, int n_dims, const T1* all_knots, const int* of
     int n_b = n_knots-degree-1;
 
     T1 x = all_x[k];
-    int L = casadi_low(x, knots+degree, n_knots-2*degree, lookup_mode[k]);
+    int L = casadi_low(x, knots+degree, n_knots-2*degree, lookup_mode[k], starts[k]);
 
     int start = L;
     if (start>n_b-degree-1) start = n_b-degree-1;
@@ -86,6 +86,10 @@ namespace casadi {
   void casadi_mtimes(const T1* x, const int* sp_x, const T1* y, const int* sp_y,
                              T1* z, const int* sp_z, T1* w, int tr);
 
+  /// Dense matrix-matrix multiplication, cache-blocked: z <- z + x*y
+  template<typename T1>
+  void casadi_mtimes_dense(const T1* x, int nrow_x, int ncol_x, const T1* y, int ncol_y, T1* z);
+
   /// Sparse matrix-vector multiplication: z <- z + x*y
   template<typename T1>
   void casadi_mv(const T1* x, const int* sp_x, const T1* y, T1* z, int tr);
@@ -139,7 +143,7 @@ namespace casadi {
 
   // Find the interval to which a value belongs
   template<typename T1>
-  int casadi_low(T1 x, const double* grid, int ng, int lookup_mode);
+  int casadi_low(T1 x, const double* grid, int ng, int lookup_mode, int hint);
 
   // Get weights for the multilinear interpolant
   template<typename T1>
@@ -220,9 +224,11 @@ namespace casadi {
   #include "casadi_interpn.hpp"
   #include "casadi_interpn_grad.hpp"
   #include "casadi_mv_dense.hpp"
+  #include "casadi_mtimes_dense.hpp"
   #include "casadi_finite_diff.hpp"
   #include "casadi_ldl.hpp"
   #include "casadi_qr.hpp"
+  #include "casadi_ipqp.hpp"
 } // namespace casadi
 
 /// \endcond
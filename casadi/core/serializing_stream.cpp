@@ -0,0 +1,268 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "serializing_stream.hpp"
+#include "function_internal.hpp"
+#include "mx_node.hpp"
+
+using namespace std;
+
+namespace casadi {
+
+  // Identifies the format, followed by the version number
+  static const char* serialization_magic = "casadi_serialized";
+  static const int serialization_version = 1;
+
+  SerializingStream::SerializingStream(std::ostream& out) : out_(out) {
+    pack(string(serialization_magic));
+    pack(serialization_version);
+  }
+
+  DeserializingStream::DeserializingStream(std::istream& in) : in_(in) {
+    string magic;
+    int version;
+    unpack(magic);
+    casadi_assert(magic==serialization_magic, "Not a serialized CasADi object");
+    unpack(version);
+    casadi_assert(version==serialization_version,
+      "Serialization format version " + str(version) + " is not supported, "
+      "expected version " + str(serialization_version));
+  }
+
+  void DeserializingStream::assert_good() {
+    casadi_assert(in_.good(), "Unexpected end of serialized data");
+  }
+
+  void SerializingStream::pack(bool e) {
+    char c = e;
+    out_.put(c);
+  }
+
+  void DeserializingStream::unpack(bool& e) {
+    char c;
+    in_.get(c);
+    assert_good();
+    e = c!=0;
+  }
+
+  void SerializingStream::pack(int e) {
+    out_.write(reinterpret_cast<const char*>(&e), sizeof(int));
+  }
+
+  void DeserializingStream::unpack(int& e) {
+    in_.read(reinterpret_cast<char*>(&e), sizeof(int));
+    assert_good();
+  }
+
+  void SerializingStream::pack(double e) {
+    out_.write(reinterpret_cast<const char*>(&e), sizeof(double));
+  }
+
+  void DeserializingStream::unpack(double& e) {
+    in_.read(reinterpret_cast<char*>(&e), sizeof(double));
+    assert_good();
+  }
+
+  void SerializingStream::pack(const std::string& e) {
+    pack(static_cast<int>(e.size()));
+    out_.write(e.data(), e.size());
+  }
+
+  void DeserializingStream::unpack(std::string& e) {
+    int n;
+    unpack(n);
+    casadi_assert(n>=0, "Corrupted serialized data");
+    e.resize(n);
+    if (n>0) in_.read(&e[0], n);
+    assert_good();
+  }
+
+  void SerializingStream::pack(const Sparsity& e) {
+    casadi_assert(!e.is_null(), "Cannot serialize a null sparsity pattern");
+    // Reference to a pattern already serialized
+    auto it = sparsities_.find(e.get());
+    if (it!=sparsities_.end()) return pack(it->second);
+    // New pattern, index followed by definition
+    int ind = sparsities_.size();
+    sparsities_[e.get()] = ind;
+    pack(ind);
+    pack(e.size1());
+    pack(e.size2());
+    pack(e.get_colind());
+    pack(e.get_row());
+  }
+
+  void DeserializingStream::unpack(Sparsity& e) {
+    int ind;
+    unpack(ind);
+    if (ind>=0 && ind<sparsities_.size()) {
+      e = sparsities_[ind];
+    } else {
+      casadi_assert(ind==sparsities_.size(), "Corrupted serialized data");
+      int nrow, ncol;
+      vector<int> colind, row;
+      unpack(nrow);
+      unpack(ncol);
+      unpack(colind);
+      unpack(row);
+      e = Sparsity(nrow, ncol, colind, row);
+      sparsities_.push_back(e);
+    }
+  }
+
+  void SerializingStream::pack(const DM& e) {
+    pack(e.sparsity());
+    pack(e.nonzeros());
+  }
+
+  void DeserializingStream::unpack(DM& e) {
+    Sparsity sp;
+    vector<double> nz;
+    unpack(sp);
+    unpack(nz);
+    e = DM(sp, nz);
+  }
+
+  void SerializingStream::pack(const MX& e) {
+    // Serialize the nodes not yet serialized, dependencies first
+    vector<pair<const MXNode*, int> > stack;
+    if (!nodes_.count(e.get())) stack.push_back(make_pair(e.get(), 0));
+    while (!stack.empty()) {
+      const MXNode* n = stack.back().first;
+      int ch = stack.back().second++;
+      if (ch<n->n_dep()) {
+        const MXNode* d = n->dep(ch).get();
+        if (!nodes_.count(d)) stack.push_back(make_pair(d, 0));
+      } else if (nodes_.count(n)) {
+        // Already serialized, e.g. as part of a called function
+        stack.pop_back();
+      } else {
+        // All dependencies serialized, index followed by definition
+        int ind = nodes_.size();
+        nodes_[n] = ind;
+        pack(ind);
+        n->serialize(*this);
+        stack.pop_back();
+      }
+    }
+    // Reference to the node
+    pack(nodes_.at(e.get()));
+  }
+
+  void DeserializingStream::unpack(MX& e) {
+    int ind;
+    unpack(ind);
+    // Definitions of new nodes
+    while (ind==nodes_.size()) {
+      // Reserve the index, nodes of called functions come after
+      nodes_.push_back(MX());
+      nodes_[ind] = MXNode::deserialize(*this);
+      unpack(ind);
+    }
+    casadi_assert(ind>=0 && ind<nodes_.size(), "Corrupted serialized data");
+    e = nodes_[ind];
+  }
+
+  void SerializingStream::pack(const Function& e) {
+    // Null function
+    if (e.is_null()) return pack(-1);
+    // Reference to a function already serialized
+    auto it = functions_.find(e.get());
+    if (it!=functions_.end()) return pack(it->second);
+    // New function, index followed by definition
+    int ind = functions_.size();
+    functions_[e.get()] = ind;
+    pack(ind);
+    e->serialize(*this);
+  }
+
+  void DeserializingStream::unpack(Function& e) {
+    int ind;
+    unpack(ind);
+    if (ind<0) {
+      e = Function();
+    } else if (ind<functions_.size()) {
+      casadi_assert(!functions_[ind].is_null(), "Corrupted serialized data");
+      e = functions_[ind];
+    } else {
+      casadi_assert(ind==functions_.size(), "Corrupted serialized data");
+      // Reserve the index, functions referenced by the definition come after
+      functions_.push_back(Function());
+      e = FunctionInternal::deserialize(*this);
+      functions_[ind] = e;
+    }
+  }
+
+  void SerializingStream::pack(const GenericType& e) {
+    pack(static_cast<int>(e.getType()));
+    switch (e.getType()) {
+      case OT_NULL: break;
+      case OT_BOOL: pack(e.as_bool()); break;
+      case OT_INT: pack(e.as_int()); break;
+      case OT_DOUBLE: pack(e.as_double()); break;
+      case OT_STRING: pack(e.as_string()); break;
+      case OT_INTVECTOR: pack(e.as_int_vector()); break;
+      case OT_INTVECTORVECTOR: pack(e.as_int_vector_vector()); break;
+      case OT_BOOLVECTOR: pack(e.as_bool_vector()); break;
+      case OT_DOUBLEVECTOR: pack(e.as_double_vector()); break;
+      case OT_STRINGVECTOR: pack(e.as_string_vector()); break;
+      case OT_DICT: pack(e.as_dict()); break;
+      case OT_FUNCTION: pack(e.as_function()); break;
+      case OT_FUNCTIONVECTOR: pack(e.as_function_vector()); break;
+      default:
+        casadi_error("Cannot serialize a GenericType of type " + e.get_description());
+    }
+  }
+
+  void DeserializingStream::unpack(GenericType& e) {
+    int t;
+    unpack(t);
+    switch (t) {
+      case OT_NULL: e = GenericType(); break;
+      case OT_BOOL: { bool v; unpack(v); e = v; break; }
+      case OT_INT: { int v; unpack(v); e = v; break; }
+      case OT_DOUBLE: { double v; unpack(v); e = v; break; }
+      case OT_STRING: { string v; unpack(v); e = v; break; }
+      case OT_INTVECTOR: { vector<int> v; unpack(v); e = v; break; }
+      case OT_INTVECTORVECTOR: { vector<vector<int> > v; unpack(v); e = v; break; }
+      case OT_BOOLVECTOR:
+        {
+          vector<int> v;
+          unpack(v);
+          e = vector<bool>(v.begin(), v.end());
+          break;
+        }
+      case OT_DOUBLEVECTOR: { vector<double> v; unpack(v); e = v; break; }
+      case OT_STRINGVECTOR: { vector<string> v; unpack(v); e = v; break; }
+      case OT_DICT: { Dict v; unpack(v); e = v; break; }
+      case OT_FUNCTION: { Function v; unpack(v); e = v; break; }
+      case OT_FUNCTIONVECTOR: { vector<Function> v; unpack(v); e = v; break; }
+      default:
+        casadi_error("Corrupted serialized data");
+    }
+  }
+
+} // namespace casadi
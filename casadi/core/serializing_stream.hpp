@@ -0,0 +1,154 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_SERIALIZING_STREAM_HPP
+#define CASADI_SERIALIZING_STREAM_HPP
+
+#include "function.hpp"
+#include <iostream>
+#include <unordered_map>
+
+/// \cond INTERNAL
+namespace casadi {
+
+  class MXNode;
+
+  /** \brief Helper class for serialization
+
+      Writes objects to a stream in a versioned binary format. Shared objects
+      (functions, sparsity patterns and MX nodes) are written only once and are
+      referenced by index thereafter.
+  */
+  class CASADI_EXPORT SerializingStream {
+  public:
+    /// Constructor, writes the header
+    explicit SerializingStream(std::ostream& out);
+
+    ///@{
+    /// Serialize an object
+    void pack(bool e);
+    void pack(int e);
+    void pack(double e);
+    void pack(const std::string& e);
+    void pack(const char* e) { pack(std::string(e));}
+    void pack(const Sparsity& e);
+    void pack(const DM& e);
+    void pack(const MX& e);
+    void pack(const Function& e);
+    void pack(const GenericType& e);
+    template<typename T>
+    void pack(const std::vector<T>& e) {
+      pack(static_cast<int>(e.size()));
+      for (auto&& i : e) pack(i);
+    }
+    void pack(const std::vector<bool>& e) {
+      pack(static_cast<int>(e.size()));
+      for (bool i : e) pack(i);
+    }
+    template<typename T>
+    void pack(const std::map<std::string, T>& e) {
+      pack(static_cast<int>(e.size()));
+      for (auto&& i : e) {
+        pack(i.first);
+        pack(i.second);
+      }
+    }
+    ///@}
+
+  private:
+    std::ostream& out_;
+    std::unordered_map<const void*, int> sparsities_;
+    std::unordered_map<const MXNode*, int> nodes_;
+    std::unordered_map<const FunctionInternal*, int> functions_;
+  };
+
+  /** \brief Helper class for deserialization
+
+      Reads objects written by SerializingStream.
+  */
+  class CASADI_EXPORT DeserializingStream {
+  public:
+    /// Constructor, reads and checks the header
+    explicit DeserializingStream(std::istream& in);
+
+    ///@{
+    /// Deserialize an object
+    void unpack(bool& e);
+    void unpack(int& e);
+    void unpack(double& e);
+    void unpack(std::string& e);
+    void unpack(Sparsity& e);
+    void unpack(DM& e);
+    void unpack(MX& e);
+    void unpack(Function& e);
+    void unpack(GenericType& e);
+    template<typename T>
+    void unpack(std::vector<T>& e) {
+      int n;
+      unpack(n);
+      casadi_assert(n>=0, "Corrupted serialized data");
+      e.resize(n);
+      for (auto&& i : e) unpack(i);
+    }
+    void unpack(std::vector<bool>& e) {
+      int n;
+      unpack(n);
+      casadi_assert(n>=0, "Corrupted serialized data");
+      e.resize(n);
+      for (int i=0; i<n; ++i) {
+        bool b;
+        unpack(b);
+        e[i] = b;
+      }
+    }
+    template<typename T>
+    void unpack(std::map<std::string, T>& e) {
+      int n;
+      unpack(n);
+      casadi_assert(n>=0, "Corrupted serialized data");
+      e.clear();
+      for (int i=0; i<n; ++i) {
+        std::string k;
+        unpack(k);
+        unpack(e[k]);
+      }
+    }
+    ///@}
+
+  private:
+    /// Make sure that the stream is still valid
+    void assert_good();
+
+    std::istream& in_;
+    std::vector<Sparsity> sparsities_;
+    std::vector<MX> nodes_;
+    std::vector<Function> functions_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_SERIALIZING_STREAM_HPP
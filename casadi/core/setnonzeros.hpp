@@ -71,6 +71,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return Add ? OP_ADDNONZEROS : OP_SETNONZEROS;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Get an IM representation of a GetNonzeros or SetNonzeros node
     Matrix<int> mapping() const override;
 
@@ -28,6 +28,7 @@
 
 #include "setnonzeros.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 /// \cond INTERNAL
 
@@ -826,6 +827,11 @@ namespace casadi {
       << " *tt " << (Add?"+=":"=") << " *ss++;\n";
   }
 
+  template<bool Add>
+  void SetNonzeros<Add>::serialize_body(SerializingStream& s) const {
+    s.pack(this->all());
+  }
+
 } // namespace casadi
 
 /// \endcond
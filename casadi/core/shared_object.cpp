@@ -25,6 +25,9 @@
 #include "shared_object_internal.hpp"
 #include "sparse_storage_impl.hpp"
 #include <typeinfo>
+#ifdef WITH_THREAD
+#include <mutex>
+#endif // WITH_THREAD
 
 using namespace std;
 namespace casadi {
@@ -32,6 +35,15 @@ namespace casadi {
   // Instantiate templates
   template class SparseStorage<WeakRef>;
 
+#ifdef WITH_THREAD
+  // Synchronizes reviving an object through a weak reference with its destruction,
+  // never destroyed since objects may be released during static deinitialization
+  static std::mutex& weak_ref_mutex() {
+    static std::mutex* m = new std::mutex();
+    return *m;
+  }
+#endif // WITH_THREAD
+
   SharedObject::SharedObject() {
     node = 0;
   }
@@ -131,14 +143,29 @@ namespace casadi {
   }
 
   bool WeakRef::alive() const {
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(weak_ref_mutex());
+#endif // WITH_THREAD
     return !is_null() && (*this)->raw_ != 0;
   }
 
   SharedObject WeakRef::shared() {
     SharedObject ret;
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(weak_ref_mutex());
+    SharedObjectInternal* raw = is_null() ? 0 : (*this)->raw_;
+    if (raw==0) return ret;
+    // An object whose last reference is being released cannot be revived
+    unsigned int c = raw->count.load();
+    do {
+      if (c==0) return ret;
+    } while (!raw->count.compare_exchange_weak(c, c+1));
+    ret.assign(raw);
+#else // WITH_THREAD
     if (alive()) {
       ret.own((*this)->raw_);
     }
+#endif // WITH_THREAD
     return ret;
   }
 
@@ -159,6 +186,9 @@ namespace casadi {
   }
 
   void WeakRef::kill() {
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(weak_ref_mutex());
+#endif // WITH_THREAD
     (*this)->raw_ = 0;
   }
 
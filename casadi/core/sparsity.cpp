@@ -27,7 +27,11 @@
 #include "matrix.hpp"
 #include "casadi_misc.hpp"
 #include "sparse_storage_impl.hpp"
+#include "serializing_stream.hpp"
 #include <climits>
+#ifdef WITH_THREAD
+#include <mutex>
+#endif // WITH_THREAD
 
 using namespace std;
 
@@ -492,6 +496,15 @@ namespace casadi {
     return ret;
   }
 
+#ifdef WITH_THREAD
+  // Guards the cache of sparsity patterns, never destroyed since patterns may be
+  // created during static deinitialization
+  static std::mutex& cache_mutex() {
+    static std::mutex* m = new std::mutex();
+    return *m;
+  }
+#endif // WITH_THREAD
+
   const Sparsity& Sparsity::getScalar() {
     static ScalarSparsity ret;
     return ret;
@@ -711,11 +724,12 @@ namespace casadi {
     (*this)->get_nz(indices);
   }
 
-  Sparsity Sparsity::uni_coloring(const Sparsity& AT, int cutoff) const {
+  Sparsity Sparsity::uni_coloring(const Sparsity& AT, int cutoff, int ordering,
+                                  int nthreads) const {
     if (AT.is_null()) {
-      return (*this)->uni_coloring(T(), cutoff);
+      return (*this)->uni_coloring(T(), cutoff, ordering, nthreads);
     } else {
-      return (*this)->uni_coloring(AT, cutoff);
+      return (*this)->uni_coloring(AT, cutoff, ordering, nthreads);
     }
   }
 
@@ -731,6 +745,14 @@ namespace casadi {
     return (*this)->largest_first();
   }
 
+  std::vector<int> Sparsity::smallest_last() const {
+    return (*this)->smallest_last();
+  }
+
+  std::vector<int> Sparsity::incidence_degree() const {
+    return (*this)->incidence_degree();
+  }
+
   Sparsity Sparsity::pmult(const std::vector<int>& p, bool permute_rows, bool permute_columns,
                            bool invert_permutation) const {
     return (*this)->pmult(p, permute_rows, permute_columns, invert_permutation);
@@ -740,6 +762,29 @@ namespace casadi {
     (*this)->spy_matlab(mfile);
   }
 
+  void Sparsity::serialize(std::ostream &stream) const {
+    SerializingStream s(stream);
+    s.pack(*this);
+  }
+
+  std::string Sparsity::serialize() const {
+    std::stringstream ss;
+    serialize(ss);
+    return ss.str();
+  }
+
+  Sparsity Sparsity::deserialize(std::istream& stream) {
+    DeserializingStream s(stream);
+    Sparsity ret;
+    s.unpack(ret);
+    return ret;
+  }
+
+  Sparsity Sparsity::deserialize(const std::string& s) {
+    std::stringstream ss(s);
+    return deserialize(ss);
+  }
+
   void Sparsity::export_code(const std::string& lang, std::ostream &stream,
       const Dict& options) const {
     (*this)->export_code(lang, stream, options);
@@ -790,6 +835,9 @@ namespace casadi {
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
     // Get a reference to the cache
+#ifdef WITH_THREAD
+    std::lock_guard<std::mutex> lock(cache_mutex());
+#endif // WITH_THREAD
     CachingMap& cache = getCache();
 
     // Record the current number of buckets (for garbage collection below)
@@ -807,11 +855,10 @@ namespace casadi {
         // Get a weak reference to the cached sparsity pattern
         WeakRef& wref = i->second;
 
-        // Check if the pattern still exists
-        if (wref.alive()) {
-
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        // Get an owning reference to the cached pattern, if it still exists
+        SharedObject obj = wref.shared();
+        if (!obj.is_null()) {
+          Sparsity ref = shared_cast<Sparsity>(obj);
 
           // Check if the pattern matches
           if (ref.is_equal(nrow, ncol, colind, row)) {
@@ -830,10 +877,10 @@ namespace casadi {
           CachingMap::iterator j=i;
           j++; // Start at the next matching key
           for (; j!=eq.second; ++j) {
-            if (j->second.alive()) {
-
-              // Recover cached sparsity
-              Sparsity ref = shared_cast<Sparsity>(j->second.shared());
+            // Recover cached sparsity
+            SharedObject obj_j = j->second.shared();
+            if (!obj_j.is_null()) {
+              Sparsity ref = shared_cast<Sparsity>(obj_j);
 
               // Match found if sparsity matches
               if (ref.is_equal(nrow, ncol, colind, row)) {
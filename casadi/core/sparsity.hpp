@@ -717,9 +717,22 @@ namespace casadi {
 #endif // SWIG
 
     /** \brief Perform a unidirectional coloring: A greedy distance-2 coloring algorithm
-        (Algorithm 3.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN) */
+        (Algorithm 3.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN)
+
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3).
+
+        With nthreads different from 1, a speculative parallel coloring with
+        conflict resolution is used, cf.
+          A Parallel Distance-2 Graph Coloring Algorithm for Distributed Memory Computers
+          D. BOZDAG, U. CATALYUREK, A. H. GEBREMEDHIN, F. MANNE, E. G. BOMAN, F. OZGUNER
+          HPCC 2005, LNCS 3726, pp. 796-806
+        The number of colors may then depend on the scheduling of the threads.
+        0 means the number of cores.
+    */
     Sparsity uni_coloring(const Sparsity& AT=Sparsity(),
-                                    int cutoff = std::numeric_limits<int>::max()) const;
+                          int cutoff = std::numeric_limits<int>::max(),
+                          int ordering = 0, int nthreads = 1) const;
 
     /** \brief Perform a star coloring of a symmetric matrix:
         A greedy distance-2 coloring algorithm
@@ -728,7 +741,8 @@ namespace casadi {
           A. H. GEBREMEDHIN, F. MANNE, A. POTHEN
           SIAM Rev., 47(4), 629–705 (2006)
 
-        Ordering options: None (0), largest first (1)
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3)
     */
     Sparsity star_coloring(int ordering = 1, int cutoff = std::numeric_limits<int>::max()) const;
 
@@ -739,13 +753,26 @@ namespace casadi {
           A. H. GEBREMEDHIN, A. TARAFDAR, F. MANNE, A. POTHEN
           SIAM J. SCI. COMPUT. Vol. 29, No. 3, pp. 1042–1072 (2007)
 
-        Ordering options: None (0), largest first (1)
+        Ordering options: None (0), largest first (1), smallest last (2),
+        incidence degree (3)
     */
     Sparsity star_coloring2(int ordering = 1, int cutoff = std::numeric_limits<int>::max()) const;
 
     /** \brief Order the columns by decreasing degree */
     std::vector<int> largest_first() const;
 
+    /** \brief Smallest last ordering of the columns
+
+        Columns are ordered in reverse order of removal, always removing a column
+        with the fewest remaining distance-2 neighbours (columns sharing a row). */
+    std::vector<int> smallest_last() const;
+
+    /** \brief Incidence degree ordering of the columns
+
+        Columns are ordered by always picking next a column with the most
+        distance-2 neighbours (columns sharing a row) among those already ordered. */
+    std::vector<int> incidence_degree() const;
+
     /** \brief Permute rows and/or columns
         Multiply the sparsity with a permutation matrix from the left and/or from the right
         P * A * trans(P), A * trans(P) or A * trans(P) with P defined by an index vector
@@ -792,6 +819,18 @@ namespace casadi {
     void export_code(const std::string& lang, std::ostream &stream=casadi::uout(),
        const Dict& options=Dict()) const;
 
+    /** \brief Serialize the pattern to a binary format */
+    std::string serialize() const;
+#ifndef SWIG
+    void serialize(std::ostream &stream) const;
+#endif // SWIG
+
+    /** \brief Deserialize a pattern written by serialize */
+    static Sparsity deserialize(const std::string& s);
+#ifndef SWIG
+    static Sparsity deserialize(std::istream& stream);
+#endif // SWIG
+
 #ifdef WITH_DEPRECATED_FEATURES
     /** \brief [DEPRECATED] Alias for disp */
     void print_compact(std::ostream &stream=casadi::uout()) const {
@@ -29,6 +29,9 @@
 #include <cstdlib>
 #include <cmath>
 #include "matrix.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <memory>
 
 using namespace std;
 
@@ -2627,7 +2630,15 @@ namespace casadi {
     fill(it, indices.end(), -1);
   }
 
-  Sparsity SparsityInternal::uni_coloring(const Sparsity& AT, int cutoff) const {
+  Sparsity SparsityInternal::uni_coloring(const Sparsity& AT, int cutoff, int ordering,
+                                          int nthreads) const {
+    // Reordered and/or parallel coloring
+    if (ordering!=0 || nthreads!=1) {
+      casadi_assert(nthreads>=0, "Number of threads must be nonnegative");
+      if (nthreads==0) nthreads = ThreadPool::instance().size();
+      vector<int> ord = ordering==0 ? range(size2()) : coloring_ordering(ordering);
+      return uni_coloring_ordered(AT, ord, cutoff, nthreads);
+    }
 
     // Allocate temporary vectors
     vector<int> forbiddenColors;
@@ -2716,21 +2727,136 @@ namespace casadi {
 ;
   }
 
+  /* Call f(j) for each distance-2 neighbour j of column i, i.e. each other column with a
+     nonzero in a row in common with column i. Each neighbour is visited once, provided that
+     mark contains no entry equal to stamp on entry. */
+  template<typename F>
+  static void d2_neighbors(int i, const int* colind, const int* row,
+                           const int* AT_colind, const int* AT_row,
+                           int* mark, int stamp, F f) {
+    mark[i] = stamp;
+    for (int el=colind[i]; el<colind[i+1]; ++el) {
+      int c = row[el];
+      for (int el2=AT_colind[c]; el2<AT_colind[c+1]; ++el2) {
+        int j = AT_row[el2];
+        if (mark[j]!=stamp) {
+          mark[j] = stamp;
+          f(j);
+        }
+      }
+    }
+  }
+
+  Sparsity SparsityInternal::uni_coloring_ordered(const Sparsity& AT, const vector<int>& ord,
+                                                  int cutoff, int nthreads) const {
+    int n = size2();
+    casadi_assert_dev(ord.size()==n);
+    const int* colind = this->colind();
+    const int* row = this->row();
+    const int* AT_colind = AT.colind();
+    const int* AT_row = AT.row();
+
+    // Position of each column in the ordering, decides which column of a conflict is recolored
+    vector<int> rank(n);
+    for (int k=0; k<n; ++k) rank[ord[k]] = k;
+
+    // Colors, -1 if not colored. Accessed concurrently, hence atomic
+    unique_ptr<atomic<int>[]> color(new atomic<int>[n]);
+    for (int i=0; i<n; ++i) color[i].store(-1, memory_order_relaxed);
+
+    // Work vectors for each thread
+    nthreads = max(1, nthreads);
+    vector<vector<int> > forbidden(nthreads), mark(nthreads), conflicts(nthreads);
+    vector<int> stamp(nthreads, 0);
+    for (int t=0; t<nthreads; ++t) mark[t].resize(n, -1);
+
+    // Columns remaining to be colored, initially all
+    vector<int> U = ord;
+    atomic<bool> interrupted(false);
+    while (!U.empty()) {
+      int nt = min(nthreads, static_cast<int>(U.size()));
+
+      // Color the columns tentatively, each thread handling a contiguous part of U
+      ThreadPool::instance().run(nt, [&](int t) {
+        vector<int>& fc = forbidden[t];
+        int* m = get_ptr(mark[t]);
+        int begin = U.size()*t/nt, end = U.size()*(t+1)/nt;
+        for (int k=begin; k<end && !interrupted.load(memory_order_relaxed); ++k) {
+          int i = U[k], s = stamp[t]++;
+
+          // Mark the colors of the distance-2 neighbours as forbidden
+          d2_neighbors(i, colind, row, AT_colind, AT_row, m, s, [&](int j) {
+            int cj = color[j].load(memory_order_relaxed);
+            if (cj>=0) {
+              if (cj>=fc.size()) fc.resize(cj+1, -1);
+              fc[cj] = s;
+            }
+          });
+
+          // Get the first nonforbidden color
+          int ci;
+          for (ci=0; ci<fc.size(); ++ci) {
+            if (fc[ci]!=s) break;
+          }
+
+          // Cutoff if too many colors
+          if (ci>=cutoff) {
+            interrupted = true;
+            break;
+          }
+          color[i].store(ci, memory_order_relaxed);
+        }
+      });
+      if (interrupted) return Sparsity();
+
+      // A single thread colors without conflicts
+      if (nt==1) break;
+
+      // Detect conflicts, the column later in the ordering is recolored
+      ThreadPool::instance().run(nt, [&](int t) {
+        int* m = get_ptr(mark[t]);
+        conflicts[t].clear();
+        int begin = U.size()*t/nt, end = U.size()*(t+1)/nt;
+        for (int k=begin; k<end; ++k) {
+          int i = U[k], ci = color[i].load(memory_order_relaxed);
+          bool conflict = false;
+          d2_neighbors(i, colind, row, AT_colind, AT_row, m, stamp[t]++, [&](int j) {
+            if (color[j].load(memory_order_relaxed)==ci && rank[j]<rank[i]) conflict = true;
+          });
+          if (conflict) conflicts[t].push_back(i);
+        }
+      });
+
+      // Columns to be recolored, in order
+      U.clear();
+      for (int t=0; t<nt; ++t) U.insert(U.end(), conflicts[t].begin(), conflicts[t].end());
+      for (int i : U) color[i].store(-1, memory_order_relaxed);
+    }
+
+    // Number of colors used
+    vector<int> color_v(n);
+    int num_colors = 0;
+    for (int i=0; i<n; ++i) {
+      color_v[i] = color[i].load(memory_order_relaxed);
+      num_colors = max(num_colors, color_v[i]+1);
+    }
+
+    // Return sparsity in sparse triplet format
+    return Sparsity::triplet(n, num_colors, range(n), color_v);
+  }
+
   Sparsity SparsityInternal::star_coloring2(int ordering, int cutoff) const {
     if (!is_square()) {
       // NOTE(@jaeandersson) Why warning and not error?
       casadi_message("StarColoring requires a square matrix, got " + dim() + ".");
     }
 
-    // TODO(Joel): What we need here, is a distance-2 smallest last ordering
     // Reorder, if necessary
     const int* colind = this->colind();
     const int* row = this->row();
     if (ordering!=0) {
-      casadi_assert_dev(ordering==1);
-
       // Ordering
-      vector<int> ord = largest_first();
+      vector<int> ord = coloring_ordering(ordering);
 
       // Create a new sparsity pattern
       Sparsity sp_permuted = pmult(ord, true, true, true);
@@ -2977,10 +3103,8 @@ namespace casadi {
 
     // Reorder, if necessary
     if (ordering!=0) {
-      casadi_assert_dev(ordering==1);
-
       // Ordering
-      vector<int> ord = largest_first();
+      vector<int> ord = coloring_ordering(ordering);
 
       // Create a new sparsity pattern
       Sparsity sp_permuted = pmult(ord, true, true, true);
@@ -3117,6 +3241,116 @@ namespace casadi {
     return reverse_ordering;
   }
 
+  /* Columns bucketed by an integer key in doubly linked lists,
+     supporting constant time insertion and removal */
+  struct ColumnBuckets {
+    vector<int> head, next, prev, key;
+    ColumnBuckets(int n, int nkey) : head(nkey, -1), next(n), prev(n), key(n, 0) {}
+    void insert(int i) {
+      int& h = head[key[i]];
+      prev[i] = -1;
+      next[i] = h;
+      if (h>=0) prev[h] = i;
+      h = i;
+    }
+    void remove(int i) {
+      if (prev[i]>=0) {
+        next[prev[i]] = next[i];
+      } else {
+        head[key[i]] = next[i];
+      }
+      if (next[i]>=0) prev[next[i]] = prev[i];
+    }
+  };
+
+  std::vector<int> SparsityInternal::smallest_last() const {
+    int n = size2();
+    const int* colind = this->colind();
+    const int* row = this->row();
+    Sparsity AT = T();
+    const int* AT_colind = AT.colind();
+    const int* AT_row = AT.row();
+    vector<int> mark(n, -1);
+
+    // Distance-2 degree of each column
+    ColumnBuckets b(n, n);
+    for (int i=0; i<n; ++i) {
+      d2_neighbors(i, colind, row, AT_colind, AT_row, get_ptr(mark), i,
+                   [&](int j) { b.key[i]++;});
+    }
+    for (int i=n-1; i>=0; --i) b.insert(i);
+
+    // Remove a column of minimal degree at a time, ordering from the back
+    vector<bool> removed(n, false);
+    vector<int> ord(n);
+    int dmin = 0;
+    for (int k=n-1; k>=0; --k) {
+      while (b.head[dmin]<0) dmin++;
+      int i = b.head[dmin];
+      b.remove(i);
+      removed[i] = true;
+      ord[k] = i;
+
+      // Update the degrees of the remaining neighbours
+      d2_neighbors(i, colind, row, AT_colind, AT_row, get_ptr(mark), n+k, [&](int j) {
+        if (!removed[j]) {
+          b.remove(j);
+          b.key[j]--;
+          b.insert(j);
+        }
+      });
+
+      // The minimal degree decreases by at most one
+      dmin = max(dmin-1, 0);
+    }
+    return ord;
+  }
+
+  std::vector<int> SparsityInternal::incidence_degree() const {
+    int n = size2();
+    const int* colind = this->colind();
+    const int* row = this->row();
+    Sparsity AT = T();
+    const int* AT_colind = AT.colind();
+    const int* AT_row = AT.row();
+    vector<int> mark(n, -1);
+
+    // Number of ordered distance-2 neighbours, initially zero
+    ColumnBuckets b(n, max(n, 1));
+    for (int i=n-1; i>=0; --i) b.insert(i);
+
+    // Pick a column with maximal incidence degree at a time
+    vector<bool> ordered(n, false);
+    vector<int> ord(n);
+    int dmax = 0;
+    for (int k=0; k<n; ++k) {
+      while (b.head[dmax]<0) dmax--;
+      int i = b.head[dmax];
+      b.remove(i);
+      ordered[i] = true;
+      ord[k] = i;
+
+      // Update the incidence degrees of the neighbours
+      d2_neighbors(i, colind, row, AT_colind, AT_row, get_ptr(mark), k, [&](int j) {
+        if (!ordered[j]) {
+          b.remove(j);
+          dmax = max(dmax, ++b.key[j]);
+          b.insert(j);
+        }
+      });
+    }
+    return ord;
+  }
+
+  std::vector<int> SparsityInternal::coloring_ordering(int ordering) const {
+    switch (ordering) {
+    case 1: return largest_first();
+    case 2: return smallest_last();
+    case 3: return incidence_degree();
+    default: casadi_error("Unknown ordering " + str(ordering) + " for coloring");
+    }
+  }
+
   Sparsity SparsityInternal::pmult(const std::vector<int>& p, bool permute_rows,
                                    bool permute_columns, bool invert_permutation) const {
     // Invert p, possibly
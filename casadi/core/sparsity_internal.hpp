@@ -398,7 +398,17 @@ namespace casadi {
      * A greedy distance-2 coloring algorithm
      * (Algorithm 3.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN)
      */
-    Sparsity uni_coloring(const Sparsity& AT, int cutoff) const;
+    Sparsity uni_coloring(const Sparsity& AT, int cutoff, int ordering=0, int nthreads=1) const;
+
+    /** \brief Unidirectional coloring of the columns in a given order
+     *
+     * With more than one thread, speculative coloring with conflict resolution:
+     * the columns are colored tentatively in parallel, conflicts between columns
+     * colored concurrently are detected and the conflicting column later in the
+     * ordering is recolored in the next round.
+     */
+    Sparsity uni_coloring_ordered(const Sparsity& AT, const std::vector<int>& ord,
+                                  int cutoff, int nthreads) const;
 
     /** \brief A greedy distance-2 coloring algorithm
      * See description in public class.
@@ -413,6 +423,15 @@ namespace casadi {
     /// Order the columns by decreasing degree
     std::vector<int> largest_first() const;
 
+    /// Smallest last ordering of the columns, distance-2 degrees
+    std::vector<int> smallest_last() const;
+
+    /// Incidence degree ordering of the columns, distance-2 degrees
+    std::vector<int> incidence_degree() const;
+
+    /// Column ordering for coloring: largest first (1), smallest last (2), incidence degree (3)
+    std::vector<int> coloring_ordering(int ordering) const;
+
     /// Permute rows and/or columns
     Sparsity pmult(const std::vector<int>& p, bool permute_rows=true, bool permute_cols=true,
                    bool invert_permutation=false) const;
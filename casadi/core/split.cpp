@@ -26,6 +26,7 @@
 #include "split.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -384,4 +385,15 @@ namespace casadi {
     return dep();
   }
 
+  void Split::serialize_body(SerializingStream& s) const {
+    // Row and column offsets of the outputs
+    vector<int> offset1(1, 0), offset2(1, 0);
+    for (auto&& sp : output_sparsity_) {
+      offset1.push_back(offset1.back() + sp.size1());
+      offset2.push_back(offset2.back() + sp.size2());
+    }
+    s.pack(offset1);
+    s.pack(offset2);
+  }
+
 } // namespace casadi
@@ -46,6 +46,9 @@ namespace casadi {
     /// Destructor
     ~Split() override = 0;
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /** \brief  Number of outputs */
     int nout() const override { return output_sparsity_.size(); }
 
@@ -177,7 +177,8 @@ namespace casadi {
     }
 
     // Evaluate the corresponding function
-    if (fk(arg1, res1, iw, w, 0)) return 1;
+    scoped_checkout<FunctionInternal> mem_fk(fk.get());
+    if (fk(arg1, res1, iw, w, mem_fk)) return 1;
 
     // Project results with different sparsity
     if (project_out_) {
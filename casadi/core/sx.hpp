@@ -60,6 +60,8 @@ namespace casadi {
                                         std::vector<SX >& vdef,
                                         std::vector<SX >& ex,
                                         bool reverse);
+  template<> SX SX::cse(const SX& e);
+  template<> std::vector<SX> SX::cse(const std::vector<SX>& e);
   template<> bool SX::depends_on(const SX &x, const SX &arg);
   template<> std::vector<SX > SX::symvar(const SX &x);
   template<> SX SX::jacobian(const SX &f, const SX &x, const Dict& opts);
@@ -36,6 +36,10 @@
 #include "sparsity_internal.hpp"
 #include "global_options.hpp"
 #include "casadi_interrupt.hpp"
+#include "serializing_stream.hpp"
+#include "unary_sx.hpp"
+#include "binary_sx.hpp"
+#include "sx_numeric_ad.hpp"
 
 namespace casadi {
 
@@ -53,6 +57,8 @@ namespace casadi {
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    batch_size_ = 8;
+    numeric_ad_ = false;
   }
 
   SXFunction::~SXFunction() {
@@ -88,6 +94,57 @@ namespace casadi {
     return 0;
   }
 
+  int SXFunction::eval_batch(const double** arg, double** res, int* iw, double* w,
+                             void* mem, int n) const {
+    if (verbose_) casadi_message(name_ + "::eval_batch");
+
+    // Just-in-time compiled or free parameters: Fall back to evaluating one at a time
+    if (eval_ || !free_vars_.empty()) {
+      return FunctionInternal::eval_batch(arg, res, iw, w, mem, n);
+    }
+
+    // Process the batch in chunks of (at most) batch_size_ lanes
+    // Work vector entry i for lane k is stored in w[i*nl + k], so that every
+    // instruction below is dispatched once and then applied to all lanes
+    for (int offset=0; offset<n; offset+=batch_size_) {
+      int nl = std::min(batch_size_, n-offset);
+      for (auto&& e : algorithm_) {
+        switch (e.op) {
+          CASADI_MATH_FUN_BUILTIN_GEN(BinaryOperationVV, w+e.i1*nl, w+e.i2*nl, w+e.i0*nl, nl)
+
+        case OP_CONST:
+          std::fill_n(w+e.i0*nl, nl, e.d);
+          break;
+        case OP_INPUT:
+          if (arg[e.i1]==0) {
+            std::fill_n(w+e.i0*nl, nl, 0);
+          } else {
+            int stride = nnz_in(e.i1);
+            const double* a = arg[e.i1] + offset*stride + e.i2;
+            double* f = w+e.i0*nl;
+            for (int k=0; k<nl; ++k) f[k] = a[k*stride];
+          }
+          break;
+        case OP_OUTPUT:
+          if (res[e.i0]!=0) {
+            int stride = nnz_out(e.i0);
+            double* r = res[e.i0] + offset*stride + e.i2;
+            const double* f = w+e.i1*nl;
+            for (int k=0; k<nl; ++k) r[k*stride] = f[k];
+          }
+          break;
+        default:
+          casadi_error("Unknown operation" + str(e.op));
+        }
+      }
+    }
+    return 0;
+  }
+
+  size_t SXFunction::sz_w_batch(int n) const {
+    return std::max(sz_w(), worksize_*std::min(std::max(n, 1), batch_size_));
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -149,6 +206,8 @@ namespace casadi {
   }
 
   void SXFunction::codegen_body(CodeGenerator& g) const {
+    // Split up large algorithms
+    if (g.chunk_size>0 && algorithm_.size()>g.chunk_size) return codegen_chunks(g);
 
     // Which variables have been declared
     vector<bool> declared(sz_w(), false);
@@ -190,6 +249,72 @@ namespace casadi {
     }
   }
 
+  void SXFunction::codegen_chunks(CodeGenerator& g) const {
+    int n_alg = algorithm_.size();
+    int chunk_size = g.chunk_size;
+
+    // Instruction which last wrote to each work vector element
+    vector<int> last_def(worksize_, -1);
+
+    // Values passed between chunks via the work vector
+    vector<bool> spill(n_alg, false);
+    vector<bool> from_w1(n_alg, false), from_w2(n_alg, false);
+    for (int k=0; k<n_alg; ++k) {
+      const ScalarAtomic& a = algorithm_[k];
+      int ndep;
+      switch (a.op) {
+        case OP_CONST: case OP_INPUT: case OP_PARAMETER: ndep = 0; break;
+        case OP_OUTPUT: ndep = 1; break;
+        default: ndep = casadi_math<double>::ndeps(a.op);
+      }
+      if (ndep>=1) {
+        int d = last_def[a.i1];
+        if (d/chunk_size != k/chunk_size) spill[d] = from_w1[k] = true;
+      }
+      if (ndep>=2) {
+        int d = last_def[a.i2];
+        if (d/chunk_size != k/chunk_size) spill[d] = from_w2[k] = true;
+      }
+      if (a.op!=OP_OUTPUT) last_def[a.i0] = k;
+    }
+
+    // Generate the chunks
+    for (int k0=0; k0<n_alg; k0+=chunk_size) {
+      stringstream ss;
+      vector<bool> declared(worksize_, false);
+      for (int k=k0; k<min(k0+chunk_size, n_alg); ++k) {
+        const ScalarAtomic& a = algorithm_[k];
+        string x = from_w1[k] ? "w[" + str(a.i1) + "]" : "a" + str(a.i1);
+        if (a.op==OP_OUTPUT) {
+          ss << "  if (res[" << a.i0 << "]!=0) res[" << a.i0 << "][" << a.i2 << "]=" << x << ";\n";
+          continue;
+        }
+        ss << "  ";
+        if (!declared[a.i0]) {
+          ss << "casadi_real ";
+          declared[a.i0] = true;
+        }
+        ss << "a" << a.i0 << "=";
+        if (a.op==OP_CONST) {
+          ss << g.constant(a.d);
+        } else if (a.op==OP_INPUT) {
+          ss << "arg[" << a.i1 << "] ? arg[" << a.i1 << "][" << a.i2 << "] : 0";
+        } else {
+          ss << casadi_math<double>::pre(a.op) << x;
+          if (casadi_math<double>::ndeps(a.op)==2) {
+            ss << casadi_math<double>::sep(a.op)
+               << (from_w2[k] ? "w[" + str(a.i2) + "]" : "a" + str(a.i2));
+          }
+          ss << casadi_math<double>::post(a.op);
+        }
+        ss << ";\n";
+        // Make available to later chunks
+        if (spill[k]) ss << "  w[" << a.i0 << "]=a" << a.i0 << ";\n";
+      }
+      g << g.add_chunk(ss.str()) << "(arg, res, w);\n";
+    }
+  }
+
   Options SXFunction::options_
   = {{&FunctionInternal::options_},
      {{"default_in",
@@ -204,7 +329,18 @@ namespace casadi {
         "Just-in-time compilation for numeric evaluation using OpenCL (experimental)"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"batch_size",
+       {OT_INT,
+        "Number of inputs that are evaluated simultaneously "
+        "in batched evaluation, e.g. when mapped [default: 8]"}},
+      {"cse",
+       {OT_BOOL,
+        "Perform common subexpression elimination on the output expressions [default: false]"}},
+      {"numeric_ad",
+       {OT_BOOL,
+        "Calculate forward and reverse derivatives by numeric sweeps over the algorithm "
+        "rather than by generating derivative expressions [default: false]"}}
      }
   };
 
@@ -215,6 +351,7 @@ namespace casadi {
 
     // Default (temporary) options
     bool live_variables = true;
+    bool cse_opt = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -222,13 +359,24 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables = op.second;
+      } else if (op.first=="cse") {
+        cse_opt = op.second;
       } else if (op.first=="just_in_time_opencl") {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
         just_in_time_sparsity_ = op.second;
+      } else if (op.first=="batch_size") {
+        batch_size_ = op.second;
+      } else if (op.first=="numeric_ad") {
+        numeric_ad_ = op.second;
       }
     }
 
+    casadi_assert(batch_size_>=1, "Option 'batch_size' must be positive");
+
+    // Merge identical subexpressions
+    if (cse_opt) out_ = SX::cse(out_);
+
     // Check/set default inputs
     if (default_in_.empty()) {
       default_in_.resize(n_in_, 0);
@@ -780,6 +928,115 @@ namespace casadi {
     return 0;
   }
 
+  int SXFunction::sp_forward_batch(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                                   void* mem, int n) const {
+    // Process the batch in chunks of (at most) batch_size_ lanes, with the
+    // work vector layout of eval_batch, i.e. entry i for lane k in w[i*nl + k]
+    for (int offset=0; offset<n; offset+=batch_size_) {
+      int nl = std::min(batch_size_, n-offset);
+      for (auto&& e : algorithm_) {
+        switch (e.op) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          std::fill_n(w+e.i0*nl, nl, 0);
+          break;
+        case OP_INPUT:
+          if (arg[e.i1]==0) {
+            std::fill_n(w+e.i0*nl, nl, 0);
+          } else {
+            int stride = nnz_in(e.i1);
+            const bvec_t* a = arg[e.i1] + offset*stride + e.i2;
+            bvec_t* f = w+e.i0*nl;
+            for (int k=0; k<nl; ++k) f[k] = a[k*stride];
+          }
+          break;
+        case OP_OUTPUT:
+          if (res[e.i0]!=0) {
+            int stride = nnz_out(e.i0);
+            bvec_t* r = res[e.i0] + offset*stride + e.i2;
+            const bvec_t* f = w+e.i1*nl;
+            for (int k=0; k<nl; ++k) r[k*stride] = f[k];
+          }
+          break;
+        default: // Unary or binary operation
+          {
+            const bvec_t *f1 = w+e.i1*nl, *f2 = w+e.i2*nl;
+            bvec_t* f0 = w+e.i0*nl;
+            for (int k=0; k<nl; ++k) f0[k] = f1[k] | f2[k];
+          }
+        }
+      }
+    }
+    return 0;
+  }
+
+  int SXFunction::sp_reverse_batch(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                                   void* mem, int n) const {
+    // Same work vector layout as sp_forward_batch
+    for (int offset=0; offset<n; offset+=batch_size_) {
+      int nl = std::min(batch_size_, n-offset);
+      fill_n(w, worksize_*nl, 0);
+
+      // Propagate sparsity backward
+      for (auto it=algorithm_.rbegin(); it!=algorithm_.rend(); ++it) {
+        switch (it->op) {
+        case OP_CONST:
+        case OP_PARAMETER:
+          std::fill_n(w+it->i0*nl, nl, 0);
+          break;
+        case OP_INPUT:
+          if (arg[it->i1]!=0) {
+            int stride = nnz_in(it->i1);
+            bvec_t* a = arg[it->i1] + offset*stride + it->i2;
+            const bvec_t* f = w+it->i0*nl;
+            for (int k=0; k<nl; ++k) a[k*stride] |= f[k];
+          }
+          std::fill_n(w+it->i0*nl, nl, 0);
+          break;
+        case OP_OUTPUT:
+          if (res[it->i0]!=0) {
+            int stride = nnz_out(it->i0);
+            bvec_t* r = res[it->i0] + offset*stride + it->i2;
+            bvec_t* f = w+it->i1*nl;
+            for (int k=0; k<nl; ++k) {
+              f[k] |= r[k*stride];
+              r[k*stride] = 0;
+            }
+          }
+          break;
+        default: // Unary or binary operation
+          {
+            bvec_t *f0 = w+it->i0*nl, *f1 = w+it->i1*nl, *f2 = w+it->i2*nl;
+            for (int k=0; k<nl; ++k) {
+              bvec_t seed = f0[k];
+              f0[k] = 0;
+              f1[k] |= seed;
+              f2[k] |= seed;
+            }
+          }
+        }
+      }
+    }
+    return 0;
+  }
+
+
+  Function SXFunction::get_forward(int nfwd, const std::string& name,
+                                   const std::vector<std::string>& inames,
+                                   const std::vector<std::string>& onames,
+                                   const Dict& opts) const {
+    if (numeric_ad_) return Function::create(new SXNumericAD(name, nfwd, false), opts);
+    return XFunction<SXFunction, SX, SXNode>::get_forward(nfwd, name, inames, onames, opts);
+  }
+
+  Function SXFunction::get_reverse(int nadj, const std::string& name,
+                                   const std::vector<std::string>& inames,
+                                   const std::vector<std::string>& onames,
+                                   const Dict& opts) const {
+    if (numeric_ad_) return Function::create(new SXNumericAD(name, nadj, true), opts);
+    return XFunction<SXFunction, SX, SXNode>::get_reverse(nadj, name, inames, onames, opts);
+  }
+
   Function SXFunction::get_jacobian(const std::string& name,
                                        const std::vector<std::string>& inames,
                                        const std::vector<std::string>& onames,
@@ -907,4 +1164,125 @@ namespace casadi {
 
   }
 
+  void SXFunction::serialize_body(SerializingStream& s) const {
+    s.pack(name_);
+    s.pack(name_in_);
+    s.pack(name_out_);
+    s.pack(construct_opts_);
+    // Symbolic inputs
+    s.pack(static_cast<int>(in_.size()));
+    for (auto&& e : in_) {
+      s.pack(e.sparsity());
+      for (auto&& nz : e.nonzeros()) s.pack(nz.name());
+    }
+    // Free variables
+    s.pack(get_free());
+    // Output sparsity patterns
+    s.pack(static_cast<int>(out_.size()));
+    for (auto&& e : out_) s.pack(e.sparsity());
+    // Algorithm
+    s.pack(static_cast<int>(worksize_));
+    s.pack(static_cast<int>(algorithm_.size()));
+    for (auto&& a : algorithm_) {
+      s.pack(a.op);
+      s.pack(a.i0);
+      if (a.op==OP_CONST) {
+        s.pack(a.d);
+      } else {
+        s.pack(a.i1);
+        s.pack(a.i2);
+      }
+    }
+  }
+
+  Function SXFunction::deserialize(DeserializingStream& s) {
+    string name;
+    vector<string> name_in, name_out;
+    Dict opts;
+    s.unpack(name);
+    s.unpack(name_in);
+    s.unpack(name_out);
+    s.unpack(opts);
+    // Symbolic inputs
+    int n_in;
+    s.unpack(n_in);
+    casadi_assert(n_in>=0, "Corrupted serialized data");
+    vector<SX> arg(n_in);
+    for (auto&& e : arg) {
+      Sparsity sp;
+      s.unpack(sp);
+      vector<SXElem> nz(sp.nnz());
+      for (auto&& i : nz) {
+        string nz_name;
+        s.unpack(nz_name);
+        i = SXElem::sym(nz_name);
+      }
+      e = SX(sp, nz);
+    }
+    // Free variables
+    vector<string> free_names;
+    s.unpack(free_names);
+    vector<SXElem> free_vars;
+    for (auto&& i : free_names) free_vars.push_back(SXElem::sym(i));
+    auto p_it = free_vars.begin();
+    // Outputs
+    int n_out;
+    s.unpack(n_out);
+    casadi_assert(n_out>=0, "Corrupted serialized data");
+    vector<SX> res(n_out);
+    for (auto&& e : res) {
+      Sparsity sp;
+      s.unpack(sp);
+      e = SX::zeros(sp);
+    }
+    // Replay the algorithm without simplifications
+    int worksize, n_alg;
+    s.unpack(worksize);
+    s.unpack(n_alg);
+    casadi_assert(worksize>=0 && n_alg>=0, "Corrupted serialized data");
+    vector<SXElem> w(worksize);
+    auto work = [&](int i) -> SXElem& {
+      casadi_assert(i>=0 && i<worksize, "Corrupted serialized data");
+      return w[i];
+    };
+    ScalarAtomic a;
+    for (int k=0; k<n_alg; ++k) {
+      s.unpack(a.op);
+      s.unpack(a.i0);
+      if (a.op==OP_CONST) {
+        s.unpack(a.d);
+      } else {
+        s.unpack(a.i1);
+        s.unpack(a.i2);
+      }
+      casadi_assert(a.op>=0 && a.op<NUM_BUILT_IN_OPS, "Corrupted serialized data");
+      switch (a.op) {
+      case OP_INPUT:
+        casadi_assert(a.i1>=0 && a.i1<n_in && a.i2>=0 && a.i2<arg[a.i1].nnz(),
+          "Corrupted serialized data");
+        work(a.i0) = arg[a.i1].nonzeros()[a.i2];
+        break;
+      case OP_OUTPUT:
+        casadi_assert(a.i0>=0 && a.i0<n_out && a.i2>=0 && a.i2<res[a.i0].nnz(),
+          "Corrupted serialized data");
+        res[a.i0].nonzeros()[a.i2] = work(a.i1);
+        break;
+      case OP_CONST:
+        work(a.i0) = a.d;
+        break;
+      case OP_PARAMETER:
+        casadi_assert(p_it!=free_vars.end(), "Corrupted serialized data");
+        work(a.i0) = *p_it++;
+        break;
+      default:
+        if (casadi_math<double>::ndeps(a.op)==2) {
+          work(a.i0) = BinarySX::create(a.op, work(a.i1), work(a.i2));
+        } else {
+          work(a.i0) = UnarySX::create(a.op, work(a.i1));
+        }
+      }
+    }
+    return Function(name, arg, res, name_in, name_out, opts);
+  }
+
 } // namespace casadi
@@ -62,6 +62,13 @@ class CASADI_EXPORT SXFunction :
   /** \brief  Evaluate numerically, work vectors given */
   int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
 
+  /** \brief  Evaluate numerically for a batch of inputs, lanes stored contiguously */
+  int eval_batch(const double** arg, double** res, int* iw, double* w,
+                 void* mem, int n) const override;
+
+  /** \brief Get required length of w field for batched evaluation */
+  size_t sz_w_batch(int n) const override;
+
   /** \brief  evaluate symbolically while also propagating directional derivatives */
   int eval_sx(const SXElem** arg, SXElem** res, int* iw, SXElem* w, void* mem) const override;
 
@@ -90,6 +97,12 @@ class CASADI_EXPORT SXFunction :
   /** \brief Check if the function is of a particular type */
   bool is_a(const std::string& type, bool recursive) const override;
 
+  /** \brief Serialize the symbolic inputs and the algorithm */
+  void serialize_body(SerializingStream& s) const override;
+
+  /** \brief Deserialize, replaying the algorithm */
+  static Function deserialize(DeserializingStream& s);
+
   ///@{
   /** \brief Get function input(s) and output(s)  */
   const SX sx_in(int ind) const override;
@@ -209,13 +222,41 @@ class CASADI_EXPORT SXFunction :
   /** \brief Generate code for the body of the C function */
   void codegen_body(CodeGenerator& g) const override;
 
+  /** \brief Generate code for the body as a sequence of chunks */
+  void codegen_chunks(CodeGenerator& g) const;
+
   /** \brief  Propagate sparsity forward */
   int sp_forward(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, void* mem) const override;
 
   /** \brief  Propagate sparsity backwards */
   int sp_reverse(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w, void* mem) const override;
 
+  /** \brief  Propagate sparsity forward for a batch of seeds */
+  int sp_forward_batch(const bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                       void* mem, int n) const override;
+
+  /** \brief  Propagate sparsity backwards for a batch of seeds */
+  int sp_reverse_batch(bvec_t** arg, bvec_t** res, int* iw, bvec_t* w,
+                       void* mem, int n) const override;
+
+  ///@{
+  /** \brief Generate a function that calculates \a nfwd forward derivatives */
+  Function get_forward(int nfwd, const std::string& name,
+                       const std::vector<std::string>& inames,
+                       const std::vector<std::string>& onames,
+                       const Dict& opts) const override;
+  ///@}
+
+  ///@{
+  /** \brief Generate a function that calculates \a nadj adjoint derivatives */
+  Function get_reverse(int nadj, const std::string& name,
+                       const std::vector<std::string>& inames,
+                       const std::vector<std::string>& onames,
+                       const Dict& opts) const override;
+  ///@}
+
   /** \brief Return Jacobian of all input elements with respect to all output elements */
+  bool has_jacobian() const override { return !numeric_ad_;}
   Function get_jacobian(const std::string& name,
                                    const std::vector<std::string>& inames,
                                    const std::vector<std::string>& onames,
@@ -233,6 +274,12 @@ class CASADI_EXPORT SXFunction :
 
   /// With just-in-time compilation for the sparsity propagation
   bool just_in_time_sparsity_;
+
+  /// Number of inputs evaluated simultaneously in batched evaluation
+  int batch_size_;
+
+  /// Derivatives by numeric sweeps over the algorithm instead of symbolically
+  bool numeric_ad_;
 };
 
 
@@ -0,0 +1,263 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "sx_numeric_ad.hpp"
+#include "sx_function.hpp"
+
+using namespace std;
+
+namespace casadi {
+
+  SXNumericAD::SXNumericAD(const std::string& name, int n, bool adj)
+    : FunctionInternal(name), n_(n), adj_(adj), f_(0) {
+  }
+
+  SXNumericAD::~SXNumericAD() {
+  }
+
+  Sparsity SXNumericAD::get_sparsity_in(int i) {
+    int n_in = derivative_of_.n_in(), n_out = derivative_of_.n_out();
+    if (i<n_in) {
+      // Non-differentiated input
+      return derivative_of_.sparsity_in(i);
+    } else if (i<n_in+n_out) {
+      // Non-differentiated output
+      return derivative_of_.sparsity_out(i-n_in);
+    } else if (adj_) {
+      // Adjoint seeds
+      return repmat(derivative_of_.sparsity_out(i-n_in-n_out), 1, n_);
+    } else {
+      // Forward seeds
+      return repmat(derivative_of_.sparsity_in(i-n_in-n_out), 1, n_);
+    }
+  }
+
+  Sparsity SXNumericAD::get_sparsity_out(int i) {
+    if (adj_) {
+      return repmat(derivative_of_.sparsity_in(i), 1, n_);
+    } else {
+      return repmat(derivative_of_.sparsity_out(i), 1, n_);
+    }
+  }
+
+  double SXNumericAD::get_default_in(int ind) const {
+    if (ind<derivative_of_.n_in()) {
+      return derivative_of_.default_in(ind);
+    } else {
+      return 0;
+    }
+  }
+
+  size_t SXNumericAD::get_n_in() {
+    int n_in = derivative_of_.n_in(), n_out = derivative_of_.n_out();
+    return n_in + n_out + (adj_ ? n_out : n_in);
+  }
+
+  size_t SXNumericAD::get_n_out() {
+    return adj_ ? derivative_of_.n_in() : derivative_of_.n_out();
+  }
+
+  std::string SXNumericAD::get_name_in(int i) {
+    int n_in = derivative_of_.n_in(), n_out = derivative_of_.n_out();
+    if (i<n_in) {
+      return derivative_of_.name_in(i);
+    } else if (i<n_in+n_out) {
+      return "out_" + derivative_of_.name_out(i-n_in);
+    } else if (adj_) {
+      return "adj_" + derivative_of_.name_out(i-n_in-n_out);
+    } else {
+      return "fwd_" + derivative_of_.name_in(i-n_in-n_out);
+    }
+  }
+
+  std::string SXNumericAD::get_name_out(int i) {
+    if (adj_) {
+      return "adj_" + derivative_of_.name_in(i);
+    } else {
+      return "fwd_" + derivative_of_.name_out(i);
+    }
+  }
+
+  void SXNumericAD::init(const Dict& opts) {
+    // Call the initialization method of the base class
+    FunctionInternal::init(opts);
+
+    // Get the differentiated function
+    f_ = derivative_of_.get<SXFunction>();
+    casadi_assert(f_!=0, "SXNumericAD requires an SXFunction");
+    casadi_assert(f_->free_vars_.empty(), "Cannot differentiate \"" + derivative_of_.name()
+                  + "\" since variables " + str(f_->free_vars_) + " are free.");
+
+    // Primal values, directional derivatives and (reverse mode) partial derivatives
+    alloc_w(f_->worksize_*(1+n_) + (adj_ ? 2*f_->operations_.size() : 0), true);
+  }
+
+  int SXNumericAD::eval(const double** arg, double** res, int* iw, double* w, void* mem) const {
+    if (adj_) {
+      eval_reverse(arg, res, w);
+    } else {
+      eval_forward(arg, res, w);
+    }
+    return 0;
+  }
+
+  void SXNumericAD::eval_forward(const double** arg, double** res, double* w) const {
+    int n_in = f_->n_in_, n_out = f_->n_out_;
+
+    // Forward seeds
+    const double** seed = arg + n_in + n_out;
+
+    // Clear forward sensitivities
+    for (int i=0; i<n_out; ++i) {
+      if (res[i]) casadi_fill(res[i], n_*f_->nnz_out(i), 0.);
+    }
+
+    // Primal values and directional derivatives, the latter interleaved by direction
+    double* v = w;
+    double* t = w + f_->worksize_;
+    double f, d[2];
+    for (auto&& e : f_->algorithm_) {
+      double* t0 = t + e.i0*n_;
+      switch (e.op) {
+      case OP_INPUT:
+        {
+          v[e.i0] = arg[e.i1] ? arg[e.i1][e.i2] : 0;
+          const double* s = seed[e.i1];
+          int nnz = f_->nnz_in(e.i1);
+          for (int k=0; k<n_; ++k) t0[k] = s ? s[e.i2 + k*nnz] : 0;
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]) {
+          double* r = res[e.i0];
+          const double* t1 = t + e.i1*n_;
+          int nnz = f_->nnz_out(e.i0);
+          for (int k=0; k<n_; ++k) r[e.i2 + k*nnz] = t1[k];
+        }
+        break;
+      case OP_CONST:
+        v[e.i0] = e.d;
+        casadi_fill(t0, n_, 0.);
+        break;
+      default:
+        {
+          casadi_math<double>::derF(e.op, v[e.i1], v[e.i2], f, d);
+          v[e.i0] = f;
+          const double* t1 = t + e.i1*n_;
+          if (casadi_math<double>::ndeps(e.op)==2) {
+            const double* t2 = t + e.i2*n_;
+            for (int k=0; k<n_; ++k) t0[k] = d[0]*t1[k] + d[1]*t2[k];
+          } else {
+            for (int k=0; k<n_; ++k) t0[k] = d[0]*t1[k];
+          }
+        }
+      }
+    }
+  }
+
+  void SXNumericAD::eval_reverse(const double** arg, double** res, double* w) const {
+    int n_in = f_->n_in_, n_out = f_->n_out_;
+
+    // Adjoint seeds
+    const double** seed = arg + n_in + n_out;
+
+    // Clear adjoint sensitivities
+    for (int i=0; i<n_in; ++i) {
+      if (res[i]) casadi_fill(res[i], n_*f_->nnz_in(i), 0.);
+    }
+
+    // Primal values, adjoint directional derivatives and tape of partial derivatives
+    double* v = w;
+    double* a = w + f_->worksize_;
+    double* tape = a + f_->worksize_*n_;
+
+    // Forward sweep, recording partial derivatives
+    double f, *d = tape;
+    for (auto&& e : f_->algorithm_) {
+      switch (e.op) {
+      case OP_INPUT:
+        v[e.i0] = arg[e.i1] ? arg[e.i1][e.i2] : 0;
+        break;
+      case OP_OUTPUT:
+        break;
+      case OP_CONST:
+        v[e.i0] = e.d;
+        break;
+      default:
+        casadi_math<double>::derF(e.op, v[e.i1], v[e.i2], f, d);
+        v[e.i0] = f;
+        d += 2;
+      }
+    }
+
+    // Reverse sweep, adjoints interleaved by direction
+    casadi_fill(a, f_->worksize_*n_, 0.);
+    for (auto it=f_->algorithm_.rbegin(); it!=f_->algorithm_.rend(); ++it) {
+      double* a0 = a + it->i0*n_;
+      switch (it->op) {
+      case OP_INPUT:
+        if (res[it->i1]) {
+          double* r = res[it->i1];
+          int nnz = f_->nnz_in(it->i1);
+          for (int k=0; k<n_; ++k) r[it->i2 + k*nnz] += a0[k];
+        }
+        casadi_fill(a0, n_, 0.);
+        break;
+      case OP_OUTPUT:
+        if (seed[it->i0]) {
+          const double* s = seed[it->i0];
+          double* a1 = a + it->i1*n_;
+          int nnz = f_->nnz_out(it->i0);
+          for (int k=0; k<n_; ++k) a1[k] += s[it->i2 + k*nnz];
+        }
+        break;
+      case OP_CONST:
+        casadi_fill(a0, n_, 0.);
+        break;
+      default:
+        {
+          d -= 2;
+          double* a1 = a + it->i1*n_;
+          if (casadi_math<double>::ndeps(it->op)==2) {
+            double* a2 = a + it->i2*n_;
+            for (int k=0; k<n_; ++k) {
+              double s = a0[k];
+              a0[k] = 0;
+              a1[k] += d[0]*s;
+              a2[k] += d[1]*s;
+            }
+          } else {
+            for (int k=0; k<n_; ++k) {
+              double s = a0[k];
+              a0[k] = 0;
+              a1[k] += d[0]*s;
+            }
+          }
+        }
+      }
+    }
+  }
+
+} // namespace casadi
@@ -0,0 +1,108 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_SX_NUMERIC_AD_HPP
+#define CASADI_SX_NUMERIC_AD_HPP
+
+#include "function_internal.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  // Forward declaration
+  class SXFunction;
+
+  /** \brief Numeric directional derivatives of an SXFunction
+   *
+   * Forward (tangent) and reverse (adjoint) sweeps are carried out directly
+   * over the algorithm of the differentiated SXFunction. No symbolic derivative
+   * expressions are created. The reverse mode records the partial derivatives
+   * of all operations in a forward sweep and then propagates the adjoint seeds
+   * backwards over this tape.
+   *
+   * Inputs are the nondifferentiated inputs and outputs followed by the seeds,
+   * horizontally concatenated over the directions, as for any forward or
+   * reverse derivative function.
+   */
+  class CASADI_EXPORT SXNumericAD : public FunctionInternal {
+  public:
+    // Constructor
+    SXNumericAD(const std::string& name, int n, bool adj);
+
+    /** \brief Destructor */
+    ~SXNumericAD() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "SXNumericAD";}
+
+    /// @{
+    /** \brief Sparsities of function inputs and outputs */
+    Sparsity get_sparsity_in(int i) override;
+    Sparsity get_sparsity_out(int i) override;
+    /// @}
+
+    /** \brief Get default input value */
+    double get_default_in(int ind) const override;
+
+    ///@{
+    /** \brief Number of function inputs and outputs */
+    size_t get_n_in() override;
+    size_t get_n_out() override;
+    ///@}
+
+    ///@{
+    /** \brief Names of function input and outputs */
+    std::string get_name_in(int i) override;
+    std::string get_name_out(int i) override;
+    ///@}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /// Evaluate numerically
+    int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
+
+  protected:
+    /// Forward sweep, tangents of all directions propagated alongside
+    void eval_forward(const double** arg, double** res, double* w) const;
+
+    /// Forward sweep recording partial derivatives, followed by a reverse sweep
+    void eval_reverse(const double** arg, double** res, double* w) const;
+
+    /// Number of directions
+    int n_;
+
+    /// Reverse mode?
+    bool adj_;
+
+    /// Differentiated function
+    const SXFunction* f_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_SX_NUMERIC_AD_HPP
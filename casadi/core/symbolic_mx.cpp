@@ -25,6 +25,7 @@
 
 #include "symbolic_mx.hpp"
 #include "casadi_misc.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -89,4 +90,9 @@ namespace casadi {
     this->temp = 0;
   }
 
+  void SymbolicMX::serialize_body(SerializingStream& s) const {
+    s.pack(name_);
+    s.pack(sparsity());
+  }
+
 } // namespace casadi
@@ -81,6 +81,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_PARAMETER;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /** \brief  Check if valid function input */
     bool is_valid_input() const override { return true;}
 
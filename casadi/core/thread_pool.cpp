@@ -0,0 +1,142 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+#include "exception.hpp"
+
+using namespace std;
+
+namespace casadi {
+
+  ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+#ifndef WITH_THREAD
+
+  int ThreadPool::size() const {
+    return 1;
+  }
+
+  void ThreadPool::run(int n, const std::function<void(int)>& job) {
+    for (int i=0; i<n; ++i) job(i);
+  }
+
+#else // WITH_THREAD
+
+  // Set for threads owned by the pool
+  static thread_local bool in_pool = false;
+
+  ThreadPool::ThreadPool() : job_(0), n_job_(0), n_done_(0), generation_(0), stop_(false) {
+    size_ = max(1, static_cast<int>(thread::hardware_concurrency()));
+    for (int i=1; i<size_; ++i) threads_.emplace_back(&ThreadPool::work, this, i, 0);
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      lock_guard<mutex> lock(mtx_);
+      stop_ = true;
+    }
+    cv_start_.notify_all();
+    for (auto&& t : threads_) t.join();
+  }
+
+  int ThreadPool::size() const {
+    return size_;
+  }
+
+  void ThreadPool::work(int i, unsigned int seen) {
+    in_pool = true;
+    while (true) {
+      const std::function<void(int)>* job;
+      {
+        unique_lock<mutex> lock(mtx_);
+        cv_start_.wait(lock, [&]{ return stop_ || generation_ != seen;});
+        if (stop_) return;
+        seen = generation_;
+        if (i >= n_job_) continue;
+        job = job_;
+      }
+      exception_ptr error;
+      try {
+        (*job)(i);
+      } catch (...) {
+        error = current_exception();
+      }
+      {
+        lock_guard<mutex> lock(mtx_);
+        if (error && !error_) error_ = error;
+        if (++n_done_ == n_job_ - 1) cv_done_.notify_one();
+      }
+    }
+  }
+
+  void ThreadPool::run(int n, const std::function<void(int)>& job) {
+    // Serial execution if nested or if another thread is using the pool
+    unique_lock<mutex> busy(busy_, defer_lock);
+    if (n <= 1 || in_pool || !busy.try_lock()) {
+      for (int i=0; i<n; ++i) job(i);
+      return;
+    }
+
+    // Wake up the workers
+    {
+      lock_guard<mutex> lock(mtx_);
+      // Add workers if needed
+      for (int i=threads_.size()+1; i<n; ++i) {
+        threads_.emplace_back(&ThreadPool::work, this, i, generation_);
+      }
+      job_ = &job;
+      n_job_ = n;
+      n_done_ = 0;
+      error_ = nullptr;
+      generation_++;
+    }
+    cv_start_.notify_all();
+
+    // The caller takes the first job
+    exception_ptr error;
+    try {
+      job(0);
+    } catch (...) {
+      error = current_exception();
+    }
+
+    // Wait for the workers to finish
+    {
+      unique_lock<mutex> lock(mtx_);
+      cv_done_.wait(lock, [&]{ return n_done_ == n_job_ - 1;});
+      if (!error) error = error_;
+      job_ = 0;
+      n_job_ = 0;
+      error_ = nullptr;
+    }
+    if (error) rethrow_exception(error);
+  }
+
+#endif // WITH_THREAD
+
+} // namespace casadi
@@ -0,0 +1,107 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "casadi_common.hpp"
+#include <functional>
+
+#ifdef WITH_THREAD
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#endif // WITH_THREAD
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Persistent pool of worker threads
+
+      The workers are created on first use and kept alive until the program exits,
+      so that parallel evaluation does not pay for thread creation at every call.
+      Without WITH_THREAD, all jobs are executed by the calling thread.
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Access the process-wide pool
+    static ThreadPool& instance();
+
+    /// Default number of concurrent jobs, including the caller
+    int size() const;
+
+    /** \brief Execute job(0), ..., job(n-1), return when all have finished
+
+        job(0) is executed by the calling thread, the pool is grown if it has fewer
+        than n-1 workers. If the pool is already busy, e.g. for nested parallel
+        evaluation, all jobs are executed by the calling thread.
+        Exceptions thrown by a job are rethrown in the caller.
+    */
+    void run(int n, const std::function<void(int)>& job);
+
+#ifdef WITH_THREAD
+    /// Destructor, joins the workers
+    ~ThreadPool();
+
+  private:
+    /// Constructor, starts the workers
+    ThreadPool();
+
+    /// Main loop of worker i, starting after the given generation
+    void work(int i, unsigned int seen);
+
+    // Default number of concurrent jobs
+    int size_;
+
+    // Worker threads
+    std::vector<std::thread> threads_;
+
+    // Held while the pool is executing a batch of jobs
+    std::mutex busy_;
+
+    // Protects the fields below
+    std::mutex mtx_;
+    std::condition_variable cv_start_, cv_done_;
+
+    // Current batch of jobs
+    const std::function<void(int)>* job_;
+    int n_job_, n_done_;
+
+    // Incremented for every new batch
+    unsigned int generation_;
+
+    // Exception thrown by a worker, if any
+    std::exception_ptr error_;
+
+    // Shut down the workers
+    bool stop_;
+#endif // WITH_THREAD
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
@@ -24,6 +24,7 @@
 
 
 #include "transpose.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -207,4 +208,12 @@ namespace casadi {
       << "rr[i+j*" << dep().size2() << "] = *cs++;\n";
   }
 
+  void Transpose::serialize_body(SerializingStream& s) const {
+    s.pack(false);
+  }
+
+  void DenseTranspose::serialize_body(SerializingStream& s) const {
+    s.pack(true);
+  }
+
 } // namespace casadi
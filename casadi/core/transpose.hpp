@@ -83,6 +83,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return OP_TRANSPOSE;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /** \brief Get required length of iw field */
     size_t sz_iw() const override { return size2()+1;}
 
@@ -109,6 +112,9 @@ namespace casadi {
     /// Constructor
     DenseTranspose(const MX& x) : Transpose(x) {}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /// Destructor
     ~DenseTranspose() override {}
 
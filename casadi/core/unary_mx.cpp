@@ -28,6 +28,7 @@
 #include <sstream>
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "serializing_stream.hpp"
 
 using namespace std;
 
@@ -189,4 +190,7 @@ namespace casadi {
     return MXNode::_get_binary(op, y, scX, scY);
   }
 
+  void UnaryMX::serialize_body(SerializingStream& s) const {
+  }
+
 } // namespace casadi
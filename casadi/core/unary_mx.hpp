@@ -75,6 +75,9 @@ namespace casadi {
     /** \brief Get the operation */
     int op() const override { return op_;}
 
+    /** \brief Serialize the class specific data */
+    void serialize_body(SerializingStream& s) const override;
+
     /** \brief Generate code for the operation */
     void generate(CodeGenerator& g,
                           const std::vector<int>& arg, const std::vector<int>& res) const override;
@@ -425,7 +425,8 @@ namespace casadi {
         double ret_double;
         m->res[0] = &ret_double;
 
-        fcallback_(m->arg, m->res, m->iw, m->w, 0);
+        scoped_checkout<FunctionInternal> mem_fcallback(fcallback_.get());
+        fcallback_(m->arg, m->res, m->iw, m->w, mem_fcallback);
         int ret = static_cast<int>(ret_double);
 
         m->fstats.at("callback_fun").toc();
@@ -287,7 +287,8 @@ namespace casadi {
       m->arg[iin_] = NV_DATA_S(m->u);
       copy_n(m->ires, n_out_, m->res);
       m->res[iout_] = 0;
-      oracle_(m->arg, m->res, m->iw, m->w, 0);
+      scoped_checkout<FunctionInternal> mem_oracle(oracle_.get());
+      oracle_(m->arg, m->res, m->iw, m->w, mem_oracle);
     }
   }
 
@@ -297,7 +298,8 @@ namespace casadi {
     m.arg[iin_] = NV_DATA_S(u);
     fill_n(m.res, n_out_, nullptr);
     m.res[iout_] = NV_DATA_S(fval);
-    oracle_(m.arg, m.res, m.iw, m.w, 0);
+    scoped_checkout<FunctionInternal> mem_oracle(oracle_.get());
+    oracle_(m.arg, m.res, m.iw, m.w, mem_oracle);
 
     // Make sure that all entries of the linear system are valid
     double *fdata = NV_DATA_S(fval);
@@ -435,7 +437,8 @@ namespace casadi {
     m.arg[iin_] = NV_DATA_S(u);
     m.arg[n_in_] = NV_DATA_S(v);
     m.res[0] = NV_DATA_S(Jv);
-    jtimes_(m.arg, m.res, m.iw, m.w, 0);
+    scoped_checkout<FunctionInternal> mem_jtimes(jtimes_.get());
+    jtimes_(m.arg, m.res, m.iw, m.w, mem_jtimes);
   }
 
   int KinsolInterface::
@@ -409,7 +409,8 @@ namespace casadi {
 
             m->fstats.at("callback_fun").tic();
             // Evaluate the callback function
-            fcallback_(m->arg, m->res, m->iw, m->w, 0);
+            scoped_checkout<FunctionInternal> mem_fcallback(fcallback_.get());
+            fcallback_(m->arg, m->res, m->iw, m->w, mem_fcallback);
             m->fstats.at("callback_fun").toc();
             int ret = static_cast<int>(ret_double);
 
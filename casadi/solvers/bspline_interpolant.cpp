@@ -51,7 +51,10 @@ namespace casadi {
         "Sets, for each grid dimenion, the degree of the spline."}},
        {"linear_solver",
         {OT_STRING,
-         "Solver used for constructing the coefficient tensor."}}
+         "Solver used for constructing the coefficient tensor."}},
+       {"lookup_mode",
+        {OT_STRINGVECTOR,
+         "Lookup algorithm for each grid dimension, passed on to the spline."}}
      }
   };
 
@@ -65,6 +68,7 @@ namespace casadi {
   }
 
   BSplineInterpolant::~BSplineInterpolant() {
+    clear_mem();
   }
 
   std::vector<double> meshgrid(const std::vector< std::vector<double> >& grid) {
@@ -122,12 +126,17 @@ namespace casadi {
 
     linear_solver_ = "lsqr";
 
+    // Options for the spline
+    Dict opts_spline;
+
     // Read options
     for (auto&& op : opts) {
       if (op.first=="degree") {
         degree_ = op.second;
       } else if (op.first=="linear_solver") {
         linear_solver_ = op.second.to_string();
+      } else if (op.first=="lookup_mode") {
+        opts_spline["lookup_mode"] = op.second;
       }
     }
 
@@ -163,7 +172,7 @@ namespace casadi {
 
     uout() << "Lookup table fitting error: " << fit << std::endl;
 
-    S_ = Function::bspline("spline", knots, C_opt.nonzeros(), degree_, 1);
+    S_ = Function::bspline("spline", knots, C_opt.nonzeros(), degree_, 1, opts_spline);
 
     alloc_w(S_->sz_w(), true);
     alloc_iw(S_->sz_iw(), true);
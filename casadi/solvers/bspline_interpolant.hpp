@@ -77,6 +77,15 @@ namespace casadi {
     // Initialize
     void init(const Dict& opts) override;
 
+    /** \brief Create memory block, that of the spline */
+    void* alloc_mem() const override { return S_->alloc_mem();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override { return S_->init_mem(mem);}
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { S_->free_mem(mem);}
+
     /// Evaluate numerically
     int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
 
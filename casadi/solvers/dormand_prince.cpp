@@ -0,0 +1,423 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "dormand_prince.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_DOPRI_EXPORT
+      casadi_register_integrator_dopri(Integrator::Plugin* plugin) {
+    plugin->creator = DormandPrince::creator;
+    plugin->name = "dopri";
+    plugin->doc = DormandPrince::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &DormandPrince::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_DOPRI_EXPORT casadi_load_integrator_dopri() {
+    Integrator::registerPlugin(casadi_register_integrator_dopri);
+  }
+
+  // Butcher tableau of the Dormand-Prince 5(4) pair, the last stage is evaluated at
+  // the 5th order solution and reused as the first stage of the next step (FSAL)
+  static const double dopri_c[7] = {0., 1./5, 3./10, 4./5, 8./9, 1., 1.};
+  static const double dopri_a[7][6] = {
+    {0., 0., 0., 0., 0., 0.},
+    {1./5, 0., 0., 0., 0., 0.},
+    {3./40, 9./40, 0., 0., 0., 0.},
+    {44./45, -56./15, 32./9, 0., 0., 0.},
+    {19372./6561, -25360./2187, 64448./6561, -212./729, 0., 0.},
+    {9017./3168, -355./33, 46732./5247, 49./176, -5103./18656, 0.},
+    {35./384, 0., 500./1113, 125./192, -2187./6784, 11./84}};
+
+  // Difference between the 5th and the embedded 4th order weights
+  static const double dopri_e[7] = {71./57600, 0., -71./16695, 71./1920,
+                                    -17253./339200, 22./525, -1./40};
+
+  // Dense output weights (Hairer, Norsett and Wanner)
+  static const double dopri_d[7] = {-12715105075./11282082432, 0., 87487479700./32700410799,
+                                    -10690763975./1880347072, 701980252875./199316789632,
+                                    -1453857185./822651844, 69997945./29380423};
+
+  DormandPrince::DormandPrince(const std::string& name, const Function& dae)
+    : Integrator(name, dae) {
+  }
+
+  DormandPrince::~DormandPrince() {
+    clear_mem();
+  }
+
+  Options DormandPrince::options_
+  = {{&Integrator::options_},
+     {{"abstol",
+       {OT_DOUBLE,
+        "Absolute tolerence for the IVP solution"}},
+      {"reltol",
+       {OT_DOUBLE,
+        "Relative tolerence for the IVP solution"}},
+      {"max_num_steps",
+       {OT_INT,
+        "Maximum number of integrator steps"}},
+      {"max_step_size",
+       {OT_DOUBLE,
+        "Max step size [default: 0/inf]"}}
+     }
+  };
+
+  void DormandPrince::init(const Dict& opts) {
+    // Call the base class init
+    Integrator::init(opts);
+
+    // Default options
+    abstol_ = 1e-8;
+    reltol_ = 1e-6;
+    max_num_steps_ = 10000;
+    max_step_size_ = 0;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="abstol") {
+        abstol_ = op.second;
+      } else if (op.first=="reltol") {
+        reltol_ = op.second;
+      } else if (op.first=="max_num_steps") {
+        max_num_steps_ = op.second;
+      } else if (op.first=="max_step_size") {
+        max_step_size_ = op.second;
+      }
+    }
+    if (max_step_size_<=0) max_step_size_ = inf;
+
+    // Algebraic variables not supported
+    casadi_assert(nz_==0 && nrz_==0,
+                  "Explicit Runge-Kutta integrators do not support algebraic variables");
+
+    // Continuous time dynamics
+    f_ = create_function("f", {"x", "p", "t"}, {"ode", "quad"});
+    if (nrx_>0) g_ = create_function("g", {"rx", "rp", "x", "p", "t"}, {"rode", "rquad"});
+
+    // State dimensions, quadratures are integrated along with the states
+    ny_ = nx_ + nq_;
+    nry_ = nrx_ + nrq_;
+  }
+
+  int DormandPrince::init_mem(void* mem) const {
+    if (Integrator::init_mem(mem)) return 1;
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Allocate work vectors
+    int n = max(ny_, nry_);
+    m->p.resize(np_);
+    m->rp.resize(nrp_);
+    m->y.resize(ny_);
+    m->ry.resize(nry_);
+    m->k.resize(7*n);
+    m->y1.resize(n);
+    m->ytmp.resize(n);
+    m->xtmp.resize(nx_);
+    m->cont.resize(5*ny_);
+    return 0;
+  }
+
+  int DormandPrince::rhs(DormandPrinceMemory* m, bool backward, double t,
+                         const double* y, double* yp) const {
+    if (!backward) {
+      m->nfevals++;
+      m->arg[0] = y;
+      m->arg[1] = get_ptr(m->p);
+      m->arg[2] = &t;
+      m->res[0] = yp;
+      m->res[1] = yp + nx_;
+      if (calc_function(m, "f")) return 1;
+    } else {
+      m->nfevalsB++;
+      // Interpolate the forward solution, the segment may lie in either direction since
+      // the step size probe and rejected steps evaluate beyond the accepted solution
+      while (m->itape>0 && t<m->tape_t[m->itape]) m->itape--;
+      while (m->itape+1<m->tape_t.size() && t>=m->tape_t[m->itape+1]) m->itape++;
+      double theta = (t - m->tape_t[m->itape])/m->tape_h[m->itape];
+      dense_eval(nx_, theta, get_ptr(m->tape_cont) + 5*nx_*m->itape, get_ptr(m->xtmp));
+      m->arg[0] = y;
+      m->arg[1] = get_ptr(m->rp);
+      m->arg[2] = get_ptr(m->xtmp);
+      m->arg[3] = get_ptr(m->p);
+      m->arg[4] = &t;
+      m->res[0] = yp;
+      m->res[1] = yp + nrx_;
+      if (calc_function(m, "g")) return 1;
+      // The backward problem is integrated backward in time
+      casadi_scal(nry_, -1., yp);
+    }
+    return 0;
+  }
+
+  double DormandPrince::err_norm(bool backward, const double* y, const double* y1,
+                                 const double* e) const {
+    // Only the states are error controlled, unless there are none
+    int n = backward ? (nrx_>0 ? nrx_ : nry_) : (nx_>0 ? nx_ : ny_);
+    if (n==0) return 0;
+    double r = 0;
+    for (int i=0; i<n; ++i) {
+      double sc = abstol_ + reltol_*fmax(fabs(y[i]), y1 ? fabs(y1[i]) : 0.);
+      r += (e[i]/sc)*(e[i]/sc);
+    }
+    return sqrt(r/n);
+  }
+
+  double DormandPrince::initial_step(DormandPrinceMemory* m, bool backward, double t,
+                                     const double* y, double hmax) const {
+    int n = backward ? nry_ : ny_;
+    double dir = backward ? -1 : 1;
+    double* k = get_ptr(m->k);
+    double* ytmp = get_ptr(m->ytmp);
+    hmax = fmin(hmax, max_step_size_);
+    if (hmax<=0) return 0;
+
+    // Step based on the norm of the state and the derivative
+    double d0 = err_norm(backward, y, 0, y);
+    double d1 = err_norm(backward, y, 0, k);
+    double h0 = d0<1e-5 || d1<1e-5 ? 1e-6 : 0.01*d0/d1;
+    h0 = fmin(h0, hmax);
+
+    // Estimate the second derivative with an explicit Euler step
+    casadi_copy(y, n, ytmp);
+    casadi_axpy(n, dir*h0, k, ytmp);
+    if (rhs(m, backward, t + dir*h0, ytmp, k + n)) return h0;
+    casadi_axpy(n, -1., k, k + n);
+    double d2 = err_norm(backward, y, 0, k + n)/h0;
+
+    // Step size such that the local error of a first order method is 0.01
+    double dmax = fmax(d1, d2);
+    double h1 = dmax<=1e-15 ? fmax(1e-6, h0*1e-3) : pow(0.01/dmax, 1./5);
+    return fmin(fmin(100*h0, h1), hmax);
+  }
+
+  double DormandPrince::step(DormandPrinceMemory* m, bool backward, double t, double h,
+                             const double* y) const {
+    int n = backward ? nry_ : ny_;
+    double* k = get_ptr(m->k);
+    double* y1 = get_ptr(m->y1);
+    double* ytmp = get_ptr(m->ytmp);
+
+    // Stages, the derivative at t is available in k[0]
+    for (int s=1; s<7; ++s) {
+      double* ys = s==6 ? y1 : ytmp;
+      casadi_copy(y, n, ys);
+      for (int j=0; j<s; ++j) {
+        if (dopri_a[s][j]!=0) casadi_axpy(n, h*dopri_a[s][j], k + j*n, ys);
+      }
+      // Reject the step if the evaluation failed
+      if (rhs(m, backward, t + dopri_c[s]*h, ys, k + s*n)) return inf;
+    }
+
+    // Local error estimate
+    casadi_fill(ytmp, n, 0.);
+    for (int j=0; j<7; ++j) {
+      if (dopri_e[j]!=0) casadi_axpy(n, h*dopri_e[j], k + j*n, ytmp);
+    }
+    return err_norm(backward, y, y1, ytmp);
+  }
+
+  void DormandPrince::dense_coeff(int n, int ld, double h, const double* y,
+                                  const double* y1, const double* k, double* cont) {
+    for (int i=0; i<n; ++i) {
+      double ydiff = y1[i] - y[i];
+      double bspl = h*k[i] - ydiff;
+      cont[i] = y[i];
+      cont[n+i] = ydiff;
+      cont[2*n+i] = bspl;
+      cont[3*n+i] = ydiff - h*k[6*ld+i] - bspl;
+      double r = 0;
+      for (int j=0; j<7; ++j) r += dopri_d[j]*k[j*ld+i];
+      cont[4*n+i] = h*r;
+    }
+  }
+
+  void DormandPrince::dense_eval(int n, double theta, const double* cont, double* y) {
+    double theta1 = 1 - theta;
+    for (int i=0; i<n; ++i) {
+      y[i] = cont[i] + theta*(cont[n+i] + theta1*(cont[2*n+i]
+                                                  + theta*(cont[3*n+i] + theta1*cont[4*n+i])));
+    }
+  }
+
+  void DormandPrince::integrate(DormandPrinceMemory* m, bool backward,
+                                double t_end, double t_stop) const {
+    int n = backward ? nry_ : ny_;
+    double dir = backward ? -1 : 1;
+    double* y = backward ? get_ptr(m->ry) : get_ptr(m->y);
+    double* k = get_ptr(m->k);
+    double* y1 = get_ptr(m->y1);
+    int& nsteps = backward ? m->nstepsB : m->nsteps;
+    int& nrejected = backward ? m->nrejectedB : m->nrejected;
+    bool rejected = false;
+    while (dir*(t_end - m->t) > 0) {
+      casadi_assert(nsteps + nrejected < max_num_steps_,
+                    "Maximum number of steps (" + str(max_num_steps_) + ") reached "
+                    "at t = " + str(m->t));
+
+      // Step size, do not pass t_stop
+      double h = fmin(m->h, max_step_size_);
+      bool last = 1.01*h >= dir*(t_stop - m->t);
+      if (last) h = dir*(t_stop - m->t);
+      casadi_assert(h > 10*eps*fabs(m->t), "Step size too small at t = " + str(m->t));
+
+      // Attempt a step
+      double err = step(m, backward, m->t, dir*h, y);
+      double fac = err==0 ? 5. : fmin(5., fmax(0.2, 0.9*pow(err, -1./5)));
+      if (err<=1) {
+        // Step accepted, save dense output of the forward solution
+        if (!backward) {
+          dense_coeff(ny_, ny_, h, y, y1, k, get_ptr(m->cont));
+          m->t_last = m->t;
+          m->h_last = h;
+          if (nrx_>0) {
+            m->tape_t.push_back(m->t);
+            m->tape_h.push_back(h);
+            m->tape_cont.resize(m->tape_cont.size() + 5*nx_);
+            dense_coeff(nx_, ny_, h, y, y1, k, get_ptr(m->tape_cont) + m->tape_cont.size() - 5*nx_);
+          }
+        }
+        m->t = last ? t_stop : m->t + dir*h;
+        casadi_copy(y1, n, y);
+        casadi_copy(k + 6*n, n, k);
+        m->h = h*(rejected ? fmin(fac, 1.) : fac);
+        rejected = false;
+        nsteps++;
+      } else {
+        // Step rejected
+        m->h = h*fac;
+        rejected = true;
+        nrejected++;
+      }
+    }
+  }
+
+  void DormandPrince::reset(IntegratorMemory* mem, double t, const double* x,
+                            const double* z, const double* p) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Reset statistics
+    m->nsteps = m->nfevals = m->nrejected = 0;
+    m->nstepsB = m->nfevalsB = m->nrejectedB = 0;
+
+    // Initial state, quadratures start at zero
+    m->t = t;
+    casadi_copy(p, np_, get_ptr(m->p));
+    casadi_copy(x, nx_, get_ptr(m->y));
+    casadi_fill(get_ptr(m->y) + nx_, nq_, 0.);
+
+    // Clear the tape
+    m->tape_t.clear();
+    m->tape_h.clear();
+    m->tape_cont.clear();
+
+    // Derivative at the initial time and initial step size
+    casadi_assert(!rhs(m, false, t, get_ptr(m->y), get_ptr(m->k)),
+                  "Evaluation of the right-hand side failed at t = " + str(t));
+    m->h = initial_step(m, false, t, get_ptr(m->y), grid_.back() - t);
+  }
+
+  void DormandPrince::advance(IntegratorMemory* mem, double t,
+                              double* x, double* z, double* q) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Integrate, possibly past t, but not past the end of the time horizon
+    integrate(m, false, t, grid_.back());
+
+    // Get the solution at t, interpolate if needed
+    const double* y = get_ptr(m->y);
+    if (m->t!=t) {
+      dense_eval(ny_, (t - m->t_last)/m->h_last, get_ptr(m->cont), get_ptr(m->ytmp));
+      y = get_ptr(m->ytmp);
+    }
+    casadi_copy(y, nx_, x);
+    casadi_copy(y + nx_, nq_, q);
+  }
+
+  void DormandPrince::resetB(IntegratorMemory* mem, double t, const double* rx,
+                             const double* rz, const double* rp) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Initial state, quadratures start at zero
+    m->t = t;
+    casadi_copy(rp, nrp_, get_ptr(m->rp));
+    casadi_copy(rx, nrx_, get_ptr(m->ry));
+    casadi_fill(get_ptr(m->ry) + nrx_, nrq_, 0.);
+
+    // Start at the end of the tape
+    casadi_assert(!m->tape_t.empty(), "No forward solution available");
+    m->itape = m->tape_t.size() - 1;
+
+    // Derivative at the initial time and initial step size
+    casadi_assert(!rhs(m, true, t, get_ptr(m->ry), get_ptr(m->k)),
+                  "Evaluation of the right-hand side failed at t = " + str(t));
+    m->h = initial_step(m, true, t, get_ptr(m->ry), t - grid_.front());
+  }
+
+  void DormandPrince::retreat(IntegratorMemory* mem, double t,
+                              double* rx, double* rz, double* rq) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Integrate to t
+    integrate(m, true, t, t);
+
+    // Get the solution
+    casadi_copy(get_ptr(m->ry), nrx_, rx);
+    casadi_copy(get_ptr(m->ry) + nrx_, nrq_, rq);
+  }
+
+  void DormandPrince::print_stats(IntegratorMemory* mem) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+    print("FORWARD INTEGRATION:\n");
+    print("Number of accepted steps: %d\n", m->nsteps);
+    print("Number of rejected steps: %d\n", m->nrejected);
+    print("Number of right-hand side evaluations: %d\n", m->nfevals);
+    if (nrx_>0) {
+      print("BACKWARD INTEGRATION:\n");
+      print("Number of accepted steps: %d\n", m->nstepsB);
+      print("Number of rejected steps: %d\n", m->nrejectedB);
+      print("Number of right-hand side evaluations: %d\n", m->nfevalsB);
+    }
+  }
+
+  Dict DormandPrince::get_stats(void* mem) const {
+    Dict stats = Integrator::get_stats(mem);
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+    stats["nsteps"] = m->nsteps;
+    stats["nrejected"] = m->nrejected;
+    stats["nfevals"] = m->nfevals;
+    stats["nstepsB"] = m->nstepsB;
+    stats["nrejectedB"] = m->nrejectedB;
+    stats["nfevalsB"] = m->nfevalsB;
+    return stats;
+  }
+
+} // namespace casadi
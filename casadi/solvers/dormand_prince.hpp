@@ -0,0 +1,182 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_DORMAND_PRINCE_HPP
+#define CASADI_DORMAND_PRINCE_HPP
+
+#include "casadi/core/integrator_impl.hpp"
+#include <casadi/solvers/casadi_integrator_dopri_export.h>
+
+/** \defgroup plugin_Integrator_dopri
+      Adaptive explicit Runge-Kutta integrator for ODEs, using the
+      Dormand-Prince 5(4) embedded pair with error control and dense output.
+
+      The steps do not depend on the output time grid: outputs between steps
+      are obtained by interpolation. When backward states are present, the
+      forward solution is stored and interpolated during the backward integration.
+*/
+/** \pluginsection{Integrator,dopri} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_INTEGRATOR_DOPRI_EXPORT DormandPrinceMemory : public IntegratorMemory {
+    // Current time and step size
+    double t, h;
+
+    // Start time and step size of the last accepted step
+    double t_last, h_last;
+
+    // Parameters
+    std::vector<double> p, rp;
+
+    // Forward state [x; q], backward state [rx; rq]
+    std::vector<double> y, ry;
+
+    // Stage derivatives, state at the end of a step, work vectors
+    std::vector<double> k, y1, ytmp, xtmp;
+
+    // Dense output coefficients of the last accepted step
+    std::vector<double> cont;
+
+    // Tape of accepted forward steps (start time, step size, dense output for x)
+    std::vector<double> tape_t, tape_h, tape_cont;
+
+    // Position in the tape during the backward integration
+    int itape;
+
+    // Statistics
+    int nsteps, nfevals, nrejected, nstepsB, nfevalsB, nrejectedB;
+  };
+
+  /** \brief \pluginbrief{Integrator,dopri}
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_dopri
+  */
+  class CASADI_INTEGRATOR_DOPRI_EXPORT DormandPrince : public Integrator {
+  public:
+
+    /// Constructor
+    explicit DormandPrince(const std::string& name, const Function& dae);
+
+    /** \brief  Create a new integrator */
+    static Integrator* creator(const std::string& name, const Function& dae) {
+      return new DormandPrince(name, dae);
+    }
+
+    /// Destructor
+    ~DormandPrince() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "dopri";}
+
+    // Get name of the class
+    std::string class_name() const override { return "DormandPrince";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Initialize stage
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new DormandPrinceMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<DormandPrinceMemory*>(mem);}
+
+    /** \brief Reset the forward problem */
+    void reset(IntegratorMemory* mem, double t,
+               const double* x, const double* z, const double* p) const override;
+
+    /** \brief  Advance solution in time */
+    void advance(IntegratorMemory* mem, double t,
+                 double* x, double* z, double* q) const override;
+
+    /** \brief Reset the backward problem */
+    void resetB(IntegratorMemory* mem, double t,
+                const double* rx, const double* rz, const double* rp) const override;
+
+    /** \brief  Retreat solution in time */
+    void retreat(IntegratorMemory* mem, double t,
+                 double* rx, double* rz, double* rq) const override;
+
+    /** \brief  Print solver statistics */
+    void print_stats(IntegratorMemory* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /// Right-hand side of the forward or backward problem, in forward time
+    int rhs(DormandPrinceMemory* m, bool backward, double t,
+            const double* y, double* yp) const;
+
+    /// Weighted root mean square norm of the error estimate
+    double err_norm(bool backward, const double* y, const double* y1, const double* e) const;
+
+    /// Initial step size, following Hairer, Norsett and Wanner
+    double initial_step(DormandPrinceMemory* m, bool backward, double t,
+                        const double* y, double hmax) const;
+
+    /// Attempt a step, returns the error estimate
+    double step(DormandPrinceMemory* m, bool backward, double t, double h,
+                const double* y) const;
+
+    /// Calculate the dense output coefficients of a step
+    static void dense_coeff(int n, int ld, double h, const double* y,
+                            const double* y1, const double* k, double* cont);
+
+    /// Evaluate the dense output
+    static void dense_eval(int n, double theta, const double* cont, double* y);
+
+    /// Take steps until (and possibly past) t_end, without passing t_stop
+    void integrate(DormandPrinceMemory* m, bool backward, double t_end, double t_stop) const;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Continuous time dynamics
+    Function f_, g_;
+
+    /// Options
+    double abstol_, reltol_, max_step_size_;
+    int max_num_steps_;
+
+    /// Forward and backward state dimensions, including quadratures
+    int ny_, nry_;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_DORMAND_PRINCE_HPP
@@ -0,0 +1,66 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "dormand_prince.hpp"
+      #include <string>
+
+      const std::string casadi::DormandPrince::meta_doc=
+      "\n"
+"Adaptive explicit Runge-Kutta integrator for ODEs, using the Dormand-\n"
+"Prince 5(4) embedded pair with error control and dense output.\n"
+"\n"
+"The steps do not depend on the output time grid: outputs between steps\n"
+"are obtained by interpolation. When backward states are present, the\n"
+"forward solution is stored and interpolated during the backward\n"
+"integration.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| abstol          | OT_DOUBLE       | 1e-8            | Absolute        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_num_steps   | OT_INT          | 10000           | Maximum number  |\n"
+"|                 |                 |                 | of integrator   |\n"
+"|                 |                 |                 | steps           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_step_size   | OT_DOUBLE       | 0/inf           | Max step size   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| reltol          | OT_DOUBLE       | 1e-6            | Relative        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -173,7 +173,8 @@ namespace casadi {
     m->res[NLPSOL_X] = m->x;
 
     // Solve the NLP
-    solver_(m->arg, m->res, m->iw, m->w, 0);
+    scoped_checkout<FunctionInternal> mem_solver(solver_.get());
+    solver_(m->arg, m->res, m->iw, m->w, mem_solver);
     m->solver_stats = solver_.stats();
 
     // Get the implicit variable
@@ -194,7 +195,8 @@ namespace casadi {
       m->arg[iin_] = m->x;
       copy_n(m->ires, n_out_, m->res);
       m->res[iout_] = 0;
-      oracle_(m->arg, m->res, m->iw, m->w, 0);
+      scoped_checkout<FunctionInternal> mem_oracle(oracle_.get());
+      oracle_(m->arg, m->res, m->iw, m->w, mem_oracle);
     }
   }
 
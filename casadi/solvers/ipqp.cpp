@@ -0,0 +1,236 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "ipqp.hpp"
+#include "casadi/core/sparsity_internal.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_IPQP_EXPORT
+  casadi_register_conic_ipqp(Conic::Plugin* plugin) {
+    plugin->creator = Ipqp::creator;
+    plugin->name = "ipqp";
+    plugin->doc = Ipqp::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Ipqp::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_IPQP_EXPORT casadi_load_conic_ipqp() {
+    Conic::registerPlugin(casadi_register_conic_ipqp);
+  }
+
+  Ipqp::Ipqp(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Ipqp::~Ipqp() {
+    clear_mem();
+  }
+
+  Options Ipqp::options_
+  = {{&Conic::options_},
+     {{"tol",
+       {OT_DOUBLE,
+        "Tolerance for the primal and dual residuals and the complementarity [1e-8]"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of iterations [100]"}},
+      {"warm_start",
+       {OT_BOOL,
+        "Start close to the initial guess for the primal and dual variables, "
+        "rather than from well inside the feasible region [false]"}},
+      {"ordering",
+       {OT_STRING,
+        "Fill-reducing ordering of the KKT matrix: 'natural' or 'amd' (default)"}}
+     }
+  };
+
+  void Ipqp::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+
+    // Default options
+    tol_ = 1e-8;
+    max_iter_ = 100;
+    warm_start_ = false;
+    ordering_ = "amd";
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="tol") {
+        tol_ = op.second;
+      } else if (op.first=="max_iter") {
+        max_iter_ = op.second;
+      } else if (op.first=="warm_start") {
+        warm_start_ = op.second;
+      } else if (op.first=="ordering") {
+        ordering_ = op.second.to_string();
+      }
+    }
+
+    // Symmetric sparsity pattern of the KKT matrix [H + D_x, A'; A, -D_a]
+    int nz = nx_ + na_;
+    Sparsity kkt = Sparsity::blockcat({{H_ + Sparsity::diag(nx_), A_.T()},
+                                       {A_, Sparsity::diag(na_)}});
+
+    // Fill-reducing ordering
+    if (ordering_=="natural") {
+      perm_ = range(nz);
+    } else if (ordering_=="amd") {
+      perm_ = kkt->amd(1);
+      perm_.resize(nz);
+    } else {
+      casadi_error("Unknown ordering '" + ordering_ + "'. Allowed values: natural, amd.");
+    }
+    vector<int> pinv(nz);
+    for (int k=0; k<nz; ++k) pinv[perm_[k]] = k;
+
+    // Upper triangular part of the permuted KKT matrix
+    vector<int> r, c;
+    const int *colind = kkt.colind(), *row = kkt.row();
+    for (int cc=0; cc<nz; ++cc) {
+      for (int k=colind[cc]; k<colind[cc+1] && row[k]<=cc; ++k) {
+        r.push_back(std::min(pinv[row[k]], pinv[cc]));
+        c.push_back(std::max(pinv[row[k]], pinv[cc]));
+      }
+    }
+    sp_kkt_ = Sparsity::triplet(nz, nz, r, c);
+
+    // Symbolic factorization
+    sp_l_ = (sp_kkt_ + sp_kkt_.T()).ldl(parent_);
+
+    // Position of an entry of the KKT matrix in the permuted upper triangular part
+    auto kkt_nz = [&](int i, int j) {
+      return sp_kkt_.get_nz(std::min(pinv[i], pinv[j]), std::max(pinv[i], pinv[j]));
+    };
+
+    // Nonzeros of H, upper triangular part only
+    kkt_h_.resize(H_.nnz());
+    colind = H_.colind();
+    row = H_.row();
+    for (int cc=0; cc<nx_; ++cc) {
+      for (int k=colind[cc]; k<colind[cc+1]; ++k) {
+        kkt_h_[k] = row[k]<=cc ? kkt_nz(row[k], cc) : -1;
+      }
+    }
+
+    // Nonzeros of A, placed in the upper right block
+    kkt_a_.resize(A_.nnz());
+    colind = A_.colind();
+    row = A_.row();
+    for (int cc=0; cc<nx_; ++cc) {
+      for (int k=colind[cc]; k<colind[cc+1]; ++k) {
+        kkt_a_[k] = kkt_nz(cc, nx_ + row[k]);
+      }
+    }
+
+    // Diagonal entries
+    kkt_d_.resize(nz);
+    for (int i=0; i<nz; ++i) kkt_d_[i] = kkt_nz(i, i);
+
+    // Problem structure
+    p_.nx = nx_;
+    p_.na = na_;
+    p_.sp_h = H_;
+    p_.sp_a = A_;
+    p_.sp_kkt = sp_kkt_;
+    p_.sp_l = sp_l_;
+    p_.parent = get_ptr(parent_);
+    p_.perm = get_ptr(perm_);
+    p_.kkt_h = get_ptr(kkt_h_);
+    p_.kkt_a = get_ptr(kkt_a_);
+    p_.kkt_d = get_ptr(kkt_d_);
+    p_.tol = tol_;
+    p_.reg = 1e-9;
+    p_.s0 = warm_start_ ? 1e-3 : 1;
+    p_.max_iter = max_iter_;
+
+    // Allocate work vectors
+    int sz_iw, sz_w;
+    casadi_ipqp_work(&p_, &sz_iw, &sz_w);
+    alloc_iw(sz_iw, true);
+    alloc_w(sz_w, true);
+  }
+
+  int Ipqp::init_mem(void* mem) const {
+    auto m = static_cast<IpqpMemory*>(mem);
+    m->fstats["solver"] = FStats();
+    m->iter = 0;
+    m->flag = 0;
+    return 0;
+  }
+
+  int Ipqp::eval(const double** arg, double** res, int* iw, double* w, void* mem) const {
+    auto m = static_cast<IpqpMemory*>(mem);
+    for (auto&& s : m->fstats) s.second.reset();
+    m->fstats.at("solver").tic();
+    m->flag = casadi_ipqp(&p_, arg[CONIC_H], arg[CONIC_G], arg[CONIC_A],
+                          arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA],
+                          arg[CONIC_X0], arg[CONIC_LAM_X0], arg[CONIC_LAM_A0],
+                          res[CONIC_X], res[CONIC_COST], res[CONIC_LAM_A], res[CONIC_LAM_X],
+                          &m->iter, iw, w);
+    m->fstats.at("solver").toc();
+    if (m->flag==1 && verbose_) casadi_warning("Maximum number of iterations reached");
+    if (print_time_) print_fstats(m);
+    return m->flag==2 ? 1 : 0;
+  }
+
+  void Ipqp::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_IPQP);
+    g.local("p", "struct casadi_ipqp_prob");
+    g.init_local("p", "{" + str(nx_) + ", " + str(na_) + ", "
+                 + g.sparsity(H_) + ", " + g.sparsity(A_) + ", "
+                 + g.sparsity(sp_kkt_) + ", " + g.sparsity(sp_l_) + ", "
+                 + g.constant(parent_) + ", " + g.constant(perm_) + ", "
+                 + g.constant(kkt_h_) + ", " + g.constant(kkt_a_) + ", "
+                 + g.constant(kkt_d_) + ", "
+                 + g.constant(p_.tol) + ", " + g.constant(p_.reg) + ", "
+                 + g.constant(p_.s0) + ", " + str(p_.max_iter) + "}");
+    g.local("iter", "int");
+    auto a = [](int i) { return "arg[" + str(i) + "]";};
+    auto r = [](int i) { return "res[" + str(i) + "]";};
+    g << "if (casadi_ipqp(&p, " << a(CONIC_H) << ", " << a(CONIC_G) << ", " << a(CONIC_A) << ", "
+      << a(CONIC_LBX) << ", " << a(CONIC_UBX) << ", " << a(CONIC_LBA) << ", "
+      << a(CONIC_UBA) << ", " << a(CONIC_X0) << ", " << a(CONIC_LAM_X0) << ", "
+      << a(CONIC_LAM_A0) << ", " << r(CONIC_X) << ", " << r(CONIC_COST) << ", "
+      << r(CONIC_LAM_A) << ", " << r(CONIC_LAM_X) << ", &iter, iw, w)==2) return 1;\n";
+  }
+
+  Dict Ipqp::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<IpqpMemory*>(mem);
+    stats["iter_count"] = m->iter;
+    stats["success"] = m->flag==0;
+    stats["return_status"] = m->flag==0 ? "SUCCESS" :
+      m->flag==1 ? "MAXIMUM_ITERATIONS_REACHED" : "NUMERICAL_ERROR";
+    return stats;
+  }
+
+} // namespace casadi
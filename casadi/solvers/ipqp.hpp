@@ -0,0 +1,136 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_IPQP_HPP
+#define CASADI_IPQP_HPP
+
+#include "casadi/core/conic_impl.hpp"
+#include <casadi/solvers/casadi_conic_ipqp_export.h>
+
+/** \defgroup plugin_Conic_ipqp
+    Sparse primal-dual interior point QP solver, implemented in CasADi's C runtime
+
+    Mehrotra's predictor-corrector method is used, where each iteration factorizes
+    a regularized, quasidefinite KKT system with a sparse LDL^T factorization.
+    The symbolic factorization, including the fill-reducing ordering, is computed
+    once when the solver is created. The solver supports warm starts from the
+    primal and dual initial guesses and C code generation.
+*/
+
+/** \pluginsection{Conic,ipqp} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  struct CASADI_CONIC_IPQP_EXPORT IpqpMemory : public ConicMemory {
+    // Number of iterations
+    int iter;
+    // Return flag of casadi_ipqp
+    int flag;
+  };
+
+  /** \brief \pluginbrief{Conic,ipqp}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_ipqp
+  */
+  class CASADI_CONIC_IPQP_EXPORT Ipqp : public Conic {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Ipqp(const std::string& name,
+                  const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Ipqp(name, st);
+    }
+
+    /** \brief  Destructor */
+    ~Ipqp() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "ipqp";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Ipqp";}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new IpqpMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<IpqpMemory*>(mem);}
+
+    /** \brief  Evaluate numerically */
+    int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Options
+    double tol_;
+    int max_iter_;
+    bool warm_start_;
+    std::string ordering_;
+
+    // Fill-reducing permutation of the KKT matrix
+    std::vector<int> perm_;
+
+    // Permuted KKT matrix, upper triangular part, and its symbolic factorization
+    Sparsity sp_kkt_, sp_l_;
+    std::vector<int> parent_;
+
+    // Nonzeros of the KKT matrix corresponding to the nonzeros of H, A and the diagonal
+    std::vector<int> kkt_h_, kkt_a_, kkt_d_;
+
+    // Problem structure passed to casadi_ipqp
+    casadi_ipqp_prob<double> p_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_IPQP_HPP
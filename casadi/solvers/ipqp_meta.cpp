@@ -0,0 +1,77 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "ipqp.hpp"
+      #include <string>
+
+      const std::string casadi::Ipqp::meta_doc=
+      "\n"
+"Sparse primal-dual interior point QP solver, implemented in CasADi's C\n"
+"runtime\n"
+"\n"
+"Mehrotra's predictor-corrector method is used, where each iteration\n"
+"factorizes a regularized, quasidefinite KKT system with a sparse LDL^T\n"
+"factorization. The symbolic factorization, including the fill-reducing\n"
+"ordering, is computed once when the solver is created. The solver\n"
+"supports warm starts from the primal and dual initial guesses and C code\n"
+"generation.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| max_iter        | OT_INT          | 100             | Maximum number  |\n"
+"|                 |                 |                 | of iterations   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| ordering        | OT_STRING       | amd             | Fill-reducing   |\n"
+"|                 |                 |                 | ordering of the |\n"
+"|                 |                 |                 | KKT matrix:     |\n"
+"|                 |                 |                 | 'natural' or    |\n"
+"|                 |                 |                 | 'amd'           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| tol             | OT_DOUBLE       | 1e-8            | Tolerance for   |\n"
+"|                 |                 |                 | the primal and  |\n"
+"|                 |                 |                 | dual residuals  |\n"
+"|                 |                 |                 | and the         |\n"
+"|                 |                 |                 | complementarity |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| warm_start      | OT_BOOL         | false           | Start close to  |\n"
+"|                 |                 |                 | the initial     |\n"
+"|                 |                 |                 | guess for the   |\n"
+"|                 |                 |                 | primal and dual |\n"
+"|                 |                 |                 | variables,      |\n"
+"|                 |                 |                 | rather than     |\n"
+"|                 |                 |                 | from well       |\n"
+"|                 |                 |                 | inside the      |\n"
+"|                 |                 |                 | feasible region |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -50,7 +50,9 @@ namespace casadi {
        {OT_STRINGVECTOR,
         "Sets, for each grid dimenion, the lookup algorithm used to find the correct index. "
         "'linear' uses a for-loop + break; "
-        "'exact' uses floored division (only for uniform grids)."}}
+        "'exact' uses floored division (only for uniform grids); "
+        "'binary' uses a binary search; "
+        "'hint' searches outwards from the interval found in the previous call."}}
      }
   };
 
@@ -63,6 +65,7 @@ namespace casadi {
   }
 
   LinearInterpolant::~LinearInterpolant() {
+    clear_mem();
   }
 
   void LinearInterpolant::init(const Dict& opts) {
@@ -91,9 +94,13 @@ namespace casadi {
               grid_.begin()+offset_[i],
               grid_.begin()+offset_[i+1]);
           casadi_assert_dev(is_increasing(grid) && is_equally_spaced(grid));
+        } else if (lookup_mode[i]=="binary") {
+          lookup_mode_[i] = 2;
+        } else if (lookup_mode[i]=="hint") {
+          lookup_mode_[i] = 3;
         } else {
           casadi_error("Unknown lookup_mode option '" + lookup_mode[i] + ". "
-                       "Allowed values: linear, exact.");
+                       "Allowed values: linear, exact, binary, hint.");
         }
       }
     }
@@ -105,16 +112,30 @@ namespace casadi {
     alloc_iw(2*ndim_, true);
   }
 
+  int LinearInterpolant::init_mem(void* mem) const {
+    auto m = static_cast<LinearInterpolantMemory*>(mem);
+    m->hint.assign(ndim_, 0);
+    return 0;
+  }
+
   int LinearInterpolant::
   eval(const double** arg, double** res, int* iw, double* w, void* mem) const {
+    auto m = static_cast<LinearInterpolantMemory*>(mem);
     if (res[0]) {
+      // The intervals are returned in iw, doubling as the hints for the lookup
+      casadi_copy_int(get_ptr(m->hint), ndim_, iw);
       res[0][0] = casadi_interpn(ndim_, get_ptr(grid_), get_ptr(offset_),
                                  get_ptr(values_), arg[0], get_ptr(lookup_mode_), iw, w);
+      casadi_copy_int(iw, ndim_, get_ptr(m->hint));
     }
     return 0;
   }
 
   void LinearInterpolant::codegen_body(CodeGenerator& g) const {
+    // Starting point for lookup_mode 'hint'
+    if (std::count(lookup_mode_.begin(), lookup_mode_.end(), 3)) {
+      g << "  casadi_fill_int(iw, " << ndim_ << ", 0);\n";
+    }
     g << "  if (res[0]) {\n"
       << "    res[0][0] = " << g.interpn(ndim_, g.constant(grid_), g.constant(offset_),
       g.constant(values_), "arg[0]", g.constant(lookup_mode_), "iw", "w") << "\n"
@@ -37,6 +37,12 @@
 /// \cond INTERNAL
 
 namespace casadi {
+  /** \brief Memory for LinearInterpolant */
+  struct CASADI_INTERPOLANT_LINEAR_EXPORT LinearInterpolantMemory {
+    /// Intervals found in the previous call, starting point for lookup_mode 'hint'
+    std::vector<int> hint;
+  };
+
   /** \brief \pluginbrief{Interpolant,linear}
     Implements a multilinear interpolant: For 1D, the interpolating polynomial
     will be linear. For 2D, the interpolating polynomial will be bilinear, etc.
@@ -74,6 +80,15 @@ namespace casadi {
     // Initialize
     void init(const Dict& opts) override;
 
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new LinearInterpolantMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<LinearInterpolantMemory*>(mem);}
+
     /// Evaluate numerically
     int eval(const double** arg, double** res, int* iw, double* w, void* mem) const override;
 
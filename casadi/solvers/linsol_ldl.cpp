@@ -25,6 +25,7 @@
 
 #include "linsol_ldl.hpp"
 #include "casadi/core/global_options.hpp"
+#include "casadi/core/sparsity_internal.hpp"
 
 using namespace std;
 namespace casadi {
@@ -45,6 +46,17 @@ namespace casadi {
     LinsolInternal::registerPlugin(casadi_register_linsol_ldl);
   }
 
+  Options LinsolLdl::options_
+  = {{&ProtoFunction::options_},
+     {{"ordering",
+       {OT_STRING,
+        "Fill-reducing ordering of the rows and columns: 'natural' (default) or 'amd'"}},
+      {"supernodal",
+       {OT_BOOL,
+        "Factorize groups of columns with identical sparsity with dense kernels [false]"}}
+     }
+  };
+
   LinsolLdl::LinsolLdl(const std::string& name, const Sparsity& sp)
     : LinsolInternal(name, sp) {
   }
@@ -57,8 +69,87 @@ namespace casadi {
     // Call the init method of the base class
     LinsolInternal::init(opts);
 
+    // Default options
+    ordering_ = "natural";
+    supernodal_ = false;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="ordering") {
+        ordering_ = op.second.to_string();
+      } else if (op.first=="supernodal") {
+        supernodal_ = op.second;
+      }
+    }
+
+    // Fill-reducing ordering
+    int n = nrow();
+    if (ordering_=="natural") {
+      p_.clear();
+    } else if (ordering_=="amd") {
+      p_ = sp_->amd(1);
+      p_.resize(n);
+    } else {
+      casadi_error("Unknown ordering '" + ordering_ + "'. Allowed values: natural, amd.");
+    }
+
+    if (p_.empty() && !supernodal_) {
+      // Use the upper triangular part of A directly
+      sp_a_ = sp_;
+      a_map_.clear();
+    } else {
+      // Inverse permutation
+      vector<int> pinv(n);
+      for (int k=0; k<n; ++k) pinv[p_.empty() ? k : p_[k]] = k;
+
+      // Symmetric pattern of P*A*P', constructed from the upper triangular part of A
+      const int *colind = sp_.colind(), *row = sp_.row();
+      vector<int> r, c, nz;
+      for (int cc=0; cc<n; ++cc) {
+        for (int k=colind[cc]; k<colind[cc+1] && row[k]<=cc; ++k) {
+          r.push_back(pinv[row[k]]);
+          c.push_back(pinv[cc]);
+          nz.push_back(k);
+          if (row[k]==cc) continue;
+          r.push_back(pinv[cc]);
+          c.push_back(pinv[row[k]]);
+          nz.push_back(k);
+        }
+      }
+      sp_a_ = Sparsity::triplet(n, n, r, c);
+
+      // Corresponding nonzeros of A
+      a_map_.resize(sp_a_.nnz());
+      for (int k=0; k<nz.size(); ++k) a_map_[sp_a_.get_nz(r[k], c[k])] = nz[k];
+    }
+
     // Symbolic factorization
-    sp_L_ = sp_.ldl(parent_);
+    sp_L_ = sp_a_.ldl(parent_);
+    sz_iw_ = 3*n;
+    sz_w_ = n;
+
+    // Supernodes: column j+1 is merged with column j if it is the parent of j
+    // in the elimination tree and the sparsity patterns below the diagonal coincide
+    sn_.clear();
+    if (supernodal_ && n>0) {
+      const int* l_colind = sp_L_.colind();
+      sn_.push_back(0);
+      for (int j=0; j+1<n; ++j) {
+        if (parent_[j]!=j+1 || l_colind[j+1]-l_colind[j]!=l_colind[j+2]-l_colind[j+1]+1) {
+          sn_.push_back(j+1);
+        }
+      }
+      sn_.push_back(n);
+
+      // Work vectors for the dense kernels
+      int nsn = sn_.size()-1, max_nc = 0, max_len = 0;
+      for (int s=0; s<nsn; ++s) {
+        max_nc = std::max(max_nc, sn_[s+1]-sn_[s]);
+        max_len = std::max(max_len, 1+l_colind[sn_[s]+1]-l_colind[sn_[s]]);
+      }
+      sz_iw_ += 3*nsn;
+      sz_w_ = std::max(sz_w_, static_cast<size_t>(max_nc*max_len));
+    }
   }
 
   int LinsolLdl::init_mem(void* mem) const {
@@ -67,10 +158,11 @@ namespace casadi {
 
     // Work vectors
     int nrow = this->nrow();
+    m->a.resize(a_map_.size());
     m->d.resize(nrow);
     m->l.resize(sp_L_.nnz());
-    m->iw.resize(2*nrow);
-    m->w.resize(nrow);
+    m->iw.resize(sz_iw_);
+    m->w.resize(sz_w_);
 
     return 0;
   }
@@ -81,14 +173,42 @@ namespace casadi {
 
   int LinsolLdl::nfact(void* mem, const double* A) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl(sp_, get_ptr(parent_), sp_L_,
-               A, get_ptr(m->l), get_ptr(m->d), get_ptr(m->iw), get_ptr(m->w));
+    m->nfact_stats.tic();
+
+    // Nonzeros of the permuted matrix
+    const double* a = A;
+    if (!a_map_.empty()) {
+      for (int k=0; k<a_map_.size(); ++k) m->a[k] = A[a_map_[k]];
+      a = get_ptr(m->a);
+    }
+
+    // Numeric factorization
+    if (sn_.empty()) {
+      casadi_ldl(sp_a_, get_ptr(parent_), sp_L_,
+                 a, get_ptr(m->l), get_ptr(m->d), get_ptr(m->iw), get_ptr(m->w));
+    } else {
+      casadi_ldl_sn(sp_a_, sp_L_, static_cast<int>(sn_.size())-1, get_ptr(sn_),
+                    a, get_ptr(m->l), get_ptr(m->d), get_ptr(m->iw), get_ptr(m->w));
+    }
+    m->nfact_stats.toc();
     return 0;
   }
 
   int LinsolLdl::solve(void* mem, const double* A, double* x, int nrhs, bool tr) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl_solve(x, nrhs, sp_L_, get_ptr(m->l), get_ptr(m->d));
+    if (p_.empty()) {
+      casadi_ldl_solve(x, nrhs, sp_L_, get_ptr(m->l), get_ptr(m->d));
+    } else {
+      // Solve P*A*P' * (P*x) = P*b
+      int n = nrow();
+      double* w = get_ptr(m->w);
+      for (int k=0; k<nrhs; ++k) {
+        for (int i=0; i<n; ++i) w[i] = x[p_[i]];
+        casadi_ldl_solve(w, 1, sp_L_, get_ptr(m->l), get_ptr(m->d));
+        for (int i=0; i<n; ++i) x[p_[i]] = w[i];
+        x += n;
+      }
+    }
     return 0;
   }
 
@@ -110,4 +230,67 @@ namespace casadi {
     return ret;
   }
 
+  Dict LinsolLdl::get_stats(void* mem) const {
+    Dict stats = LinsolInternal::get_stats(mem);
+    auto m = static_cast<LinsolLdlMemory*>(mem);
+    stats["ordering"] = ordering_;
+    stats["nnz_a"] = static_cast<int>(sp_a_.get_upper().size());
+    stats["nnz_l"] = sp_L_.nnz();
+    if (!sn_.empty()) stats["n_supernodes"] = static_cast<int>(sn_.size())-1;
+    stats["n_call_nfact"] = m->nfact_stats.n_call;
+    stats["t_wall_nfact"] = m->nfact_stats.t_wall;
+    stats["t_proc_nfact"] = m->nfact_stats.t_proc;
+    return stats;
+  }
+
+  void LinsolLdl::generate(CodeGenerator& g, const std::string& A, const std::string& x,
+                           int nrhs, bool tr) const {
+    // Codegen the integer vectors
+    string sp_a = g.sparsity(sp_a_);
+    string sp_l = g.sparsity(sp_L_);
+    int n = nrow();
+
+    // Place in block to avoid conflicts caused by local variables
+    g << "{\n";
+    g << "casadi_real l[" << sp_L_.nnz() << "], d[" << n << "], w[" << sz_w_ << "];\n";
+    if (!a_map_.empty()) g << "casadi_real a[" << a_map_.size() << "];\n";
+    g << "int iw[" << sz_iw_ << "];\n";
+    if (!p_.empty()) {
+      g << "int i, k;\n";
+    } else if (!a_map_.empty()) {
+      g << "int k;\n";
+    }
+
+    // Nonzeros of the permuted matrix
+    string a = A;
+    if (!a_map_.empty()) {
+      a = "a";
+      g << "for (k=0; k<" << a_map_.size() << "; ++k) "
+        << "a[k] = " << A << "[" << g.constant(a_map_) << "[k]];\n";
+    }
+
+    // Factorize
+    if (sn_.empty()) {
+      g << g.ldl(sp_a, g.constant(parent_), sp_l, a, "l", "d", "iw", "w") << "\n";
+    } else {
+      g << g.ldl_sn(sp_a, sp_l, static_cast<int>(sn_.size())-1, g.constant(sn_),
+                    a, "l", "d", "iw", "w") << "\n";
+    }
+
+    // Solve
+    if (p_.empty()) {
+      g << g.ldl_solve(x, nrhs, sp_l, "l", "d") << "\n";
+    } else {
+      string p = g.constant(p_);
+      g << "for (k=0; k<" << nrhs << "; ++k) {\n"
+        << "for (i=0; i<" << n << "; ++i) w[i] = " << x << "[k*" << n << "+" << p << "[i]];\n"
+        << g.ldl_solve("w", 1, sp_l, "l", "d") << "\n"
+        << "for (i=0; i<" << n << "; ++i) " << x << "[k*" << n << "+" << p << "[i]] = w[i];\n"
+        << "}\n";
+    }
+
+    // End of block
+    g << "}\n";
+  }
+
 } // namespace casadi
@@ -34,12 +34,15 @@
 
 /// \cond INTERNAL
 #include "casadi/core/linsol_internal.hpp"
+#include "casadi/core/timing.hpp"
 #include <casadi/solvers/casadi_linsol_ldl_export.h>
 
 namespace casadi {
   struct CASADI_LINSOL_LDL_EXPORT LinsolLdlMemory : public LinsolMemory {
     std::vector<int> iw;
-    std::vector<double> l, d, w;
+    std::vector<double> a, l, d, w;
+    // Timing of the numeric factorization
+    FStats nfact_stats;
   };
 
   /** \brief \pluginbrief{LinsolInternal,ldl}
@@ -60,6 +63,12 @@ namespace casadi {
     // Destructor
     ~LinsolLdl() override;
 
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
     // Initialize the solver
     void init(const Dict& opts) override;
 
@@ -87,6 +96,13 @@ namespace casadi {
     /// Matrix rank
     int rank(void* mem, const double* A) const override;
 
+    /// Generate C code
+    void generate(CodeGenerator& g, const std::string& A, const std::string& x,
+                  int nrhs, bool tr) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
     /// A documentation string
     static const std::string meta_doc;
 
@@ -96,9 +112,27 @@ namespace casadi {
     // Get name of the class
     std::string class_name() const override { return "LinsolLdl";}
 
+    // Options
+    std::string ordering_;
+    bool supernodal_;
+
+    // Fill-reducing permutation, empty if natural ordering
+    std::vector<int> p_;
+
+    // Sparsity pattern of the permuted matrix and the corresponding nonzeros of A,
+    // a_map_ is empty if the nonzeros of A can be used directly
+    Sparsity sp_a_;
+    std::vector<int> a_map_;
+
     // Symbolic factorization
     std::vector<int> parent_;
     Sparsity sp_L_;
+
+    // Supernode partition of the columns of L, empty if not supernodal
+    std::vector<int> sn_;
+
+    // Work vector sizes
+    size_t sz_iw_, sz_w_;
   };
 
 } // namespace casadi
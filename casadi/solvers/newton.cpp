@@ -156,8 +156,8 @@ namespace casadi {
       }
 
       // Factorize the linear solver with J
-      linsol_.nfact(m->jac);
-      linsol_.solve(m->jac, m->f, 1, false);
+      linsol_.nfact(m->jac, m->mem_linsol);
+      linsol_.solve(m->jac, m->f, 1, false, m->mem_linsol);
 
       // Check convergence again
       double abstolStep=0;
@@ -217,7 +217,16 @@ namespace casadi {
     auto m = static_cast<NewtonMemory*>(mem);
     m->return_status = 0;
     m->iter = 0;
+
+    // Separate linear solver memory, for evaluation in parallel
+    m->mem_linsol = linsol_.checkout();
     return 0;
   }
 
+  void Newton::free_mem(void *mem) const {
+    auto m = static_cast<NewtonMemory*>(mem);
+    linsol_.release(m->mem_linsol);
+    delete m;
+  }
+
 } // namespace casadi
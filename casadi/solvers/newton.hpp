@@ -51,6 +51,8 @@ namespace casadi {
     const char* return_status;
     // Number of iterations
     int iter;
+    // Memory object of the linear solver
+    int mem_linsol;
   };
 
   /** \brief \pluginbrief{Rootfinder,newton}
@@ -96,7 +98,7 @@ namespace casadi {
     int init_mem(void* mem) const override;
 
     /** \brief Free memory block */
-    void free_mem(void *mem) const override { delete static_cast<NewtonMemory*>(mem);}
+    void free_mem(void *mem) const override;
 
     /** \brief Set the (persistent) work vectors */
     void set_work(void* mem, const double**& arg, double**& res,
@@ -181,7 +181,8 @@ namespace casadi {
     res1[NLPSOL_LAM_G] = lam_a_;
 
     // Solve the NLP
-    return solver_(arg1, res1, iw, w, 0);
+    scoped_checkout<FunctionInternal> mem_solver(solver_.get());
+    return solver_(arg1, res1, iw, w, mem_solver);
   }
 
 } // namespace casadi
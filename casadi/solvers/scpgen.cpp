@@ -771,7 +771,8 @@ namespace casadi {
       for (int i=0; i<v_.size(); ++i) {
         m->res[i] = m->lifted_mem[i].x0;
       }
-      vinit_fcn_(m->arg, m->res, m->iw, m->w, 0);
+      scoped_checkout<FunctionInternal> mem_vinit_fcn(vinit_fcn_.get());
+      vinit_fcn_(m->arg, m->res, m->iw, m->w, mem_vinit_fcn);
     }
     if (verbose_) {
       uout() << "Passed initial guess" << endl;
@@ -1015,7 +1016,8 @@ namespace casadi {
     m->res[mat_hes_] = gauss_newton_ ? m->qpL : m->qpH; // Condensed Hessian
 
     // Calculate condensed QP matrices
-    mat_fcn_(m->arg, m->res, m->iw, m->w, 0);
+    scoped_checkout<FunctionInternal> mem_mat_fcn(mat_fcn_.get());
+    mat_fcn_(m->arg, m->res, m->iw, m->w, mem_mat_fcn);
 
     if (gauss_newton_) {
       // Gauss-Newton Hessian
@@ -1068,7 +1070,8 @@ namespace casadi {
     m->res[res_p_d_] = m->lam_p; // Parameter sensitivities
 
     // Evaluate residual function
-    res_fcn_(m->arg, m->res, m->iw, m->w, 0);
+    scoped_checkout<FunctionInternal> mem_res_fcn(res_fcn_.get());
+    res_fcn_(m->arg, m->res, m->iw, m->w, mem_res_fcn);
 
     double time2 = clock();
     m->t_eval_res += (time2-time1)/CLOCKS_PER_SEC;
@@ -1098,7 +1101,8 @@ namespace casadi {
     m->res[vec_g_] = m->qpB;
 
     // Calculate condensed QP vectors
-    vec_fcn_(m->arg, m->res, m->iw, m->w, 0);
+    scoped_checkout<FunctionInternal> mem_vec_fcn(vec_fcn_.get());
+    vec_fcn_(m->arg, m->res, m->iw, m->w, mem_vec_fcn);
 
     // Linear offset in the reduced QP
     casadi_scal(ng_, -1., m->qpB);
@@ -1177,7 +1181,8 @@ namespace casadi {
     m->res[CONIC_LAM_A] = m->dlam_gk; // Multipliers (linear bounds)
 
     // Solve the QP
-    qpsol_(m->arg, m->res, m->iw, m->w, 0);
+    scoped_checkout<FunctionInternal> mem_qpsol(qpsol_.get());
+    qpsol_(m->arg, m->res, m->iw, m->w, mem_qpsol);
 
     // Calculate penalty parameter of merit function
     m->sigma = merit_start_;
@@ -1313,7 +1318,8 @@ namespace casadi {
     }
 
     // Perform the step expansion
-    exp_fcn_(m->arg, m->res, m->iw, m->w, 0);
+    scoped_checkout<FunctionInternal> mem_exp_fcn(exp_fcn_.get());
+    exp_fcn_(m->arg, m->res, m->iw, m->w, mem_exp_fcn);
 
     double time2 = clock();
     m->t_eval_exp += (time2-time1)/CLOCKS_PER_SEC;
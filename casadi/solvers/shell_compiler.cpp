@@ -27,7 +27,12 @@
 #include "casadi/core/casadi_misc.hpp"
 #include "casadi/core/casadi_meta.hpp"
 #include "casadi/core/casadi_logger.hpp"
+#include "casadi/core/timing.hpp"
+#include "casadi/core/thread_pool.hpp"
 #include <fstream>
+#include <deque>
+#include <iomanip>
+#include <atomic>
 
 // Set default object file suffix
 #ifndef OBJECT_FILE_SUFFIX
@@ -55,9 +60,21 @@ namespace casadi {
     ImporterInternal::registerPlugin(casadi_register_importer_shell);
   }
 
+#ifdef WITH_THREAD
+  std::atomic<int> ShellCompiler::n_cache_hit_(0);
+  std::atomic<int> ShellCompiler::n_cache_miss_(0);
+#else // WITH_THREAD
+  int ShellCompiler::n_cache_hit_ = 0;
+  int ShellCompiler::n_cache_miss_ = 0;
+#endif // WITH_THREAD
+
   ShellCompiler::ShellCompiler(const std::string& name) :
     ImporterInternal(name) {
       handle_ = 0;
+      cache_ = false;
+      cache_hit_ = false;
+      t_compile_ = 0;
+      t_link_ = 0;
   }
 
   ShellCompiler::~ShellCompiler() {
@@ -69,8 +86,13 @@ namespace casadi {
 #endif // _WIN32
 
     if (cleanup_) {
-      if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
-      if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
+      // Cached libraries are kept for later processes
+      if (!cache_ && remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
+      if (!cache_hit_) {
+        for (auto&& obj : obj_names_) {
+          if (remove(obj.c_str())) casadi_warning("Failed to remove " + obj);
+        }
+      }
     }
   }
 
@@ -84,7 +106,15 @@ namespace casadi {
         "Linker command"}},
       {"folder",
        {OT_STRING,
-        "Folder to put temporary objects in."}},
+        "Folder to put cached shared libraries in. Default: '.'"}},
+      {"cache",
+       {OT_BOOL,
+        "Reuse a previously compiled shared library if the source code, "
+        "compiler and flags are unchanged. Default: false"}},
+      {"cache_size",
+       {OT_INT,
+        "Maximum number of shared libraries kept in the cache folder, "
+        "least recently used ones are removed first. 0 for unlimited. Default: 100"}},
       {"compiler_setup",
        {OT_STRING,
         "Compiler setup command. Intended to be fixed."
@@ -104,6 +134,14 @@ namespace casadi {
       {"linker_flags",
        {OT_STRINGVECTOR,
         "Linker flags for the JIT compiler. Default: None"}},
+      {"extra_sources",
+       {OT_STRINGVECTOR,
+        "Additional source files, compiled alongside the main one "
+        "and linked into the same shared library"}},
+      {"jobs",
+       {OT_INT,
+        "Maximum number of source files compiled concurrently. "
+        "Default: number of hardware threads"}},
       {"cleanup",
        {OT_BOOL,
         "Cleanup temporary files when unloading. Default: true"}},
@@ -123,6 +161,9 @@ namespace casadi {
     // Default options
 
     cleanup_ = true;
+    folder_ = ".";
+    cache_size_ = 100;
+    jobs_ = ThreadPool::instance().size();
 
     vector<string> compiler_flags;
     vector<string> linker_flags;
@@ -153,6 +194,17 @@ namespace casadi {
         compiler_setup = op.second.to_string();
       } else if (op.first=="cleanup") {
         cleanup_ = op.second;
+      } else if (op.first=="folder") {
+        folder_ = op.second.to_string();
+      } else if (op.first=="cache") {
+        cache_ = op.second;
+      } else if (op.first=="cache_size") {
+        cache_size_ = op.second;
+      } else if (op.first=="extra_sources") {
+        extra_sources_ = op.second;
+      } else if (op.first=="jobs") {
+        jobs_ = op.second;
+        casadi_assert(jobs_>=1, "'jobs' must be positive");
       } else if (op.first=="linker_setup") {
         linker_setup = op.second.to_string();
       } else if (op.first=="compiler_flags" || op.first=="flags") {
@@ -166,14 +218,33 @@ namespace casadi {
       }
     }
 
-    // Name of temporary file
-    obj_name_ = temporary_file("tmp_casadi_compiler_shell", OBJECT_FILE_SUFFIX);
+    // Compiler and linker commands, without file names
+    stringstream ccbase;
+    ccbase << compiler;
+    for (auto&& f : compiler_flags) ccbase << " " << f;
+    ccbase << " " << compiler_setup;
+    ccbase_ = ccbase.str();
+    compiler_output_flag_ = compiler_output_flag;
+    stringstream ldbase;
+    ldbase << linker;
+    for (auto&& f : linker_flags) ldbase << " " << f;
+    ldbase << " " << linker_setup;
+
+    // All source files
+    vector<string> sources(1, name_);
+    sources.insert(sources.end(), extra_sources_.begin(), extra_sources_.end());
+
+    // Name of temporary files
+    obj_names_.clear();
+    for (int i=0; i<sources.size(); ++i) {
+      obj_names_.push_back(temporary_file("tmp_casadi_compiler_shell", OBJECT_FILE_SUFFIX));
+    }
     bin_name_ = temporary_file("tmp_casadi_compiler_shell", SHARED_LIBRARY_SUFFIX);
 
 #ifndef _WIN32
     // Have relative paths start with ./
-    if (obj_name_.at(0)!='/') {
-      obj_name_ = "./" + obj_name_;
+    for (auto&& obj : obj_names_) {
+      if (obj.at(0)!='/') obj = "./" + obj;
     }
 
     if (bin_name_.at(0)!='/') {
@@ -181,43 +252,92 @@ namespace casadi {
     }
 #endif // _WIN32
 
-    // Construct the compiler command
-    stringstream cccmd;
-    cccmd << compiler;
-    for (vector<string>::const_iterator i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
-      cccmd << " " << *i;
+    // Look for a previously compiled library
+    string key;
+    if (cache_) {
+      // Read the source code
+      stringstream ss;
+      for (auto&& f : sources) {
+        ifstream src(f);
+        casadi_assert(src.good(), "Cannot open " + f);
+        ss << src.rdbuf() << "\n";
+      }
+      // Hash source code, commands and CasADi version (64-bit FNV-1a)
+      string content = ss.str() + "\n" + ccbase.str() + "\n" + ldbase.str()
+        + "\n" + CasadiMeta::version();
+      unsigned long long h = 14695981039346656037ULL;
+      for (unsigned char c : content) {
+        h ^= c;
+        h *= 1099511628211ULL;
+      }
+      stringstream hs;
+      hs << hex << setw(16) << setfill('0') << h;
+      key = hs.str();
+      // The temporary library is not used
+      if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
+      bin_name_ = folder_ + "/casadi_jit_" + key + SHARED_LIBRARY_SUFFIX;
+      cache_hit_ = ifstream(bin_name_).good();
+      if (cache_hit_) {
+        n_cache_hit_++;
+        for (auto&& obj : obj_names_) {
+          if (remove(obj.c_str())) casadi_warning("Failed to remove " + obj);
+        }
+        if (verbose_) casadi_message("Reusing cached " + bin_name_);
+      } else {
+        n_cache_miss_++;
+      }
     }
-    cccmd << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+    if (!cache_hit_) {
+      FStats t;
+      t.tic();
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+      // Compile the source files into objects, at most jobs_ at a time
+      int n_src = sources.size();
+      t_compile_file_.assign(n_src, 0);
+      atomic<int> next(0);
+      ThreadPool::instance().run(min(jobs_, n_src), [&](int) {
+        for (int i=next++; i<n_src; i=next++) {
+          t_compile_file_[i] = compile(sources[i], obj_names_[i]);
+        }
+      });
+      FStats t_link;
+      t_link.tic();
 
-    // Compile into an object
-    if (verbose_) uout() << "calling \"" << cccmd.str() + "\"" << std::endl;
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
-    }
+      // Link into a temporary file, moved into the cache afterwards
+      string ld_out = cache_ ? temporary_file(bin_name_ + ".", ".tmp") : bin_name_;
 
-    // Link step
-    stringstream ldcmd;
-    ldcmd << linker;
-    for (vector<string>::const_iterator i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
-      ldcmd << " " << *i;
-    }
-    ldcmd << " " << linker_setup;
+      // Link step
+      stringstream ldcmd;
+      ldcmd << ldbase.str();
+
+      // Temporary file
+      for (auto&& obj : obj_names_) ldcmd << " " << obj;
+      ldcmd << " " + linker_output_flag + ld_out;
 
-    // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+      // Compile into a shared library
+      if (verbose_) uout() << "calling \"" << ldcmd.str() << "\"" << std::endl;
+      if (system(ldcmd.str().c_str())) {
+        casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
+      }
 
-    // Compile into a shared library
-    if (verbose_) uout() << "calling \"" << ldcmd.str() << "\"" << std::endl;
-    if (system(ldcmd.str().c_str())) {
-      casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
+      // Add to cache, replacing whatever other process may have written meanwhile
+      if (cache_) {
+        remove(bin_name_.c_str());
+        if (rename(ld_out.c_str(), bin_name_.c_str())) {
+          casadi_error("Failed to move " + ld_out + " to " + bin_name_);
+        }
+      }
+
+      t_link.toc();
+      t_link_ = t_link.t_wall;
+      t.toc();
+      t_compile_ = t.t_wall;
     }
 
+    // Update recently used libraries
+    if (cache_) cache_update(key);
+
 #ifdef _WIN32
     handle_ = LoadLibrary(TEXT(bin_name_.c_str()));
     SetDllDirectory(NULL);
@@ -236,6 +356,18 @@ namespace casadi {
 #endif // _WIN32
   }
 
+  double ShellCompiler::compile(const std::string& src, const std::string& obj) const {
+    FStats t;
+    t.tic();
+    string cccmd = ccbase_ + " " + src + " " + compiler_output_flag_ + obj;
+    if (verbose_) uout() << "calling \"" << cccmd + "\"" << std::endl;
+    if (system(cccmd.c_str())) {
+      casadi_error("Compilation failed. Tried \"" + cccmd + "\"");
+    }
+    t.toc();
+    return t.t_wall;
+  }
+
   signal_t ShellCompiler::get_function(const std::string& symname) {
 #ifdef _WIN32
     return (signal_t)GetProcAddress(handle_, TEXT(symname.c_str()));
@@ -249,4 +381,47 @@ namespace casadi {
 #endif // _WIN32
   }
 
+  void ShellCompiler::cache_update(const std::string& key) {
+    // Index file, least recently used first
+    string index_name = folder_ + "/casadi_jit_cache.txt";
+    deque<string> index;
+    {
+      ifstream f(index_name);
+      string k;
+      while (f >> k) {
+        if (k!=key) index.push_back(k);
+      }
+    }
+    index.push_back(key);
+
+    // Evict the least recently used libraries
+    while (cache_size_>0 && index.size()>cache_size_) {
+      string evicted = folder_ + "/casadi_jit_" + index.front() + SHARED_LIBRARY_SUFFIX;
+      if (verbose_) casadi_message("Evicting " + evicted);
+      remove(evicted.c_str());
+      index.pop_front();
+    }
+
+    // Write updated index
+    ofstream f(index_name);
+    if (!f.good()) {
+      casadi_warning("Cannot write " + index_name);
+      return;
+    }
+    for (auto&& k : index) f << k << "\n";
+  }
+
+  Dict ShellCompiler::get_stats() const {
+    Dict stats;
+    stats["t_compile"] = t_compile_;
+    stats["t_compile_file"] = t_compile_file_;
+    stats["t_link"] = t_link_;
+    if (cache_) {
+      stats["cache_hit"] = cache_hit_;
+      stats["n_cache_hit"] = static_cast<int>(n_cache_hit_);
+      stats["n_cache_miss"] = static_cast<int>(n_cache_miss_);
+    }
+    return stats;
+  }
+
 } // namespace casadi
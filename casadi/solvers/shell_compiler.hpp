@@ -29,6 +29,9 @@
 #include "casadi/core/importer_internal.hpp"
 #include <casadi/solvers/casadi_importer_shell_export.h>
 #include "casadi/core/plugin_interface.hpp"
+#ifdef WITH_THREAD
+#include <atomic>
+#endif // WITH_THREAD
 
 /** \defgroup plugin_Importer_shell
       Interface to the JIT compiler SHELL
@@ -81,16 +84,65 @@ namespace casadi {
 
     /// Get a function pointer for numerical evaluation
     signal_t get_function(const std::string& symname) override;
+
+    /** \brief Get compilation statistics */
+    Dict get_stats() const override;
   protected:
+    /// Register a library in the cache, evicting the least recently used ones
+    void cache_update(const std::string& key);
+
     /// Temporary file
     std::string bin_name_;
 
-    /// Temporary file
-    std::string obj_name_;
+    /// Compile a source file into an object, returns the wall time spent
+    double compile(const std::string& src, const std::string& obj) const;
+
+    /// Temporary object files, one for each source file
+    std::vector<std::string> obj_names_;
+
+    /// Additional source files linked into the same library
+    std::vector<std::string> extra_sources_;
+
+    /// Maximum number of concurrent compilations
+    int jobs_;
+
+    /// Compiler command, without file names
+    std::string ccbase_;
+
+    /// Compiler flag to denote object output
+    std::string compiler_output_flag_;
 
     /// Cleanup temporary files when unloading
     bool cleanup_;
 
+    /// Reuse compiled libraries from the cache folder
+    bool cache_;
+
+    /// Folder for the cached libraries
+    std::string folder_;
+
+    /// Maximum number of cached libraries, zero if unlimited
+    int cache_size_;
+
+    /// Was the library found in the cache
+    bool cache_hit_;
+
+    /// Time spent compiling and linking
+    double t_compile_;
+
+    /// Time spent linking
+    double t_link_;
+
+    /// Time spent compiling each source file
+    std::vector<double> t_compile_file_;
+
+    /// Cache hits and misses for all instances
+#ifdef WITH_THREAD
+    static std::atomic<int> n_cache_hit_, n_cache_miss_;
+#else // WITH_THREAD
+    static int n_cache_hit_, n_cache_miss_;
+#endif // WITH_THREAD
+
     // Shared library handle
     typedef DL_HANDLE_TYPE handle_t;
     handle_t handle_;
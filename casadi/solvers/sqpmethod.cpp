@@ -97,6 +97,12 @@ namespace casadi {
       {"lbfgs_memory",
        {OT_INT,
         "Size of L-BFGS memory."}},
+      {"lbfgs_structure",
+       {OT_STRING,
+        "Structure of the L-BFGS Hessian approximation. 'block' [default] keeps "
+        "a separate approximation for each diagonal block of the Lagrangian Hessian "
+        "sparsity, 'sparse' projects one approximation onto the Hessian sparsity "
+        "and regularizes the result."}},
       {"regularize",
        {OT_BOOL,
         "Automatic regularization of Lagrange Hessian."}},
@@ -127,6 +133,7 @@ namespace casadi {
     tol_du_ = 1e-6;
     regularize_ = false;
     string hessian_approximation = "exact";
+    string lbfgs_structure = "block";
     min_step_size_ = 1e-10;
     string qpsol_plugin;
     Dict qpsol_options;
@@ -147,6 +154,8 @@ namespace casadi {
         merit_memsize_ = op.second;
       } else if (op.first=="lbfgs_memory") {
         lbfgs_memory_ = op.second;
+      } else if (op.first=="lbfgs_structure") {
+        lbfgs_structure = op.second.to_string();
       } else if (op.first=="tol_pr") {
         tol_pr_ = op.second;
       } else if (op.first=="tol_du") {
@@ -182,8 +191,50 @@ namespace casadi {
                                     {{"gamma", {"f", "g"}}});
     }
 
-    // Allocate a QP solver
-    Hsp_ = exact_hessian_ ? hess_l_fcn_.sparsity_out(0) : Sparsity::dense(nx_, nx_);
+    // Hessian sparsity
+    if (exact_hessian_) {
+      Hsp_ = hess_l_fcn_.sparsity_out(0);
+    } else {
+      casadi_assert(lbfgs_memory_>0, "'lbfgs_memory' must be positive");
+      casadi_assert(lbfgs_structure=="block" || lbfgs_structure=="sparse",
+                    "Unknown 'lbfgs_structure': " + lbfgs_structure);
+      lbfgs_sparse_ = lbfgs_structure=="sparse";
+
+      // Sparsity of the Lagrangian Hessian, without forming the Hessian
+      Function grad_l = oracle_.factory("nlp_grad_l", {"x", "p", "lam:f", "lam:g"},
+                                        {"grad:gamma:x"}, {{"gamma", {"f", "g"}}});
+      Sparsity sp = grad_l.sparsity_jac(0, 0);
+      sp = sp + sp.T() + Sparsity::diag(nx_);
+
+      if (lbfgs_sparse_) {
+        // One approximation for all variables
+        Hsp_ = sp;
+        lbfgs_index_ = range(nx_);
+        lbfgs_offset_ = {0, nx_};
+      } else {
+        // One approximation for each block of the block-diagonal Hessian
+        sp.scc(lbfgs_index_, lbfgs_offset_);
+        vector<int> row, col;
+        for (int b=0; b+1<lbfgs_offset_.size(); ++b) {
+          for (int k1=lbfgs_offset_[b]; k1<lbfgs_offset_[b+1]; ++k1) {
+            for (int k2=lbfgs_offset_[b]; k2<lbfgs_offset_[b+1]; ++k2) {
+              row.push_back(lbfgs_index_[k1]);
+              col.push_back(lbfgs_index_[k2]);
+            }
+          }
+        }
+        Hsp_ = Sparsity::triplet(nx_, nx_, row, col);
+      }
+
+      // Position of the variables in the blocks
+      lbfgs_loc_.resize(nx_);
+      lbfgs_max_block_ = 0;
+      for (int b=0; b+1<lbfgs_offset_.size(); ++b) {
+        int nb = lbfgs_offset_[b+1] - lbfgs_offset_[b];
+        for (int k=0; k<nb; ++k) lbfgs_loc_[lbfgs_index_[lbfgs_offset_[b]+k]] = k;
+        lbfgs_max_block_ = max(lbfgs_max_block_, nb);
+      }
+    }
     Asp_ = jac_g_fcn_.is_null() ? Sparsity(0, nx_) : jac_g_fcn_.sparsity_out(1);
 
     // Allocate a QP solver
@@ -192,40 +243,8 @@ namespace casadi {
                    qpsol_options);
     alloc(qpsol_);
 
-    // Create Hessian update function
+    // Initial Hessian approximation
     if (!exact_hessian_) {
-      // Create expressions corresponding to Bk, x, x_old, gLag and gLag_old
-      SX Bk = SX::sym("Bk", Hsp_);
-      SX x = SX::sym("x", sparsity_in_.at(NLPSOL_X0));
-      SX x_old = SX::sym("x", x.sparsity());
-      SX gLag = SX::sym("gLag", x.sparsity());
-      SX gLag_old = SX::sym("gLag_old", x.sparsity());
-
-      SX sk = x - x_old;
-      SX yk = gLag - gLag_old;
-      SX qk = mtimes(Bk, sk);
-
-      // Calculating theta
-      SX skBksk = dot(sk, qk);
-      SX omega = if_else(dot(yk, sk) < 0.2 * dot(sk, qk),
-                         0.8 * skBksk / (skBksk - dot(sk, yk)),
-                         1);
-      yk = omega * yk + (1 - omega) * qk;
-      SX theta = 1. / dot(sk, yk);
-      SX phi = 1. / dot(qk, sk);
-      SX Bk_new = Bk + theta * mtimes(yk, yk.T()) - phi * mtimes(qk, qk.T());
-
-      // Inputs of the BFGS update function
-      vector<SX> bfgs_in(BFGS_NUM_IN);
-      bfgs_in[BFGS_BK] = Bk;
-      bfgs_in[BFGS_X] = x;
-      bfgs_in[BFGS_X_OLD] = x_old;
-      bfgs_in[BFGS_GLAG] = gLag;
-      bfgs_in[BFGS_GLAG_OLD] = gLag_old;
-      bfgs_ = Function("bfgs", bfgs_in, {Bk_new});
-      alloc(bfgs_);
-
-      // Initial Hessian approximation
       B_init_ = project(DM::eye(nx_), Hsp_);
     }
 
@@ -281,6 +300,14 @@ namespace casadi {
 
     // Jacobian
     alloc_w(Asp_.nnz(), true); // Jk_
+
+    // Limited-memory BFGS
+    if (!exact_hessian_) {
+      alloc_w(nx_*lbfgs_memory_, true); // lbfgs_s
+      alloc_w(nx_*lbfgs_memory_, true); // lbfgs_y
+      alloc_w(lbfgs_max_block_*(2*lbfgs_memory_ + 3)
+              + 8*lbfgs_memory_*lbfgs_memory_ + 2*lbfgs_memory_, true); // lbfgs_w
+    }
   }
 
   void Sqpmethod::set_work(void* mem, const double**& arg, double**& res,
@@ -326,6 +353,15 @@ namespace casadi {
 
     // Jacobian
     m->Jk = w; w += Asp_.nnz();
+
+    // Limited-memory BFGS
+    if (!exact_hessian_) {
+      m->lbfgs_s = w; w += nx_*lbfgs_memory_;
+      m->lbfgs_y = w; w += nx_*lbfgs_memory_;
+      m->lbfgs_w = w;
+      w += lbfgs_max_block_*(2*lbfgs_memory_ + 3) + 8*lbfgs_memory_*lbfgs_memory_
+           + 2*lbfgs_memory_;
+    }
   }
 
   void Sqpmethod::solve(void* mem) const {
@@ -439,7 +475,8 @@ namespace casadi {
 
         try {
           // Evaluate
-          fcallback_(m->arg, m->res, m->iw, m->w, 0);
+          scoped_checkout<FunctionInternal> mem_fcallback(fcallback_.get());
+          fcallback_(m->arg, m->res, m->iw, m->w, mem_fcallback);
         } catch(KeyboardInterruptException& ex) {
           throw;
         } catch(exception& ex) {
@@ -628,32 +665,9 @@ namespace casadi {
 
       // Updating Lagrange Hessian
       if (!exact_hessian_) {
-        if (verbose_) print("Updating Hessian (BFGS)\n");
-        // BFGS with careful updates and restarts
-        if (iter % lbfgs_memory_ == 0) {
-          // Reset Hessian approximation by dropping all off-diagonal entries
-          const int* colind = Hsp_.colind();      // Access sparsity (column offset)
-          int ncol = Hsp_.size2();
-          const int* row = Hsp_.row();            // Access sparsity (row)
-          for (int cc=0; cc<ncol; ++cc) {     // Loop over the columns of the Hessian
-            for (int el=colind[cc]; el<colind[cc+1]; ++el) {
-              // Loop over the nonzero elements of the column
-              if (cc!=row[el]) m->Bk[el] = 0;               // Remove if off-diagonal entries
-            }
-          }
-        }
-
-        // Update the Hessian approximation
-        fill_n(m->arg, bfgs_.n_in(), nullptr);
-        m->arg[BFGS_BK] = m->Bk;
-        m->arg[BFGS_X] = m->xk;
-        m->arg[BFGS_X_OLD] = m->x_old;
-        m->arg[BFGS_GLAG] = m->gLag;
-        m->arg[BFGS_GLAG_OLD] = m->gLag_old;
-        fill_n(m->res, bfgs_.n_out(), nullptr);
-        m->res[0] = m->Bk;
-        bfgs_(m->arg, m->res, m->iw, m->w, 0);
-
+        if (verbose_) print("Updating Hessian (L-BFGS)\n");
+        lbfgs_update(m);
+        lbfgs_hessian(m);
       } else {
         // Exact Hessian
         if (verbose_) print("Evaluating hessian\n");
@@ -703,10 +717,197 @@ namespace casadi {
   void Sqpmethod::reset_h(SqpmethodMemory* m) const {
     // Initial Hessian approximation of BFGS
     if (!exact_hessian_) {
+      int nblocks = lbfgs_offset_.size()-1;
+      m->lbfgs_n.assign(nblocks, 0);
+      m->lbfgs_next.assign(nblocks, 0);
+      m->lbfgs_delta.assign(nblocks, 1.);
       copy_n(B_init_.ptr(), Hsp_.nnz(), m->Bk);
     }
   }
 
+  // Invert a small dense matrix with Gauss-Jordan elimination, A is overwritten
+  static bool lbfgs_inv(int n, double* A, double* Ainv) {
+    casadi_fill(Ainv, n*n, 0.);
+    for (int i=0; i<n; ++i) Ainv[i+i*n] = 1;
+    for (int c=0; c<n; ++c) {
+      // Partial pivoting
+      int p = c;
+      for (int r=c+1; r<n; ++r) if (fabs(A[r+c*n])>fabs(A[p+c*n])) p = r;
+      if (A[p+c*n]==0) return false;
+      if (p!=c) {
+        for (int k=0; k<n; ++k) {
+          swap(A[p+k*n], A[c+k*n]);
+          swap(Ainv[p+k*n], Ainv[c+k*n]);
+        }
+      }
+      // Normalize the pivot row
+      double piv = A[c+c*n];
+      for (int k=0; k<n; ++k) {
+        A[c+k*n] /= piv;
+        Ainv[c+k*n] /= piv;
+      }
+      // Eliminate the other rows
+      for (int r=0; r<n; ++r) {
+        double f = A[r+c*n];
+        if (r==c || f==0) continue;
+        for (int k=0; k<n; ++k) {
+          A[r+k*n] -= f*A[c+k*n];
+          Ainv[r+k*n] -= f*Ainv[c+k*n];
+        }
+      }
+    }
+    return true;
+  }
+
+  void Sqpmethod::lbfgs_compact(SqpmethodMemory* m, int b, double* V) const {
+    // The compact representation of Byrd, Nocedal and Schnabel (1994):
+    // B = delta*I - W*inv(K)*W', W = [delta*S, Y], K = [delta*S'*S, L; L', -D]
+    int mem = lbfgs_memory_;
+    int np = m->lbfgs_n[b];
+    if (np==0) return;
+    double delta = m->lbfgs_delta[b];
+    const int* ind = get_ptr(lbfgs_index_) + lbfgs_offset_[b];
+    int nb = lbfgs_offset_[b+1] - lbfgs_offset_[b];
+    int n2 = 2*np;
+    double* K = m->lbfgs_w + lbfgs_max_block_*2*mem;
+    double* Kinv = K + 4*mem*mem;
+
+    // Stored pairs, oldest first
+    int first = m->lbfgs_next[b] - np + mem;
+    auto s = [&](int k) { return m->lbfgs_s + ((first+k) % mem)*nx_;};
+    auto y = [&](int k) { return m->lbfgs_y + ((first+k) % mem)*nx_;};
+
+    // Assemble K
+    for (int i=0; i<np; ++i) {
+      for (int j=0; j<np; ++j) {
+        const double *si = s(i), *sj = s(j), *yj = y(j);
+        double ss = 0, sy = 0;
+        for (int v=0; v<nb; ++v) {
+          ss += si[ind[v]]*sj[ind[v]];
+          sy += si[ind[v]]*yj[ind[v]];
+        }
+        K[i + j*n2] = delta*ss;
+        K[i + (np+j)*n2] = K[np+j + i*n2] = i>j ? sy : 0;
+        K[np+i + (np+j)*n2] = i==j ? -sy : 0;
+      }
+    }
+
+    // Drop the pairs if K is singular
+    if (!lbfgs_inv(n2, K, Kinv)) {
+      m->lbfgs_n[b] = 0;
+      return;
+    }
+
+    // V = W*inv(K)
+    for (int v=0; v<nb; ++v) {
+      for (int c=0; c<n2; ++c) {
+        double r = 0;
+        for (int k=0; k<np; ++k) {
+          r += delta*s(k)[ind[v]]*Kinv[k + c*n2] + y(k)[ind[v]]*Kinv[np+k + c*n2];
+        }
+        V[v + c*nb] = r;
+      }
+    }
+  }
+
+  void Sqpmethod::lbfgs_update(SqpmethodMemory* m) const {
+    int mem = lbfgs_memory_;
+    double* V = m->lbfgs_w;
+    double* sb = V + lbfgs_max_block_*2*mem + 8*mem*mem;
+    double* yb = sb + lbfgs_max_block_;
+    double* Bs = yb + lbfgs_max_block_;
+    double* Wts = Bs + lbfgs_max_block_;
+    for (int b=0; b+1<lbfgs_offset_.size(); ++b) {
+      const int* ind = get_ptr(lbfgs_index_) + lbfgs_offset_[b];
+      int nb = lbfgs_offset_[b+1] - lbfgs_offset_[b];
+
+      // Step and change in Lagrangian gradient for the block
+      for (int v=0; v<nb; ++v) {
+        sb[v] = m->xk[ind[v]] - m->x_old[ind[v]];
+        yb[v] = m->gLag[ind[v]] - m->gLag_old[ind[v]];
+      }
+
+      // Bs = delta*s - V*W'*s
+      lbfgs_compact(m, b, V);
+      int np = m->lbfgs_n[b];
+      double delta = m->lbfgs_delta[b];
+      int first = m->lbfgs_next[b] - np + mem;
+      for (int k=0; k<np; ++k) {
+        const double* s = m->lbfgs_s + ((first+k) % mem)*nx_;
+        const double* y = m->lbfgs_y + ((first+k) % mem)*nx_;
+        Wts[k] = Wts[np+k] = 0;
+        for (int v=0; v<nb; ++v) {
+          Wts[k] += delta*s[ind[v]]*sb[v];
+          Wts[np+k] += y[ind[v]]*sb[v];
+        }
+      }
+      for (int v=0; v<nb; ++v) {
+        Bs[v] = delta*sb[v];
+        for (int c=0; c<2*np; ++c) Bs[v] -= V[v + c*nb]*Wts[c];
+      }
+      double sBs = casadi_dot(nb, sb, Bs);
+      double sy = casadi_dot(nb, sb, yb);
+
+      // No step in the block
+      if (sBs<=0) continue;
+
+      // Powell's damping, keeping the approximation positive definite
+      if (sy < 0.2*sBs) {
+        double theta = 0.8*sBs/(sBs - sy);
+        for (int v=0; v<nb; ++v) yb[v] = theta*yb[v] + (1-theta)*Bs[v];
+        sy = casadi_dot(nb, sb, yb);
+      }
+
+      // Replace the oldest pair
+      int k = m->lbfgs_next[b];
+      double* s = m->lbfgs_s + k*nx_;
+      double* y = m->lbfgs_y + k*nx_;
+      for (int v=0; v<nb; ++v) {
+        s[ind[v]] = sb[v];
+        y[ind[v]] = yb[v];
+      }
+      m->lbfgs_delta[b] = casadi_dot(nb, yb, yb)/sy;
+      m->lbfgs_next[b] = (k+1) % mem;
+      m->lbfgs_n[b] = min(np+1, mem);
+    }
+  }
+
+  void Sqpmethod::lbfgs_hessian(SqpmethodMemory* m) const {
+    int mem = lbfgs_memory_;
+    const int* colind = Hsp_.colind();
+    const int* row = Hsp_.row();
+    double* V = m->lbfgs_w;
+    for (int b=0; b+1<lbfgs_offset_.size(); ++b) {
+      int nb = lbfgs_offset_[b+1] - lbfgs_offset_[b];
+      lbfgs_compact(m, b, V);
+      int np = m->lbfgs_n[b];
+      double delta = m->lbfgs_delta[b];
+      int first = m->lbfgs_next[b] - np + mem;
+
+      // Entries of delta*I - V*W' in the sparsity pattern
+      for (int k=lbfgs_offset_[b]; k<lbfgs_offset_[b+1]; ++k) {
+        int c = lbfgs_index_[k];
+        for (int el=colind[c]; el<colind[c+1]; ++el) {
+          int r = row[el];
+          double v = r==c ? delta : 0;
+          const double* Vr = V + lbfgs_loc_[r];
+          for (int j=0; j<np; ++j) {
+            int slot = ((first+j) % mem)*nx_;
+            v -= Vr[j*nb]*delta*m->lbfgs_s[slot + c] + Vr[(np+j)*nb]*m->lbfgs_y[slot + c];
+          }
+          m->Bk[el] = v;
+        }
+      }
+    }
+
+    // The projection onto the sparsity pattern may be indefinite
+    m->reg = 0;
+    if (lbfgs_sparse_ || regularize_) {
+      m->reg = getRegularization(m->Bk);
+      if (m->reg > 0) regularize(m->Bk, m->reg);
+    }
+  }
+
   double Sqpmethod::getRegularization(const double* H) const {
     const int* colind = Hsp_.colind();
     int ncol = Hsp_.size2();
@@ -764,7 +965,8 @@ namespace casadi {
     m->res[CONIC_LAM_A] = lambda_A_opt;
 
     // Solve the QP
-    qpsol_(m->arg, m->res, m->iw, m->w, 0);
+    scoped_checkout<FunctionInternal> mem_qpsol(qpsol_.get());
+    qpsol_(m->arg, m->res, m->iw, m->w, mem_qpsol);
   }
 
   double Sqpmethod::
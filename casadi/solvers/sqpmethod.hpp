@@ -71,6 +71,16 @@ namespace casadi {
     /// Current Hessian approximation
     double *Bk;
 
+    /// Limited-memory BFGS pairs, stored as vectors of length nx
+    double *lbfgs_s, *lbfgs_y;
+
+    /// Work vector for forming the limited-memory BFGS approximation
+    double *lbfgs_w;
+
+    /// Number of stored pairs, next slot and scaling for each block
+    std::vector<int> lbfgs_n, lbfgs_next;
+    std::vector<double> lbfgs_delta;
+
     /// Hessian regularization
     double reg;
 
@@ -167,9 +177,17 @@ namespace casadi {
     // Print options
     bool print_header_, print_iteration_;
 
-    /// BFGS update function
-    enum BFGSMdoe { BFGS_BK, BFGS_X, BFGS_X_OLD, BFGS_GLAG, BFGS_GLAG_OLD, BFGS_NUM_IN};
-    Function bfgs_;
+    /// Project a global limited-memory BFGS approximation onto the Hessian sparsity
+    bool lbfgs_sparse_;
+
+    /// Blocks of variables with separate limited-memory BFGS approximations
+    std::vector<int> lbfgs_index_, lbfgs_offset_;
+
+    /// Position of each variable in its block
+    std::vector<int> lbfgs_loc_;
+
+    /// Largest block
+    int lbfgs_max_block_;
 
     // Hessian sparsity
     Sparsity Hsp_;
@@ -196,6 +214,15 @@ namespace casadi {
     // Reset the Hessian or Hessian approximation
     void reset_h(SqpmethodMemory* m) const;
 
+    // Add the latest step to the limited-memory BFGS pairs
+    void lbfgs_update(SqpmethodMemory* m) const;
+
+    // Form the Hessian approximation from the limited-memory BFGS pairs
+    void lbfgs_hessian(SqpmethodMemory* m) const;
+
+    // Compact representation B = delta*I - V*W' of the approximation for a block
+    void lbfgs_compact(SqpmethodMemory* m, int b, double* V) const;
+
     // Calculate the regularization parameter using Gershgorin theorem
     double getRegularization(const double* H) const;
 
@@ -0,0 +1,108 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of the graph coloring used for Jacobian compression
+ * Colors the columns of a large sparse Jacobian (a nine-point stencil on a
+ * square grid with a few random long-range couplings) with the sequential
+ * greedy algorithm in natural order, as before, with the smallest last,
+ * incidence degree and largest first orderings, and with the speculative
+ * parallel algorithm. Reports the number of colors and the time taken.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+
+using namespace casadi;
+using namespace std;
+
+// Check that the columns of each color are structurally orthogonal
+bool is_valid(const Sparsity& A, const Sparsity& D) {
+  vector<int> seen(A.size1(), -1);
+  const int *colind = A.colind(), *row = A.row();
+  for (int c=0; c<D.size2(); ++c) {
+    for (int k=D.colind()[c]; k<D.colind()[c+1]; ++k) {
+      int j = D.row()[k];
+      for (int el=colind[j]; el<colind[j+1]; ++el) {
+        if (seen[row[el]]==c) return false;
+        seen[row[el]] = c;
+      }
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  // Grid dimension
+  int m = argc>1 ? atoi(argv[1]) : 300;
+  int nthreads = argc>2 ? atoi(argv[2]) : 4;
+  int n = m*m;
+
+  // Nine-point stencil with random couplings
+  vector<int> row, col;
+  srand(1);
+  for (int i=0; i<m; ++i) {
+    for (int j=0; j<m; ++j) {
+      for (int di=-1; di<=1; ++di) {
+        for (int dj=-1; dj<=1; ++dj) {
+          if (i+di>=0 && i+di<m && j+dj>=0 && j+dj<m) {
+            row.push_back(i*m+j);
+            col.push_back((i+di)*m+j+dj);
+          }
+        }
+      }
+      if (rand()%10==0) {
+        row.push_back(i*m+j);
+        col.push_back(rand()%n);
+      }
+    }
+  }
+  Sparsity A = Sparsity::triplet(n, n, row, col);
+  Sparsity AT = A.T();
+  cout << "Jacobian: " << A.dim() << ", " << A.nnz() << " nonzeros" << endl;
+
+  // Coloring variants: ordering, number of threads
+  vector<pair<string, pair<int, int> > > variants = {
+    {"natural, sequential", {0, 1}},
+    {"largest first, sequential", {1, 1}},
+    {"smallest last, sequential", {2, 1}},
+    {"incidence degree, sequential", {3, 1}},
+    {"natural, " + str(nthreads) + " threads", {0, nthreads}},
+    {"smallest last, " + str(nthreads) + " threads", {2, nthreads}}};
+
+  bool valid = true;
+  for (auto&& v : variants) {
+    auto t0 = chrono::steady_clock::now();
+    Sparsity D = A.uni_coloring(AT, numeric_limits<int>::max(), v.second.first, v.second.second);
+    double t = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+    bool ok = is_valid(A, D);
+    valid = valid && ok;
+    cout << v.first << ": " << D.size2() << " colors, " << t << " s"
+         << (ok ? "" : " (INVALID)") << endl;
+  }
+
+  return valid ? 0 : 1;
+}
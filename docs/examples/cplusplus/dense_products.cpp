@@ -0,0 +1,133 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of the dense matrix product kernels
+ * Times the sparse kernels casadi_mtimes and casadi_mv, which dense products
+ * were evaluated with before, against the blocked dense kernels used by
+ * DenseMultiplication (or BLAS, if CasADi was built WITH_BLAS), as well as
+ * casadi_bilin with a dense matrix.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+
+using namespace casadi;
+using namespace std;
+
+// Time a callable, repeating it until at least 0.2 s has passed
+template<typename F>
+double timeit(F f) {
+  int n = 0;
+  auto t0 = chrono::steady_clock::now();
+  double t;
+  do {
+    f();
+    n++;
+    t = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+  } while (t<0.2);
+  return 1e6*t/n;
+}
+
+int main(int argc, char *argv[]) {
+  // Matrix dimension
+  int n = argc>1 ? atoi(argv[1]) : 200;
+  Sparsity sp = Sparsity::dense(n, n);
+
+  // Random data
+  DM A = DM::rand(n, n), B = DM::rand(n, n), v = DM::rand(n, 1);
+  vector<double> C(n*n), w(n), c(n);
+
+  // Matrix-matrix product, sparse kernel
+  double t_mm_old = timeit([&]() {
+    casadi_mtimes(get_ptr(A), sp, get_ptr(B), sp, get_ptr(C), sp, get_ptr(w), false);});
+
+  // Matrix-matrix product, blocked dense kernel
+  double t_mm_new = timeit([&]() {
+    casadi_mtimes_dense(get_ptr(A), n, n, get_ptr(B), n, get_ptr(C));});
+
+  // Matrix-matrix product through a function, as DenseMultiplication is evaluated
+  MX X = MX::sym("X", n, n), Y = MX::sym("Y", n, n);
+  Function f("f", {X, Y}, {mtimes(X, Y)});
+  FunctionBuffer buf = f.buffer();
+  buf.set_arg(0, A);
+  buf.set_arg(1, B);
+  double t_mm_fun = timeit([&]() { buf.eval();});
+
+  // Matrix-vector products
+  double t_mv_old = timeit([&]() {
+    casadi_mv(get_ptr(A), sp, get_ptr(v), get_ptr(c), false);});
+  double t_mv_new = timeit([&]() {
+    casadi_mv_dense(get_ptr(A), n, n, get_ptr(v), get_ptr(c), false);});
+  double t_mvt_old = timeit([&]() {
+    casadi_mv(get_ptr(A), sp, get_ptr(v), get_ptr(c), true);});
+  double t_mvt_new = timeit([&]() {
+    casadi_mv_dense(get_ptr(A), n, n, get_ptr(v), get_ptr(c), true);});
+
+  // Bilinear form, with the sparse code path (one structural zero) and the dense one
+  vector<int> row, col;
+  for (int j=0; j<n; ++j) {
+    for (int i=0; i<n; ++i) {
+      if (i!=j || i>0) {
+        row.push_back(i);
+        col.push_back(j);
+      }
+    }
+  }
+  Sparsity sp_nd = Sparsity::triplet(n, n, row, col);
+  DM A_nd = project(A, sp_nd);
+  double r, r_nd;
+  double t_bilin_old = timeit([&]() {
+    r_nd = casadi_bilin(get_ptr(A_nd), sp_nd, get_ptr(v), get_ptr(v));});
+  double t_bilin_new = timeit([&]() {
+    r = casadi_bilin(get_ptr(A), sp, get_ptr(v), get_ptr(v));});
+
+  // Correctness: compare with the sparse kernel
+  vector<double> C_ref(n*n), C_new(n*n);
+  casadi_mtimes(get_ptr(A), sp, get_ptr(B), sp, get_ptr(C_ref), sp, get_ptr(w), false);
+  casadi_mtimes_dense(get_ptr(A), n, n, get_ptr(B), n, get_ptr(C_new));
+  double err = 0;
+  for (int k=0; k<n*n; ++k) err = max(err, fabs(C_ref[k]-C_new[k]));
+  double err_fun = norm_inf(buf.res(0) - DM::reshape(DM(C_ref), n, n)).scalar();
+  double r_ref = dot(v, mtimes(A, v)).scalar();
+  double r_nd_ref = dot(v, mtimes(A_nd, v)).scalar();
+  err = max(max(err, err_fun), max(fabs(r-r_ref), fabs(r_nd-r_nd_ref)));
+
+  // Report
+  double gflop = 2e-3*n*n*n;
+  cout << "n = " << n << endl;
+  cout << "mtimes, sparse kernel:  " << t_mm_old << " us (" << gflop/t_mm_old << " GFLOP/s)" << endl;
+  cout << "mtimes, dense kernel:   " << t_mm_new << " us (" << gflop/t_mm_new << " GFLOP/s)" << endl;
+  cout << "mtimes, MX function:    " << t_mm_fun << " us (" << gflop/t_mm_fun << " GFLOP/s)" << endl;
+  cout << "mv, sparse kernel:      " << t_mv_old << " us" << endl;
+  cout << "mv, dense kernel:       " << t_mv_new << " us" << endl;
+  cout << "mv^T, sparse kernel:    " << t_mvt_old << " us" << endl;
+  cout << "mv^T, dense kernel:     " << t_mvt_new << " us" << endl;
+  cout << "bilin, sparse kernel:   " << t_bilin_old << " us" << endl;
+  cout << "bilin, dense kernel:    " << t_bilin_new << " us" << endl;
+  cout << "Difference:             " << err << endl;
+
+  return err<1e-8*n ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of the per-call overhead of numerical evaluation
+ * Compares calling a small function with DM arguments, which allocates work
+ * vectors and outputs in every call, with calling it through a FunctionBuffer,
+ * which allocates them once.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+
+using namespace casadi;
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  // Number of calls
+  int n = argc>1 ? atoi(argv[1]) : 100000;
+
+  // A small function, where the call overhead dominates
+  SX x = SX::sym("x", 3);
+  SX p = SX::sym("p");
+  Function f("f", {x, p}, {sin(x)*p, dot(x, x)});
+
+  // Input values
+  DM x_val = DM(vector<double>{0.1, 0.2, 0.3});
+  DM p_val = 2;
+
+  // Call with DM arguments
+  double r_ref = 0;
+  auto t0 = chrono::steady_clock::now();
+  for (int k=0; k<n; ++k) {
+    p_val = 1 + 1e-6*k;
+    vector<DM> res = f(vector<DM>{x_val, p_val});
+    r_ref += res[1].scalar();
+  }
+  auto t1 = chrono::steady_clock::now();
+
+  // Call through a buffer, binding the inputs once
+  FunctionBuffer buf = f.buffer();
+  double p_buf;
+  buf.set_arg(0, x_val);
+  buf.set_arg(1, &p_buf, 1);
+  double r = 0;
+  for (int k=0; k<n; ++k) {
+    p_buf = 1 + 1e-6*k;
+    buf.eval();
+    r += buf.res(1).scalar();
+  }
+  auto t2 = chrono::steady_clock::now();
+
+  // Compare
+  double err = fabs(r - r_ref);
+  double t_dm = chrono::duration<double>(t1-t0).count();
+  double t_buf = chrono::duration<double>(t2-t1).count();
+  cout << "DM call:     " << 1e9*t_dm/n << " ns per call" << endl;
+  cout << "Buffer call: " << 1e9*t_buf/n << " ns per call" << endl;
+  cout << "Speed-up:    " << t_dm/t_buf << endl;
+  cout << "Difference:  " << err << endl;
+
+  return err<1e-8 ? 0 : 1;
+}
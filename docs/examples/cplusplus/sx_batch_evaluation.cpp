@@ -0,0 +1,97 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Benchmark of batched numerical evaluation of an SX function
+ * Compares evaluating an SX function one point at a time with evaluating
+ * the same points in batches, where every instruction of the virtual machine
+ * is dispatched once per batch rather than once per point.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+
+using namespace casadi;
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  // Number of evaluation points
+  int n = argc>1 ? atoi(argv[1]) : 100000;
+
+  // A moderately large expression graph
+  SX x = SX::sym("x", 10);
+  SX p = SX::sym("p", 2);
+  SX e = x;
+  for (int k=0; k<20; ++k) {
+    e = sin(e)*p(0) + cos(e*e)/(1+exp(-p(1)*e));
+  }
+  Function f("f", {x, p}, {e, dot(e, e)});
+  cout << "Number of instructions: " << f.n_instructions() << endl;
+
+  // Inputs and outputs for all points, stored consecutively
+  vector<double> x_val(n*f.nnz_in(0)), p_val(n*f.nnz_in(1));
+  for (int i=0; i<x_val.size(); ++i) x_val[i] = sin(0.1*i);
+  for (int i=0; i<p_val.size(); ++i) p_val[i] = 1 + 0.001*i;
+  vector<double> r0_ref(n*f.nnz_out(0)), r1_ref(n*f.nnz_out(1));
+  vector<double> r0(n*f.nnz_out(0)), r1(n*f.nnz_out(1));
+
+  // Work vectors
+  vector<const double*> arg(f.sz_arg());
+  vector<double*> res(f.sz_res());
+  vector<int> iw(f.sz_iw());
+  vector<double> w(f.sz_w_batch(n));
+
+  // Evaluate one point at a time
+  auto t0 = chrono::steady_clock::now();
+  for (int k=0; k<n; ++k) {
+    arg[0] = get_ptr(x_val) + k*f.nnz_in(0);
+    arg[1] = get_ptr(p_val) + k*f.nnz_in(1);
+    res[0] = get_ptr(r0_ref) + k*f.nnz_out(0);
+    res[1] = get_ptr(r1_ref) + k*f.nnz_out(1);
+    f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w));
+  }
+  auto t1 = chrono::steady_clock::now();
+
+  // Evaluate all points in batches
+  arg[0] = get_ptr(x_val);
+  arg[1] = get_ptr(p_val);
+  res[0] = get_ptr(r0);
+  res[1] = get_ptr(r1);
+  f.eval_batch(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), n);
+  auto t2 = chrono::steady_clock::now();
+
+  // Compare
+  double err = 0;
+  for (int i=0; i<r0.size(); ++i) err = max(err, fabs(r0[i]-r0_ref[i]));
+  for (int i=0; i<r1.size(); ++i) err = max(err, fabs(r1[i]-r1_ref[i]));
+  double t_point = chrono::duration<double>(t1-t0).count();
+  double t_batch = chrono::duration<double>(t2-t1).count();
+  cout << "Per point: " << t_point << " s" << endl;
+  cout << "Batched:   " << t_batch << " s" << endl;
+  cout << "Speed-up:  " << t_point/t_batch << endl;
+  cout << "Max difference: " << err << endl;
+
+  return err<1e-12 ? 0 : 1;
+}
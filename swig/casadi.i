@@ -3042,6 +3042,14 @@ DECL void casadi_substitute_inplace(const std::vector< M >& v,
   return substitute_inplace(v, INOUT1, INOUT2, reverse);
 }
 
+DECL M casadi_cse(const M& e) {
+  return cse(e);
+}
+
+DECL std::vector< M > casadi_cse(const std::vector< M >& e) {
+  return cse(e);
+}
+
 DECL void casadi_shared(const std::vector< M >& ex,
                                std::vector< M >& OUTPUT1,
                                std::vector< M >& OUTPUT2,
@@ -3713,6 +3721,9 @@ def PyFunction(name, obj, inputs, outputs, opts={}):
 %}
 #endif
 
+#ifdef SWIGPYTHON
+%rename(_eval) casadi::FunctionBuffer::eval;
+#endif // SWIGPYTHON
 %include <casadi/core/function.hpp>
 #ifdef SWIGPYTHON
 namespace casadi{
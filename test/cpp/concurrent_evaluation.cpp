@@ -0,0 +1,120 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+/** \brief Stress test for concurrent evaluation of a single Function instance
+ * A number of threads evaluate the same integrator (which has a memory object),
+ * the same SX function (through the low-level interface) and the same MX function
+ * embedding a rootfinder simultaneously, without any synchronization in user code,
+ * while creating and releasing sparsity patterns. All results are compared with
+ * results obtained by serial evaluation.
+ */
+
+#include "casadi/casadi.hpp"
+#include <thread>
+#include <atomic>
+
+using namespace casadi;
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  int n_thread = argc>1 ? atoi(argv[1]) : 8;
+  int n_eval = argc>2 ? atoi(argv[2]) : 200;
+
+  // An integrator, which has a memory object per evaluation
+  SX x = SX::sym("x", 2), p = SX::sym("p");
+  SX ode = vertcat(x(1), -p*x(0) - 0.1*x(1));
+  Function F = integrator("F", "rk", SXDict{{"x", x}, {"p", p}, {"ode", ode}},
+                          Dict{{"tf", 1.0}, {"number_of_finite_elements", 20}});
+
+  // An SX function, evaluated through the low-level interface
+  Function f("f", {x, p}, {sin(x)*p + dot(x, x)});
+
+  // An MX function calling a rootfinder, which has nested memory objects
+  MX z = MX::sym("z"), q = MX::sym("q");
+  Function rf = rootfinder("rf", "newton", Function("rf", {z, q}, {z*z*z + z - q}));
+  Function g("g", {q}, {rf(vector<MX>{0, q}).at(0)});
+
+  // Reference solutions, computed serially
+  vector<DM> xf_ref(n_eval), f_ref(n_eval), g_ref(n_eval);
+  for (int k=0; k<n_eval; ++k) {
+    DM x0 = DM(vector<double>{1.0 + 0.01*k, -0.5}), p0 = 0.5 + 0.001*k;
+    xf_ref[k] = F(DMDict{{"x0", x0}, {"p", p0}}).at("xf");
+    f_ref[k] = f(vector<DM>{x0, p0}).at(0);
+    g_ref[k] = g(vector<DM>{p0}).at(0);
+  }
+
+  // Evaluate concurrently
+  atomic<int> n_fail(0);
+  vector<thread> threads;
+  for (int t=0; t<n_thread; ++t) {
+    threads.emplace_back([&, t]() {
+      // Work vectors for the low-level interface
+      vector<const double*> arg(f.sz_arg());
+      vector<double*> res(f.sz_res());
+      vector<int> iw(f.sz_iw());
+      vector<double> w(f.sz_w()), r(f.nnz_out(0));
+      for (int i=0; i<n_eval; ++i) {
+        int k = (i + t) % n_eval;
+        DM x0 = DM(vector<double>{1.0 + 0.01*k, -0.5}), p0 = 0.5 + 0.001*k;
+        // Memory object is checked out internally
+        DM xf = F(DMDict{{"x0", x0}, {"p", p0}}).at("xf");
+        if (double(norm_inf(xf - xf_ref[k])) > 1e-12) n_fail++;
+        // Memory object checked out explicitly
+        int mem = f.checkout();
+        arg[0] = x0.ptr();
+        arg[1] = p0.ptr();
+        res[0] = get_ptr(r);
+        f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), mem);
+        f.release(mem);
+        if (double(norm_inf(DM(r) - f_ref[k])) > 1e-12) n_fail++;
+        // Nested memory objects are checked out by the parent
+        DM gk = g(vector<DM>{p0}).at(0);
+        if (double(norm_inf(gk - g_ref[k])) > 1e-12) n_fail++;
+      }
+    });
+  }
+  for (auto&& t : threads) t.join();
+
+  // Create and release sparsity patterns concurrently, exercising the pattern cache
+  threads.clear();
+  for (int t=0; t<n_thread; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i=0; i<50*n_eval; ++i) {
+        int n = 2 + (7*i + t) % 97;
+        // Patterns constructed independently share the cached pattern
+        Sparsity a = Sparsity::lower(n), b = Sparsity::lower(n);
+        if (a.get()!=b.get() || a.nnz()!=n*(n+1)/2) n_fail++;
+        Sparsity c = Sparsity::band(n, 1) + Sparsity::band(n, -1);
+        if (c.nnz()!=2*(n-1)) n_fail++;
+      }
+    });
+  }
+  for (auto&& t : threads) t.join();
+
+  cout << n_thread << " threads, " << n_eval << " evaluations each, "
+       << n_fail << " mismatches" << endl;
+  return n_fail==0 ? 0 : 1;
+}
@@ -755,5 +755,23 @@ class ADtests(casadiTestCase):
             H_ = Hf_out[0]
           self.checkarray(Hf_out[0],H_,failmessage=("mode: %s" % mode))
 
+  def test_numeric_ad(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y",2)
+    e = [vertcat(sin(x[0])*y[1]+x[2]**2,exp(x[1]/y[0]),atan2(x[0],y[1])), sqrt(x[0]**2+1)*y[0]**3+5]
+    f = Function("f",[x,y],e)
+    fn = Function("f",[x,y],e,{"numeric_ad":True})
+    x0 = DM([0.3,-0.7,1.1])
+    y0 = DM([1.3,0.4])
+    out = f(x0,y0)
+    for n in [1,3]:
+      fwd = [x0,y0]+list(out)+[DM.rand(3,n),DM.rand(2,n)]
+      for a,b in zip(f.forward(n).call(fwd),fn.forward(n).call(fwd)):
+        self.checkarray(a,b,digits=12)
+      adj = [x0,y0]+list(out)+[DM.rand(3,n),DM.rand(1,n)]
+      for a,b in zip(f.reverse(n).call(adj),fn.reverse(n).call(adj)):
+        self.checkarray(a,b,digits=12)
+    self.checkarray(fn.jacobian_old(0,0)(x0,y0)[0],f.jacobian_old(0,0)(x0,y0)[0],digits=12)
+
 if __name__ == '__main__':
     unittest.main()
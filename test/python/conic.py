@@ -1050,5 +1050,67 @@ class ConicTests(casadiTestCase):
     self.checkarray(sol_ref["lam_a"], sol["lam_a"],digits=8)
     self.checkarray(sol_ref["lam_x"], sol["lam_x"],digits=8)
 
+  def test_ipqp(self):
+    H = DM([[1,-1],[-1,2]])
+    G = DM([-2,-6])
+    A = DM([[1, 1],[-1, 2],[2, 1]])
+    LBA = DM([-inf]*3)
+    UBA = DM([2, 2, 3])
+    LBX = DM([0]*2)
+    UBX = DM([inf]*2)
+
+    solver = conic("solver","ipqp",{'h':H.sparsity(),'a':A.sparsity()},{"tol":1e-12})
+    solver_in = dict(h=H,g=G,a=A,lbx=LBX,ubx=UBX,lba=LBA,uba=UBA)
+    solver_out = solver(**solver_in)
+    self.assertTrue(solver.stats()["success"])
+    self.checkarray(solver_out["x"],DM([2.0/3,4.0/3]),digits=8)
+    self.checkarray(solver_out["cost"],DM(-8-2.0/9),digits=8)
+    self.checkarray(solver_out["lam_a"],DM([3+1.0/9,4.0/9,0]),digits=8)
+    self.checkarray(solver_out["lam_x"],DM([0,0]),digits=8)
+    self.check_codegen(solver,inputs=solver_in)
+
+    # Equality constraint and fixed variable
+    solver_in["lba"] = DM([-inf,-inf,3])
+    solver_in["lbx"] = DM([0,0.5])
+    solver_in["ubx"] = DM([inf,0.5])
+    solver_out = solver(**solver_in)
+    self.checkarray(solver_out["x"],DM([1.25,0.5]),digits=8)
+    self.checkarray(solver_out["lam_x"],DM([0,5.625]),digits=8)
+    self.checkarray(solver_out["lam_a"],DM([0,0,0.625]),digits=8)
+
+    # Warm start from the solution of a perturbed problem
+    solver_in["lba"] = DM([-inf,-inf,-inf])
+    solver_in["lbx"] = LBX
+    solver_in["ubx"] = UBX
+    ref = solver(**solver_in)
+    iter_cold = solver.stats()["iter_count"]
+    solver_in["uba"] = DM([2.1, 2, 3])
+    ref = solver(**solver_in)
+    solver = conic("solver","ipqp",{'h':H.sparsity(),'a':A.sparsity()},{"tol":1e-12,"warm_start":True})
+    solver_in["uba"] = UBA
+    solver_out = solver(x0=ref["x"],lam_x0=ref["lam_x"],lam_a0=ref["lam_a"],**solver_in)
+    self.checkarray(solver_out["x"],DM([2.0/3,4.0/3]),digits=8)
+    self.assertTrue(solver.stats()["iter_count"]<iter_cold)
+
+    # Sparse problem, natural and amd ordering
+    N = 30
+    x = SX.sym("x",N)
+    f = sumsqr(x[1:]-x[:-1]) + sumsqr(x-1)
+    g = x[1:]+x[:-1]
+    qp = {'x':x, 'f':f, 'g':g}
+    H = hessian(f,x)[0]
+    A = jacobian(g,x)
+    Hf = Function("H",[x],[H,A,gradient(f,x)])
+    [H,A,G] = Hf(0)
+    for ordering in ["natural","amd"]:
+      solver = conic("solver","ipqp",{'h':H.sparsity(),'a':A.sparsity()},{"ordering":ordering})
+      solver_out = solver(h=H,g=G,a=A,lba=-1,uba=1.5,lbx=-inf,ubx=0.8)
+      self.assertTrue(solver.stats()["success"])
+      if ordering=="natural":
+        sol = solver_out
+      else:
+        self.checkarray(solver_out["x"],sol["x"],digits=7)
+        self.checkarray(solver_out["lam_a"],sol["lam_a"],digits=7)
+
 if __name__ == '__main__':
     unittest.main()
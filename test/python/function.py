@@ -25,6 +25,9 @@ from casadi import *
 import casadi as c
 import numpy
 import unittest
+import os
+import shutil
+import tempfile
 from types import *
 from helpers import *
 
@@ -476,7 +479,7 @@ class Functiontests(casadiTestCase):
     Z = [MX.sym("z",2,2) for i in range(n)]
     V = [MX.sym("z",Sparsity.upper(3)) for i in range(n)]
 
-    for parallelization in ["serial","openmp","unroll","inline"] if args.run_slow else ["serial"]:
+    for parallelization in ["serial","openmp","thread","unroll","inline"] if args.run_slow else ["serial"]:
         print(parallelization)
         res = fun.map(n, parallelization).call([horzcat(*x) for x in [X,Y,Z,V]])
 
@@ -500,6 +503,135 @@ class Functiontests(casadiTestCase):
 
           self.checkfunction(f,Fref,inputs=X_+Y_+Z_+V_,sparsity_mod=args.run_slow)
 
+  def test_map_batch(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    y = Sparsity.lower(2)
+
+    for batch_size in [1, 3, 8]:
+      f = Function("f",[x,p],[sin(x)*p+x[0]**2,if_else(p>0,x[1],p), DM(y,1)*p],{"batch_size":batch_size})
+
+      for n in [1, 7, 20]:
+        F = f.map(n)
+        X = DM.rand(2,n)
+        P = DM.rand(1,n)-0.5
+        res = F(X,P)
+        for k in range(n):
+          ref = f(X[:,k],P[:,k])
+          for i in range(f.n_out()):
+            self.checkarray(res[i][:,k*f.size2_out(i):(k+1)*f.size2_out(i)],ref[i])
+
+  def test_map_thread(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    f = Function("f",[x,p],[sin(x)*p+x[0]**2,if_else(p>0,x[1],p)])
+
+    for n in [1, 2, 7, 100]:
+      X = DM.rand(2,n)
+      P = DM.rand(1,n)-0.5
+      ref = f.map(n)(X,P)
+      for max_num_threads in [1, 2, 3, 16]:
+        F = f.map(n, "thread", max_num_threads)
+        res = F(X,P)
+        for i in range(f.n_out()):
+          self.checkarray(res[i],ref[i])
+
+    with self.assertRaises(Exception):
+      f.map(20, "thread", 0)
+
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("ipqp")
+  def test_map_thread_nested(self):
+    # Nested solvers must not share memory objects between threads
+    x = MX.sym("x",2)
+    p = MX.sym("p")
+    solver = nlpsol("solver","sqpmethod",{"x":x,"p":p,"f":(x[0]-p)**2+(x[1]-2*p)**2+x[0]**4},
+                    {"qpsol":"ipqp","print_time":False,"print_iteration":False})
+    z = MX.sym("z")
+    rf = rootfinder("rf","newton",Function("rf",[z,p],[z**3+z-p]))
+    intg = integrator("intg","rk",{"x":z,"p":p,"ode":-p*z},{"tf":1.})
+    g = Function("g",[p],[solver(x0=0,p=p)["x"],rf(0,p),intg(x0=1,p=p)["xf"]])
+
+    P = DM(list(range(16))).T*0.1
+    ref = g.map(16)(P)
+    for max_num_threads in [2, 4]:
+      res = g.map(16, "thread", max_num_threads)(P)
+      for i in range(g.n_out()):
+        self.checkarray(res[i],ref[i])
+
+  def test_buffer(self):
+    x = SX.sym("x",3)
+    p = SX.sym("p")
+    f = Function("f",[x,p],[sin(x)*p,dot(x,x)])
+
+    buf = f.buffer()
+    for k in range(3):
+      x0 = DM([0.1,0.2,0.3])*(k+1)
+      buf.set_arg(0, x0)
+      buf.set_arg(1, 2+k)
+      self.assertEqual(buf._eval(), 0)
+      ref = f(x0, 2+k)
+      res = buf.ret()
+      for i in range(f.n_out()):
+        self.checkarray(res[i],ref[i])
+
+    # Inputs are copied, temporaries need not outlive the call to set_arg
+    buf.set_arg(0, DM([1,2,3])*2)
+    DM.rand(3,3)
+    buf2 = FunctionBuffer(buf)
+    for b in [buf, buf2]:
+      b._eval()
+      self.checkarray(b.ret()[1],DM(56))
+
+    with self.assertRaises(Exception):
+      buf.set_arg(0, DM.ones(2))
+
+  def test_serialize(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    f = Function("f",[x,p],[sin(x)*p+x[0]**2,if_else(p>0,x[1],p)],["x","p"],["r","s"])
+
+    X = MX.sym("x",2)
+    P = MX.sym("p")
+    [r, s] = f(X, P)
+    g = Function("g",[X,P],[mtimes(r.T,vertsplit(X)[0]*X)+norm_fro(mtimes(X,X.T)+1), dot(X,X), X[0], norm_2(s*X)])
+
+    z = SX.sym("z")
+    rf = rootfinder("rf","newton",Function("rf",[z,p],[z**3+z-p]))
+    intg = integrator("intg","rk",{"x":x,"p":p,"ode":-p*x},{"tf":2.})
+
+    for F in [f, g, f.map(4), f.map(3, "thread", 2), rf, intg]:
+      F.save("serialized.casadi")
+      F2 = Function.load("serialized.casadi")
+      self.assertEqual(F2.name(), F.name())
+      self.assertEqual(F2.name_in(), F.name_in())
+      self.assertEqual(F2.name_out(), F.name_out())
+      args = [DM.rand(F.sparsity_in(i)) for i in range(F.n_in())]
+      res = F(*args)
+      res2 = F2(*args)
+      for i in range(F.n_out()):
+        self.checkarray(res[i],res2[i])
+
+    with self.assertRaises(Exception):
+      F2 = Function.load("nonexistent.casadi")
+
+    # Corrupted data gives a CasADi error rather than a standard library one
+    f.save("serialized.casadi")
+    with open("serialized.casadi","rb") as fh:
+      data = bytearray(fh.read())
+    for k in range(len(data)):
+      corrupted = bytearray(data)
+      corrupted[k] = 0xff
+      with open("serialized.casadi","wb") as fh:
+        fh.write(corrupted)
+      try:
+        Function.load("serialized.casadi")
+      except Exception as e:
+        for m in ["bad_alloc", "length_error", "max_size", "_M_range_check"]:
+          self.assertFalse(m in str(e))
+
+    os.remove("serialized.casadi")
+
   @memory_heavy()
   def test_mapsum(self):
     x = SX.sym("x")
@@ -519,7 +651,7 @@ class Functiontests(casadiTestCase):
     zi = 0
     for Z_alt in [Z,[MX()]*3]:
       zi+= 1
-      for parallelization in ["serial","openmp","unroll"]:
+      for parallelization in ["serial","openmp","thread","unroll"]:
         res = fun.mapsum([horzcat(*x) for x in [X,Y,Z_alt,V]],parallelization) # Joris - clean alternative for this?
 
         for ad_weight_sp in [0,1]:
@@ -564,7 +696,7 @@ class Functiontests(casadiTestCase):
 
     for Z_alt in [Z]:
 
-      for parallelization in ["serial","openmp","unroll"]:
+      for parallelization in ["serial","openmp","thread","unroll"]:
 
         for ad_weight_sp in [0,1]:
           for ad_weight in [0,1]:
@@ -806,6 +938,99 @@ class Functiontests(casadiTestCase):
   #   [v] = f([])
   #   self.checkarray(2.37683, v, digits=4)
 
+  def test_codegen_chunks(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y")
+    f = Function("f",[x,y],[sin(x)*y+x[0]**2, dot(x,x)*y+cos(x[2]*y)])
+    X = DM([1.1,2.2,3.3])
+    ref = f(X,0.7)
+
+    for chunk_files in [False, True]:
+      name = "f_chunks%d" % chunk_files
+      cg = CodeGenerator(name, {"chunk_size":3, "chunk_files":chunk_files})
+      cg.add(f)
+      cg.generate()
+      files = cg.source_files()
+      self.assertEqual(len(files)>1, chunk_files)
+      if args.run_slow:
+        import subprocess
+        subprocess.Popen("gcc -fPIC -shared -Wall -Werror -O3 %s -o %s.so" % (" ".join(files), name), shell=True).wait()
+        F = external("f", "./" + name + ".so")
+        res = F(X,0.7)
+        for i in range(f.n_out()):
+          self.checkarray(res[i],ref[i])
+      for e in files: os.remove(e)
+
+  def test_codegen_checkout(self):
+    x = SX.sym("x",3)
+    f = Function("f",[x],[sin(x)*dot(x,x)])
+    X = DM.rand(3,8)
+    cg = CodeGenerator("f_checkout")
+    cg.add(f)
+    cg.generate()
+    if args.run_slow:
+      import subprocess
+      import ctypes
+      subprocess.Popen("gcc -fPIC -shared -Wall -Werror -O3 -DCASADI_MAX_NUM_THREADS=2 f_checkout.c -o f_checkout.so", shell=True).wait()
+      F = external("f", "./f_checkout.so")
+      self.checkarray(F.map(8, "thread", 4)(X),f.map(8)(X))
+      # Memory objects of the library
+      lib = ctypes.CDLL(os.path.abspath("f_checkout.so"))
+      mem = [lib.f_checkout() for i in range(2)]
+      self.assertEqual(sorted(mem),[0,1])
+      self.assertEqual(lib.f_checkout(),-1)
+      # Evaluation does not depend on them
+      self.checkarray(F(X[:,0]),f(X[:,0]))
+      lib.f_release(mem[0])
+      self.assertEqual(lib.f_checkout(),mem[0])
+      for m in mem: lib.f_release(m)
+    os.remove("f_checkout.c")
+
+  @requiresPlugin(Importer,"shell")
+  def test_shell_cache(self):
+    folder = tempfile.mkdtemp()
+    x = SX.sym("x")
+    opts = {"jit":True, "compiler":"shell",
+            "jit_options":{"cache":True, "cache_size":1, "folder":folder}}
+
+    F = Function("f",[x],[x**2],opts)
+    self.checkarray(F(5),25)
+    self.assertFalse(F.stats()["jit"]["cache_hit"])
+    F = Function("f",[x],[x**2],opts)
+    self.checkarray(F(5),25)
+    self.assertTrue(F.stats()["jit"]["cache_hit"])
+
+    # Least recently used library is evicted
+    G = Function("g",[x],[x**3],opts)
+    self.checkarray(G(2),8)
+    self.assertFalse(G.stats()["jit"]["cache_hit"])
+    self.assertEqual(len([f for f in os.listdir(folder) if f.startswith("casadi_jit_") and not f.endswith(".txt")]),1)
+    del F, G
+    shutil.rmtree(folder)
+
+  @requiresPlugin(Importer,"shell")
+  def test_shell_jobs(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y")
+    f = Function("f",[x,y],[sin(x)*y+x[0]**2, dot(x,x)*y+cos(x[2]*y)])
+    F = Function("f",[x,y],[sin(x)*y+x[0]**2, dot(x,x)*y+cos(x[2]*y)],
+                 {"jit":True, "compiler":"shell", "jit_chunk_size":3,
+                  "jit_options":{"jobs":2}})
+    self.checkfunction(F,f,inputs=[DM([1.1,2.2,3.3]),0.7])
+    stats = F.stats()["jit"]
+    self.assertTrue(len(stats["t_compile_file"])>1)
+    self.assertTrue(stats["t_link"]<=stats["t_compile"])
+
+  @requiresPlugin(Importer,"clang")
+  def test_jit_chunk_size_clang(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y")
+    f = Function("f",[x,y],[sin(x)*y+x[0]**2, dot(x,x)*y+cos(x[2]*y)])
+    # Chunks end up in a single file
+    F = Function("f",[x,y],[sin(x)*y+x[0]**2, dot(x,x)*y+cos(x[2]*y)],
+                 {"jit":True, "jit_chunk_size":3})
+    self.checkfunction(F,f,inputs=[DM([1.1,2.2,3.3]),0.7])
+
   def test_depends_on(self):
     x = SX.sym("x")
     y = x**2
@@ -959,6 +1184,21 @@ class Functiontests(casadiTestCase):
 
       F = interpolant('F', 'linear', [np.linspace(0,1,7)], list(range(7)), {"lookup_mode": ["exact"]})
 
+  def test_interpolant_lookup_mode(self):
+    np.random.seed(0)
+    grid = [sorted(np.random.random(50)), sorted(np.random.random(9))]
+    values = np.random.random(50*9)
+    xs = [[x, y] for x in [-0.5, 0, 0.3, 0.31, 0.9, 0.2, 1.5] for y in [0.1, 0.95, -1]]
+    for plugin in ["linear", "bspline"]:
+      F = interpolant('F', plugin, grid, values)
+      for mode in ["binary", "hint"]:
+        G = interpolant('G', plugin, grid, values, {"lookup_mode": [mode, mode]})
+        for x in xs:
+          self.checkarray(G(x), F(x))
+        self.check_codegen(G, [vertcat(0.3, 0.4)])
+    with self.assertInException("Allowed values"):
+      interpolant('G', 'linear', grid, values, {"lookup_mode": ["foo", "linear"]})
+
   def test_2d_interpolant_uniform(self):
     grid = [[0, 1, 2], [0, 1, 2]]
     values = [0, 1, 2, 10, 11, 12, 20, 21, 22]
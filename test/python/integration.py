@@ -56,6 +56,8 @@ integrators.append(("collocation",["dae","ode"],{"rootfinder":"kinsol","number_o
 
 integrators.append(("rk",["ode"],{"number_of_finite_elements": 1000}))
 
+integrators.append(("dopri",["ode"],{"abstol": 1e-12,"reltol":1e-12}))
+
 print("Will test these integrators:")
 for cl, t, options in integrators:
   print(cl, " : ", t)
@@ -1012,5 +1014,134 @@ class Integrationtests(casadiTestCase):
       r = [0] + collocation_points(k,"legendre")
       self.assertEqual(len(r),k+1)
 
+  def test_max_checkpoints(self):
+    x=SX.sym("x",2)
+    rx=SX.sym("rx",2)
+    p=SX.sym("p")
+    dae = {'x': x, 'p': p, 'ode': vertcat(x[1],-p*sin(x[0])), 'quad': x[0]**2,
+           'rx': rx, 'rode': vertcat(rx[0]*x[1],-rx[1]*x[0]), 'rquad': dot(rx,x)}
+    for plugin in ["rk", "collocation"]:
+      opts = {"tf": 3, "number_of_finite_elements": 50}
+      ref = integrator("integrator", plugin, dae, opts)(x0=[1,0],p=0.7,rx0=[1,2])
+      for c in [1, 3, 10]:
+        self.message("%s, %d checkpoints" % (plugin, c))
+        opts["max_checkpoints"] = c
+        I = integrator("integrator", plugin, dae, opts)
+        # Nothing stored before the first evaluation
+        self.assertEqual(I.stats()["ncheckpoints"], 0)
+        out = I(x0=[1,0],p=0.7,rx0=[1,2])
+        for k in ["xf", "qf", "rxf", "rqf"]:
+          self.checkarray(out[k],ref[k],digits=12)
+        stats = I.stats()
+        # The schedule uses all available checkpoints
+        self.assertEqual(stats["ncheckpoints"], c)
+        self.assertTrue(stats["nrecompute"]>=50)
+
+  def test_staggered(self):
+    x=SX.sym("x",2)
+    z=SX.sym("z")
+    p=SX.sym("p",2)
+    dae = {'x': x, 'z': z, 'p': p, 'ode': vertcat(x[1]*z,-p[0]*sin(x[0])), 'alg': z-1-p[1]*x[0]**2,
+           'quad': x[0]**2+z}
+    for plugin in ["rk", "collocation"]:
+      d = dict(dae)
+      if plugin=="rk":
+        d = {'x': x, 'p': p, 'ode': substitute(dae['ode'],z,1), 'quad': x[0]**2}
+      opts = {"tf": 2, "number_of_finite_elements": 30}
+      ref = integrator("integrator", plugin, d, opts)
+      opts["forward_sensitivities"] = "staggered"
+      I = integrator("integrator", plugin, d, opts)
+      arg = [DM([1,0.2]),DM([0.7,0.3])]+[DM.zeros(ref.sparsity_in(i)) for i in range(2,6)]
+      seed = [DM.zeros(ref.size1_in(i),4) for i in range(6)]
+      seed[0] = DM.eye(4)[:2,:]
+      seed[1] = DM.eye(4)[2:,:]
+      fwd_ref = ref.forward(4).call(arg+ref.call(arg)+seed)
+      fwd = I.forward(4).call(arg+I.call(arg)+seed)
+      for i in range(3):
+        self.checkarray(fwd[i],fwd_ref[i],digits=8)
+      self.assertEqual(I.forward(3).class_name(),"FixedStepForward")
+
+      # Concurrent evaluations, each with memory objects of its own
+      fwd_arg = arg+I.call(arg)+seed
+      res = I.forward(4).map(6, "thread", 3).call([repmat(a,1,6) for a in fwd_arg])
+      for i in range(3):
+        self.checkarray(res[i],repmat(fwd[i],1,6),digits=12)
+
+  def test_batch(self):
+    x=SX.sym("x",2)
+    z=SX.sym("z")
+    p=SX.sym("p")
+    dae = {'x': x, 'z': z, 'p': p, 'ode': vertcat(x[1]+z,-p*x[0]), 'alg': z-sin(x[0])-z**3/10,
+           'quad': x[0]**2}
+    N = 7
+    x0 = DM.rand(2,N)
+    p0 = DM.rand(1,N)
+    for plugin in ["rk", "collocation"]:
+      d = dict(dae)
+      if plugin=="rk":
+        d = {'x': x, 'p': p, 'ode': vertcat(x[1],-p*x[0]), 'quad': x[0]**2}
+      for nth in [1, 3]:
+        opts = {"grid": [0, 0.4, 1], "number_of_finite_elements": 20, "batch_num_threads": nth}
+        I = integrator("integrator", plugin, d, opts)
+        out = I.map(N)(x0=x0,p=p0)
+        self.assertEqual(out["xf"].shape,(2,2*N))
+        for i in range(N):
+          ref = I(x0=x0[:,i],p=p0[i])
+          for r in ["xf","zf","qf"]:
+            self.checkarray(out[r][:,2*i:2*i+2],ref[r],digits=12)
+
+  def test_dopri(self):
+    x=SX.sym("x",2)
+    rx=SX.sym("rx",2)
+    p=SX.sym("p")
+    t=SX.sym("t")
+    dae = {'x': x, 'p': p, 't': t, 'ode': vertcat(x[1],-p*x[0]), 'quad': x[0]**2,
+           'rx': rx, 'rode': vertcat(-p*rx[1],rx[0]), 'rquad': rx[1]}
+    grid = [0, 0.3, 1, 2.5, 4]
+    I = integrator("integrator", "dopri", dae, {"grid": grid, "output_t0": True,
+                                                  "abstol": 1e-12, "reltol": 1e-12})
+    out = I(x0=[1,0],p=4)
+    tt = DM(grid).T
+    self.checkarray(out["xf"],vertcat(cos(2*tt),-2*sin(2*tt)),digits=9)
+    self.checkarray(out["qf"],tt/2+sin(4*tt)/8,digits=9)
+    I = integrator("integrator", "dopri", dae, {"tf": 4, "abstol": 1e-12, "reltol": 1e-12})
+    out = I(x0=[1,0],p=4,rx0=[1,0])
+    self.checkarray(out["rxf"],DM([cos(8),sin(8)/2]),digits=9)
+    self.checkarray(out["rqf"],DM((1-cos(8))/4),digits=9)
+    stats = I.stats()
+    self.assertTrue(stats["nsteps"]>0 and stats["nstepsB"]>0)
+
+    # Fewer right-hand side evaluations than RK4 for the same accuracy
+    ref = integrator("integrator", "rk", dae, {"tf": 4, "number_of_finite_elements": 50})(x0=[1,0],p=4)
+    err_rk = norm_inf(ref["xf"]-DM([cos(8),-2*sin(8)]))
+    I = integrator("integrator", "dopri", dae, {"tf": 4, "abstol": 1e-6, "reltol": 1e-6})
+    out = I(x0=[1,0],p=4)
+    self.assertTrue(norm_inf(out["xf"]-DM([cos(8),-2*sin(8)]))<err_rk)
+    self.assertTrue(I.stats()["nfevals"]<=4*50)
+
+    # Backward problem depending on the forward solution, at moderate tolerances
+    y=SX.sym("y",2)
+    ry=SX.sym("ry")
+    dae2 = {'x': y, 'ode': vertcat(cos(20*y[1]),1), 'rx': ry, 'rode': 20*y[0]}
+    for tol, digits in [(1e-4, 1), (1e-6, 3), (1e-8, 5)]:
+      I = integrator("integrator", "dopri", dae2, {"tf": 3, "abstol": tol, "reltol": tol})
+      out = I(x0=[0.5,0],rx0=0.3)
+      self.checkarray(out["rxf"],0.3+60*0.5+(1-cos(60))/20,failmessage=str(tol),digits=digits)
+      self.assertTrue(I.stats()["nrejectedB"]>0)
+
+    # Sensitivities
+    x0 = MX.sym("x0",2)
+    pm = MX.sym("p")
+    for plugin, opts in [("dopri", {"abstol": 1e-12, "reltol": 1e-12}),
+                         ("rk", {"number_of_finite_elements": 1000})]:
+      opts["tf"] = 4
+      res = integrator("integrator", plugin, dae, opts)(x0=x0,p=pm)
+      xf = res["xf"]
+      J = Function("J",[x0,pm],[jacobian(xf,vertcat(x0,pm)),gradient(res["qf"],vertcat(x0,pm))])
+      if plugin=="dopri":
+        sens = J([1,0],4)
+      else:
+        for i in range(2): self.checkarray(J([1,0],4)[i],sens[i],digits=7)
+
 if __name__ == '__main__':
     unittest.main()
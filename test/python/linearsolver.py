@@ -441,6 +441,35 @@ class LinearSolverTests(casadiTestCase):
 
         self.checkarray(mtimes(A_,f_out),b,digits=digits)
 
+  def test_ldl_ordering(self):
+    numpy.random.seed(1)
+    n = 30
+    A = self.randDM(n,n,sparsity=0.1)
+    A = A.T+A+10*DM.eye(n)
+    b = self.randDM(n,3)
+    ref = np.linalg.solve(A,b)
+
+    As = MX.sym("A",A.sparsity())
+    bs = MX.sym("B",b.sparsity())
+    nnz_l = {}
+    for ordering in ["natural","amd"]:
+      for supernodal in [False,True]:
+        options = {"ordering": ordering, "supernodal": supernodal}
+        L = Linsol("L","ldl",A.sparsity(),options)
+        self.checkarray(L.solve(A,b),ref)
+        stats = L.stats()
+        self.assertEqual(stats["ordering"],ordering)
+        self.assertEqual("n_supernodes" in stats,supernodal)
+        nnz_l[ordering] = stats["nnz_l"]
+
+        f = Function("f", [As,bs],[solve(As,bs,"ldl",options)])
+        self.checkarray(f(A,b),ref)
+        self.check_codegen(f,inputs=[A,b])
+    self.assertTrue(nnz_l["amd"]<=nnz_l["natural"])
+
+    with self.assertRaises(Exception):
+      Linsol("L","ldl",A.sparsity(),{"ordering":"foo"})
+
   def test_dimmismatch(self):
     A = DM.eye(5)
     b = DM.ones((4,1))
@@ -2582,8 +2582,52 @@ class MXtests(casadiTestCase):
     F = Function('F',[X],[det(X)])
     self.checkfunction(f,F,inputs=[x0])
 
-    
-    
+  def test_cse(self):
+    x = MX.sym("x",2)
+    y = MX.sym("y")
+    g = Function("g",[x],[sin(x),x[0]])
+
+    e1 = mtimes(x.T,x)*y + g(x)[0]
+    e2 = mtimes(x.T,x)*y + g(x)[0]
+    e = vertcat(e1, e2, g(x)[1])
+
+    self.assertTrue(n_nodes(cse(e))<n_nodes(e))
+
+    f = Function("f",[x,y],[e])
+    fc = Function("f",[x,y],[e],{"cse":True})
+    self.assertTrue(fc.n_nodes()<f.n_nodes())
+    self.checkfunction(fc,f,inputs=[DM([0.3,0.2]),0.7])
+
+  def test_mtimes_dense(self):
+    numpy.random.seed(1)
+    for (n,m,k) in [(1,1,1),(9,13,10),(4,8,1),(70,300,5)]:
+      A = MX.sym("A",n,m)
+      B = MX.sym("B",m,k)
+      x = MX.sym("x",n)
+      A_ = DM(numpy.random.random((n,m)))
+      B_ = DM(numpy.random.random((m,k)))
+      x_ = DM(numpy.random.random((n,1)))
+      f = Function("f",[A,B,x],[mtimes(A,B),mtimes(A,B[:,0]),bilin(A,x,B[:,0])])
+      r = f(A_,B_,x_)
+      self.checkarray(r[0],mtimes(A_,B_),digits=10)
+      self.checkarray(r[1],mtimes(A_,B_[:,0]),digits=10)
+      self.checkarray(r[2],mtimes(x_.T,mtimes(A_,B_[:,0])),digits=10)
+      self.check_codegen(f,inputs=[A_,B_,x_])
+
+  def test_fuse_nodes(self):
+    x = MX.sym("x",4,3)
+    p = MX.sym("p")
+    y = x
+    for k in range(5):
+      a = reshape(sin(y)*p + y[:,:],3,4)
+      b = vertcat(a[:,0],a[:,1],a[:,2],a[:,3])
+      c = b[[11,3,2,1,0,5,7,6,8,9,10,4]]
+      y = reshape(c,4,3)/(1+p**2) + x[1,2]**2 + horzcat(y[:,0],cos(y[:,1]),y[:,2])
+    e = [y, mtimes(y.T,x)+diagcat(p,y[0,0])[0,0]]
+
+    f = Function("f",[x,p],e,{"fuse_nodes":False})
+    ff = Function("f",[x,p],e)
+    self.checkfunction(ff,f,inputs=[DM(numpy.random.random((4,3))),0.3])
 
 if __name__ == '__main__':
     unittest.main()
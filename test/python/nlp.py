@@ -1325,6 +1325,51 @@ class NLPtests(casadiTestCase):
       self.checkarray(solver_out["x"],DM([0]),digits=7)
       if "bonmin" not in str(Solver): self.checkarray(solver_out["lam_x"],DM([0]),digits=7)
 
+  def test_eval_cache(self):
+    x=SX.sym("x",2)
+    nlp={'x':x, 'f':(1-x[0])**2+100*(x[1]-x[0]**2)**2, 'g':x[0]+x[1]}
+
+    for Solver, solver_options in solvers:
+      self.message(Solver)
+      sol = {}
+      for opts in [{}, {"eval_cache": True}, {"eval_cache": True, "fuse_functions": True}]:
+        opts = dict(opts, **solver_options)
+        solver = nlpsol("mysolver", Solver, nlp, opts)
+        solver_out = solver(x0=[-1.2,1],lbg=0,ubg=1)
+        stats = solver.stats()
+        n_hit = sum(v for k, v in stats.items() if k.startswith("n_hit_"))
+        n_call = {k[7:]: v for k, v in stats.items() if k.startswith("n_call_") and v>0}
+        if "eval_cache" not in opts:
+          # The cache is opt-in
+          self.assertEqual(n_hit, 0)
+          sol = solver_out
+          ref_call = n_call
+        else:
+          # Whether the plain cache hits depends on the call order of the solver,
+          # fused functions always serve their members from the cache
+          if "fuse_functions" in opts: self.assertTrue(n_hit>0)
+          # Evaluations remain attributed to the functions that were called
+          for k in ref_call:
+            self.assertTrue(n_call.get(k,0)+stats.get("n_hit_"+k,0)>0)
+          self.assertFalse(any(k.startswith("fused_") for k in n_call))
+          self.checkarray(solver_out["x"],sol["x"],digits=10)
+          self.checkarray(solver_out["f"],sol["f"],digits=10)
+
+  def test_lbfgs_structure(self):
+    x=SX.sym("x",6)
+    f=0
+    for i in range(0,6,2): f+=(1-x[i])**2+100*(x[i+1]-x[i]**2)**2
+    nlp={'x':x, 'f':f}
+
+    for Solver, solver_options in solvers:
+      if Solver!="sqpmethod" or "limited-memory" not in str(solver_options): continue
+      for structure in ["block", "sparse"]:
+        self.message(structure)
+        opts = dict(solver_options, lbfgs_structure=structure, max_iter=200)
+        solver = nlpsol("mysolver", Solver, nlp, opts)
+        solver_out = solver(x0=[0]*6,lbx=-10,ubx=10)
+        self.checkarray(solver_out["x"],DM.ones(6),digits=5)
+
 if __name__ == '__main__':
     unittest.main()
     print(solvers)
@@ -114,6 +114,31 @@ class OptiStacktests(inherit_from):
       
  
 
+    def test_values(self):
+      opti = Opti()
+      x = opti.variable(3)
+      p = opti.parameter()
+
+      opti.minimize(sumsqr(x-p))
+      opti.subject_to(x[0]>=1)
+
+      opti.solver(nlpsolver,nlpsolver_options)
+      opti.set_value(p, 0.5)
+      sol = opti.solve()
+
+      e = [x, sin(x[1])*p, opti.lam_g, 3*p]
+      v = sol.values(e)
+      self.assertEqual(len(v),4)
+      for i in range(4):
+        self.checkarray(v[i],sol.value(e[i]),digits=7)
+      self.checkarray(sol.values(e,[x==2])[1],sin(2)*0.5,digits=7)
+
+      # Cached helper sees new parameter values
+      opti.set_value(p, 1)
+      sol = opti.solve()
+      self.checkarray(sol.value(e[3]),3,digits=7)
+      self.checkarray(sol.values(e)[0],DM([1,1,1]),digits=5)
+
     def test_sparse(self):
       opti = Opti()
       x = opti.variable(3,1)
@@ -159,6 +159,34 @@ class Sparsitytests(casadiTestCase):
     b = Sparsity.triplet(4,5,[i[0] for i in nza],[i[1] for i in nza])
     self.checkarray(self.tomatrix(a),self.tomatrix(b),"rowcol")
 
+  def test_jacsparsity_batch(self):
+    numpy.random.seed(0)
+    x = SX.sym("x",300)
+    A = self.randDM(200,300,0.02)
+    e = vertcat(mtimes(A,x)*x[0], sin(x[:100])*x[100:200])
+
+    GlobalOptions.setHierarchicalSparsity(False)
+    try:
+      for X in [SX, MX]:
+        xs = X.sym("x",300)
+        ref = None
+        for ad_weight_sp in [0, 1]:
+          for batch in [1, 3, 8]:
+            for threads in [1, 2, 0]:
+              opts = {"ad_weight_sp": ad_weight_sp, "sparsity_batch_size": batch,
+                      "sparsity_max_num_threads": threads}
+              if X is SX:
+                f = Function("f",[x],[e],opts)
+              else:
+                g = Function("g",[x],[e])
+                f = Function("f",[xs],[g(xs)],opts)
+              sp = f.sparsity_jac(0, 0)
+              if ref is None: ref = sp
+              self.assertTrue(sp==ref)
+        self.assertTrue(ref==jacobian(e,x).sparsity())
+    finally:
+      GlobalOptions.setHierarchicalSparsity(True)
+
   def test_rowcol(self):
     self.message("rowcol constructor")
 
@@ -518,5 +546,26 @@ class Sparsitytests(casadiTestCase):
 
     self.checkarray(IM(c_,1),IM(c.kron(a,b).sparsity(),1))
 
+  def test_uni_coloring(self):
+    numpy.random.seed(0)
+    A = sparsify(DM(numpy.random.rand(40,60)>0.9)).sparsity()
+    for ordering in range(4):
+      for nthreads in [1,3]:
+        D = A.uni_coloring(A.T, 1000, ordering, nthreads)
+        self.assertEqual(D.size1(),A.size2())
+        # Columns of the same color are structurally orthogonal
+        for c in range(D.size2()):
+          cols = D.row()[D.colind()[c]:D.colind()[c+1]]
+          self.assertTrue(all(v<=1 for v in sum2(IM(A,1)[:,cols]).nonzeros()))
+    for p in [A.largest_first(), A.smallest_last(), A.incidence_degree()]:
+      self.assertEqual(sorted(p),list(range(A.size2())))
+
+    x = MX.sym("x",60)
+    y = mtimes(DM.ones(A),x**2)
+    for ordering in ["natural","largest_first","smallest_last","incidence_degree"]:
+      f = Function("f",[x],[y],{"coloring_ordering":ordering,"coloring_num_threads":2})
+      J = f.jacobian_old(0,0)
+      self.checkarray(J(DM(range(60)))[0],mtimes(DM.ones(A),diag(2*DM(range(60)))))
+
 if __name__ == '__main__':
     unittest.main()
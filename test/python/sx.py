@@ -1336,5 +1336,24 @@ class SXtests(casadiTestCase):
       self.checkarray(E(5),2)
       self.checkarray(E(7),1)
 
+  def test_cse(self):
+      x = SX.sym("x")
+      y = SX.sym("y")
+
+      a = sin(x)*y
+      b = sin(x)*y
+      e = vertcat(a+cos(b), b+cos(a), y*sin(x))
+
+      self.assertEqual(n_nodes(cse(e)), 6)
+      self.assertTrue(n_nodes(cse(e))<n_nodes(e))
+
+      f = Function("f",[x,y],[e])
+      fc = Function("f",[x,y],[e],{"cse":True})
+      self.assertTrue(fc.n_nodes()<f.n_nodes())
+      self.checkfunction(fc,f,inputs=[0.3,0.7])
+
+      [c1,c2] = cse([a,b])
+      self.assertTrue(is_equal(c1,c2))
+
 if __name__ == '__main__':
     unittest.main()